@@ -0,0 +1,43 @@
+#ifndef ALIGNEDVECTOR_H
+#define ALIGNEDVECTOR_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * Minimal allocator handing out memory aligned to `Alignment` bytes
+ * (by default a cache line, which is also wide enough for AVX-512 loads).
+ * Used for the column arrays of `SolarSystem` and friends so that the
+ * math kernels can walk them with aligned vector loads.
+ */
+template <class T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+    using value_type = T;
+
+    template <class U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() noexcept = default;
+    template <class U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* pointer, std::size_t) noexcept {
+        ::operator delete(pointer, std::align_val_t(Alignment));
+    }
+
+    template <class U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const noexcept { return true; }
+    template <class U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const noexcept { return false; }
+};
+
+template <class T>
+using AlignedVector = std::vector<T, AlignedAllocator<T>>;
+
+#endif // ALIGNEDVECTOR_H
@@ -0,0 +1,109 @@
+#include "alignmentcache.h"
+#include "orbitalmath.h"
+#include "solarsystem.h"
+
+#include <QtConcurrent>
+
+#include <cmath>
+#include <cstring>
+#include <numeric>
+
+qsizetype AlignmentCache::pairIndex(qsizetype first, qsizetype second) {
+    // Row `higher` of the triangle starts after rows 0..higher-1,
+    // which hold 0 + 1 + ... + (higher - 1) pairs
+    const qsizetype lower = std::min(first, second);
+    const qsizetype higher = std::max(first, second);
+    return higher * (higher - 1) / 2 + lower;
+}
+
+bool AlignmentCache::update(const SolarSystem& solarSystem) {
+    const qsizetype planetCount = solarSystem.size();
+    const qsizetype pairCount = planetCount * (planetCount - 1) / 2;
+
+    if (pairCount > MAXIMUM_PAIRS) {
+        *this = AlignmentCache();
+        return false;
+    }
+
+    // Take a new snapshot of the planets
+    AlignedVector<double> newAngularVelocities(planetCount, NAN);
+    AlignedVector<double> newInitialAngularPositions(planetCount, NAN);
+    for (qsizetype i = 0; i < planetCount; ++i) {
+        if (!solarSystem.hasOrbitalData(i)) continue;
+
+        const Planet planet = solarSystem.at(i);
+        newAngularVelocities[i] = OrbitalMath::angularVelocity(planet);
+        newInitialAngularPositions[i] = OrbitalMath::meanAngularPositionAfterDays(planet, Days(0));
+    }
+
+    // Find which planets changed; if the planets themselves changed, that's everyone
+    const bool rebuildAll = planetCount != this->planetCount();
+    std::vector<bool> changed(planetCount, rebuildAll);
+    if (!rebuildAll) {
+        // Compare bitwise, so that NaN (no orbital data) compares equal to NaN
+        for (qsizetype i = 0; i < planetCount; ++i) {
+            changed[i] = std::memcmp(&newAngularVelocities[i], &angularVelocities[i], sizeof(double))
+                         || std::memcmp(&newInitialAngularPositions[i], &initialAngularPositions[i], sizeof(double));
+        }
+    }
+    else {
+        synodicPeriods.assign(pairCount, NAN);
+        phaseOffsets.assign(pairCount, NAN);
+    }
+
+    angularVelocities = std::move(newAngularVelocities);
+    initialAngularPositions = std::move(newInitialAngularPositions);
+
+    // Recompute the affected pairs, one row of the triangle per task
+    std::vector<qsizetype> rows(planetCount);
+    std::iota(rows.begin(), rows.end(), 0);
+
+    QtConcurrent::blockingMap(rows, [this, &solarSystem, &changed](qsizetype row) {
+        for (qsizetype column = 0; column < row; ++column) {
+            if (!changed[row] && !changed[column]) continue;
+
+            const qsizetype pair = pairIndex(row, column);
+            if (std::isnan(angularVelocities[row]) || std::isnan(angularVelocities[column])) {
+                synodicPeriods[pair] = NAN;
+                phaseOffsets[pair] = NAN;
+                continue;
+            }
+
+            synodicPeriods[pair] = 360.0 / std::abs(angularVelocities[row] - angularVelocities[column]);
+            phaseOffsets[pair] = OrbitalMath::daysUntilAligned(
+                solarSystem.at(row), initialAngularPositions[row],
+                solarSystem.at(column), initialAngularPositions[column]
+                ).value();
+        }
+    });
+
+    return true;
+}
+
+qsizetype AlignmentCache::planetCount() const {
+    return angularVelocities.size();
+}
+
+Days AlignmentCache::synodicPeriod(qsizetype first, qsizetype second) const {
+    if (first == second) return Days(INFINITY);
+    return Days(synodicPeriods[pairIndex(first, second)]);
+}
+
+Days AlignmentCache::phaseOffset(qsizetype first, qsizetype second) const {
+    if (first == second) return Days(0);
+    return Days(phaseOffsets[pairIndex(first, second)]);
+}
+
+Days AlignmentCache::nextAlignmentAfter(qsizetype first, qsizetype second, Days day) const {
+    if (first == second) return day;
+
+    const qsizetype pair = pairIndex(first, second);
+    const double period = synodicPeriods[pair];
+    const double phase = phaseOffsets[pair];
+
+    // Planets moving at the same angular velocity are either always or never aligned
+    if (std::isinf(period)) return 0 == phase ? day : Days(INFINITY);
+
+    // Alignments happen at phase + k * period, for any integer k
+    return Days(phase + std::ceil((day.value() - phase) / period) * period);
+}
@@ -0,0 +1,70 @@
+#ifndef ALIGNMENTCACHE_H
+#define ALIGNMENTCACHE_H
+
+#include "alignedvector.h"
+#include "quantity.h"
+
+#include <QtGlobal>
+
+class SolarSystem;
+
+/**
+ * Cache of the synodic period (time between two consecutive alignments)
+ * and phase offset (time of the first alignment at or after time 0) of
+ * every pair of planets in a solar system, so that the next time any
+ * two planets align after a given moment can be found in O(1).
+ *
+ * Pairs are stored in a triangular matrix indexed by the planets'
+ * indices in the solar system; pairs involving planets lacking orbital
+ * data hold NaN. All times are in days.
+ */
+class AlignmentCache
+{
+public:
+    /**
+     * Largest number of pairs we are willing to cache (16 bytes each).
+     * Solar systems with more planets than that are not cached at all.
+     */
+    static constexpr qsizetype MAXIMUM_PAIRS = qsizetype(1) << 26;
+
+    AlignmentCache() = default;
+
+    /**
+     * Brings the cache up to date with `solarSystem`, recomputing (in
+     * parallel) only the pairs involving planets whose orbital data changed
+     * since the last update, or all pairs if the number of planets changed.
+     *
+     * Returns false (leaving the cache empty) if the solar system has too
+     * many pairs to cache, see `MAXIMUM_PAIRS`.
+     */
+    bool update(const SolarSystem& solarSystem);
+
+    /**
+     * Number of planets covered by the cache.
+     */
+    qsizetype planetCount() const;
+
+    Days synodicPeriod(qsizetype first, qsizetype second) const;
+    Days phaseOffset(qsizetype first, qsizetype second) const;
+
+    /**
+     * Computes the first moment at or after `day` at which the two planets
+     * are aligned. Infinite if they never align again, NaN if either planet
+     * lacks orbital data.
+     */
+    Days nextAlignmentAfter(qsizetype first, qsizetype second, Days day) const;
+
+private:
+    // Per-planet snapshot of what the pairs were computed from, used to
+    // detect which planets changed. NaN for planets lacking orbital data.
+    AlignedVector<double> angularVelocities;
+    AlignedVector<double> initialAngularPositions;
+
+    // Per-pair values, in a triangular matrix (see pairIndex)
+    AlignedVector<double> synodicPeriods;
+    AlignedVector<double> phaseOffsets;
+
+    static qsizetype pairIndex(qsizetype first, qsizetype second);
+};
+
+#endif // ALIGNMENTCACHE_H
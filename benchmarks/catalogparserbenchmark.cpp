@@ -0,0 +1,316 @@
+/**
+ * Checks `CatalogParser` against the regular expressions it replaced, and
+ * measures its throughput.
+ *
+ * The reference parsers below are the per-field `QRegularExpression` code
+ * that `PlanetsWidget` used before `CatalogParser`, kept as it was. Both are
+ * run on well-formed lines and on lines stitched together at random from
+ * fragments of fields; they must accept the same lines, capture the same
+ * values and report the same errors. Throughput is then measured on
+ * million-line planet and orbital data files, for both.
+ */
+
+#include "catalogparser.h"
+
+#include <QElapsedTimer>
+#include <QRegularExpression>
+#include <QString>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using CatalogParser::PlanetData;
+using CatalogParser::PlanetOrbitalData;
+
+namespace {
+    constexpr int FUZZED_LINE_COUNT = 700000;
+    constexpr int BENCHMARK_LINE_COUNT = 1000000;
+    constexpr int REFERENCE_BENCHMARK_LINE_COUNT = 100000; // The regular expressions are much slower
+    constexpr int REPETITIONS = 5;
+
+    bool referenceParsePlanetLine(const QString& line, PlanetData& planetData, QList<QString>& errors) {
+        const auto errorsAtStart = errors.length();
+
+        // Planet name
+        static QRegularExpression nameRegex("^([a-zA-Z _0-9]+):");
+        QRegularExpressionMatch nameMatch = nameRegex.match(line);
+        if (!nameMatch.hasMatch()) {
+            errors.append(QString("No planet name specified in line '%1'; use format '<Planet name>: [...]'").arg(line));
+        }
+        else planetData.name = nameRegex.match(line).captured(1);
+
+        // Planet radius and unit
+        static QRegularExpression diameterRegex("diameter = ([0-9]+(?:.[0-9]+)?) ([a-z]+)");
+        QRegularExpressionMatch diameterMatch = diameterRegex.match(line);
+        if (!diameterMatch.hasMatch()) {
+            errors.append(QString("No diameter specified in line '%1'; use format 'diameter = <value> <m|km>'").arg(line));
+        }
+        else {
+            bool okConversion;
+            planetData.diameter = diameterMatch.captured(1).toDouble(&okConversion);
+            if (!okConversion) errors.append(QString("Invalid diameter value '%1'").arg(diameterMatch.captured(1)));
+
+            planetData.diameterUnit = DistanceUnit::parse(diameterMatch.captured(2));
+            if (DistanceUnit::INVALID == planetData.diameterUnit) {
+                errors.append(QString("Invalid distance unit '%1' in line '%2'; expected 'km' or 'm'")
+                                  .arg(diameterMatch.captured(2), line));
+            }
+        }
+
+        // Planet mass and unit
+        static QRegularExpression massRegex("mass = ([0-9]+(?:.[0-9]+)?)(?: \\* 10\\^([0-9]+))? ([a-zA-Z]+)");
+        QRegularExpressionMatch massMatch = massRegex.match(line);
+        if (!massMatch.hasMatch()) {
+            errors.append(QString("No mass specified in line '%1'; use format 'mass = <value> <kg|t|Earths>'").arg(line));
+        }
+        else {
+            bool okConversion;
+            if(!massMatch.captured(2).isEmpty()) {
+                planetData.mass = (massMatch.captured(1) + "e" + massMatch.captured(2)).toDouble(&okConversion);
+                if (!okConversion) {
+                    errors.append(QString("Invalid mass value '%1 * 10 ^ %2' in line '%3'")
+                                      .arg(massMatch.captured(1), massMatch.captured(2), line));
+                }
+            }
+            else {
+                planetData.mass = massMatch.captured(1).toDouble(&okConversion);
+                if (!okConversion) errors.append(QString("Invalid mass value '%1' in line '%2'")
+                                      .arg(massMatch.captured(1), line));
+            }
+
+            planetData.massUnit = MassUnit::parse(massMatch.captured(3));
+            if (MassUnit::INVALID == planetData.massUnit) {
+                errors.append(QString("Invalid mass unit '%1' in line '%2'; expected 'kg' or 't' or 'Earths'")
+                                  .arg(massMatch.captured(3), line));
+            }
+        }
+
+        return errors.length() == errorsAtStart;
+    }
+
+    bool referenceParseOrbitalDataLine(const QString& line, PlanetOrbitalData& planetData, QList<QString>& errors) {
+        const auto errorsAtStart = errors.length();
+
+        // Planet name
+        static QRegularExpression nameRegex("^([a-zA-Z _0-9]+):");
+        QRegularExpressionMatch nameMatch = nameRegex.match(line);
+        if (!nameMatch.hasMatch()) {
+            errors.append(QString("No planet name specified in line '%1'; use format '<Planet name>: [...]'").arg(line));
+        }
+        else planetData.name = nameRegex.match(line).captured(1);
+
+        // Planet period and unit
+        static QRegularExpression periodRegex("period = ([0-9]+(?:.[0-9]+)?) ([a-z]+)");
+        QRegularExpressionMatch periodMatch = periodRegex.match(line);
+        if (!periodMatch.hasMatch()) {
+            errors.append(QString("No period specified in line '%1'; use format 'period = <value> <s|h|days>'").arg(line));
+        }
+        else {
+            bool okConversion;
+            planetData.period = periodMatch.captured(1).toDouble(&okConversion);
+            if (!okConversion) errors.append(QString("Invalid period value '%1'").arg(periodMatch.captured(1)));
+
+            planetData.periodUnit = TimeUnit::parse(periodMatch.captured(2));
+            if (TimeUnit::INVALID == planetData.periodUnit) {
+                errors.append(QString("Invalid time unit '%1' in line '%2'; expected 's' or 'h' or 'days'")
+                                  .arg(periodMatch.captured(2), line));
+            }
+        }
+
+        // Planet orbital radius
+        static QRegularExpression orbitalRadiusRegex("orbital radius = ([0-9]+(?:.[0-9]+)?) ([a-zA-Z]+)");
+        QRegularExpressionMatch orbitalRadiusMatch = orbitalRadiusRegex.match(line);
+        if (!orbitalRadiusMatch.hasMatch()) {
+            errors.append(QString("No orbital radius specified in line '%1'; use format 'orbital radius = <value> <m|km|AU>'").arg(line));
+        }
+        else {
+            bool okConversion;
+            planetData.orbitalRadius = orbitalRadiusMatch.captured(1).toDouble(&okConversion);
+            if (!okConversion) errors.append(QString("Invalid orbital radius value '%1'").arg(orbitalRadiusMatch.captured(1)));
+
+            planetData.orbitalRadiusUnit = DistanceUnit::parse(orbitalRadiusMatch.captured(2));
+            if (DistanceUnit::INVALID == planetData.orbitalRadiusUnit) {
+                errors.append(QString("Invalid distance unit '%1' in line '%2'; expected 'm' or 'km' or 'AU'")
+                                  .arg(orbitalRadiusMatch.captured(2), line));
+            }
+        }
+
+        // Planet eccentricity (optional)
+        static QRegularExpression eccentricityRegex("eccentricity = ([0-9]+(?:.[0-9]+)?)");
+        QRegularExpressionMatch eccentricityMatch = eccentricityRegex.match(line);
+        if (eccentricityMatch.hasMatch()) {
+            bool okConversion;
+            planetData.eccentricity = eccentricityMatch.captured(1).toDouble(&okConversion);
+            if (!okConversion) errors.append(QString("Invalid eccentricity value '%1'").arg(eccentricityMatch.captured(1)));
+            else if (planetData.eccentricity >= 1) {
+                errors.append(QString("Eccentricity %1 in line '%2' is not that of an orbit; expected a value from 0 up to (excluding) 1")
+                                  .arg(eccentricityMatch.captured(1), line));
+            }
+        }
+
+        // Planet argument of periapsis and unit (optional)
+        static QRegularExpression argumentOfPeriapsisRegex("argument of periapsis = (-?[0-9]+(?:.[0-9]+)?) ?([^ ,;]+)");
+        QRegularExpressionMatch argumentOfPeriapsisMatch = argumentOfPeriapsisRegex.match(line);
+        if (argumentOfPeriapsisMatch.hasMatch()) {
+            bool okConversion;
+            planetData.argumentOfPeriapsis = argumentOfPeriapsisMatch.captured(1).toDouble(&okConversion);
+            if (!okConversion) errors.append(QString("Invalid argument of periapsis value '%1'").arg(argumentOfPeriapsisMatch.captured(1)));
+
+            planetData.argumentOfPeriapsisUnit = AngleUnit::parse(argumentOfPeriapsisMatch.captured(2));
+            if (AngleUnit::INVALID == planetData.argumentOfPeriapsisUnit) {
+                errors.append(QString("Invalid angle unit '%1' in line '%2'; expected '°' or 'rad'")
+                                  .arg(argumentOfPeriapsisMatch.captured(2), line));
+            }
+        }
+
+        // Planet epoch (time of periapsis passage) and unit (optional)
+        static QRegularExpression epochRegex("epoch = (-?[0-9]+(?:.[0-9]+)?) ([a-z]+)");
+        QRegularExpressionMatch epochMatch = epochRegex.match(line);
+        if (epochMatch.hasMatch()) {
+            bool okConversion;
+            planetData.epoch = epochMatch.captured(1).toDouble(&okConversion);
+            if (!okConversion) errors.append(QString("Invalid epoch value '%1'").arg(epochMatch.captured(1)));
+
+            planetData.epochUnit = TimeUnit::parse(epochMatch.captured(2));
+            if (TimeUnit::INVALID == planetData.epochUnit) {
+                errors.append(QString("Invalid time unit '%1' in line '%2'; expected 's' or 'h' or 'days'")
+                                  .arg(epochMatch.captured(2), line));
+            }
+        }
+
+        return errors.length() == errorsAtStart;
+    }
+
+    bool sameValue(double first, double second) {
+        return 0 == std::memcmp(&first, &second, sizeof(double));
+    }
+
+    bool samePlanetData(const PlanetData& first, const PlanetData& second) {
+        return first.name == second.name
+               && sameValue(first.diameter, second.diameter) && first.diameterUnit == second.diameterUnit
+               && sameValue(first.mass, second.mass) && first.massUnit == second.massUnit;
+    }
+
+    bool samePlanetData(const PlanetOrbitalData& first, const PlanetOrbitalData& second) {
+        return first.name == second.name
+               && sameValue(first.period, second.period) && first.periodUnit == second.periodUnit
+               && sameValue(first.orbitalRadius, second.orbitalRadius) && first.orbitalRadiusUnit == second.orbitalRadiusUnit
+               && sameValue(first.eccentricity, second.eccentricity)
+               && sameValue(first.argumentOfPeriapsis, second.argumentOfPeriapsis)
+               && first.argumentOfPeriapsisUnit == second.argumentOfPeriapsisUnit
+               && sameValue(first.epoch, second.epoch) && first.epochUnit == second.epochUnit;
+    }
+
+    /**
+     * Runs both parsers on the line; returns whether they agree (printing the
+     * line if not). Captured values are only compared for accepted lines.
+     */
+    template <class Data, class Parser, class ReferenceParser>
+    bool parsersAgree(const QString& line, Parser parse, ReferenceParser referenceParse) {
+        Data data, referenceData;
+        QList<QString> errors, referenceErrors;
+        const bool accepted = parse(line, data, errors);
+        const bool referenceAccepted = referenceParse(line, referenceData, referenceErrors);
+
+        const bool agree = accepted == referenceAccepted && errors == referenceErrors
+                           && (!accepted || samePlanetData(data, referenceData));
+        if (!agree) std::printf("MISMATCH on line '%s'\n", qPrintable(line));
+        return agree;
+    }
+
+    QString wellFormedPlanetLine(int i) {
+        return QString("Planet %1: diameter = %2.%3 km, mass = %4.%5 * 10^%6 kg")
+            .arg(i).arg(1000 + i % 90000).arg(i % 10).arg(1 + i % 9).arg(i % 100, 2, 10, QChar('0')).arg(20 + i % 8);
+    }
+
+    QString wellFormedOrbitalDataLine(int i) {
+        return QString("Planet %1: period = %2.%3 days, orbital radius = %4.%5 AU, eccentricity = 0.%6, "
+                       "argument of periapsis = %7.5°, epoch = %8 days")
+            .arg(i).arg(100 + i % 5000).arg(i % 1000, 3, 10, QChar('0')).arg(1 + i % 40)
+            .arg(i % 10000, 4, 10, QChar('0')).arg(i % 9000, 4, 10, QChar('0')).arg(i % 360).arg(i % 700);
+    }
+
+    /**
+     * Throughput (in MB/s of UTF-8) of parsing the lines with `parseLine`,
+     * at best over the repetitions.
+     */
+    template <class Data, class Parser>
+    double throughput(const QString& text, Parser parseLine, qsizetype& acceptedCount) {
+        const double megabytes = text.toUtf8().size() / 1e6;
+        qint64 bestNanoseconds = std::numeric_limits<qint64>::max();
+        for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+            QList<QString> errors;
+            acceptedCount = 0;
+
+            QElapsedTimer timer;
+            timer.start();
+            CatalogParser::forEachLine(text, [&](QStringView line) {
+                Data data;
+                if (parseLine(line, data, errors)) ++acceptedCount;
+            });
+            bestNanoseconds = std::min(bestNanoseconds, timer.nsecsElapsed());
+        }
+        return megabytes / (bestNanoseconds / 1e9);
+    }
+
+    template <class Data, class Parser, class ReferenceParser>
+    bool benchmark(const char* label, QString (*wellFormedLine)(int), Parser parse, ReferenceParser referenceParse) {
+        QString text, referenceText;
+        for (int i = 0; i < BENCHMARK_LINE_COUNT; ++i) {
+            const QString line = wellFormedLine(i) + "\n";
+            text += line;
+            if (i < REFERENCE_BENCHMARK_LINE_COUNT) referenceText += line;
+        }
+
+        qsizetype acceptedCount, referenceAcceptedCount;
+        const double parserThroughput = throughput<Data>(text, parse, acceptedCount);
+        const double referenceThroughput = throughput<Data>(referenceText, [&](QStringView line, Data& data, QList<QString>& errors) {
+            return referenceParse(line.toString(), data, errors);
+        }, referenceAcceptedCount);
+
+        std::printf("%s: CatalogParser %.0f MB/s (%lld lines accepted), regular expressions %.1f MB/s (%lld lines accepted)\n",
+                    label, parserThroughput, qlonglong(acceptedCount), referenceThroughput, qlonglong(referenceAcceptedCount));
+        return BENCHMARK_LINE_COUNT == acceptedCount && REFERENCE_BENCHMARK_LINE_COUNT == referenceAcceptedCount;
+    }
+}
+
+int main() {
+    // Pieces of fields, including the near misses the regular expressions treat specially
+    // ('.' matching any character, optional exponents, signs, units)
+    const QList<QString> fragments = {
+        "diameter = ", "mass = ", "period = ", "orbital radius = ", "eccentricity = ", "argument of periapsis = ",
+        "epoch = ", " * 10^", "0", "1", "2", "9", "12", "3.5", " ", ".", ",", ";", "-", "*", "^", "km", "m", "AU",
+        "kg", "t", "Earths", "s", "h", "days", "°", "rad", "x", "E", "e", ":", "Name", "_", "é"
+    };
+
+    std::mt19937 random(1);
+    qsizetype lineCount = 0;
+    qsizetype mismatchCount = 0;
+    const auto check = [&](const QString& line) {
+        lineCount += 2;
+        if (!parsersAgree<PlanetData>(line, CatalogParser::parsePlanetLine, referenceParsePlanetLine)) ++mismatchCount;
+        if (!parsersAgree<PlanetOrbitalData>(line, CatalogParser::parseOrbitalDataLine, referenceParseOrbitalDataLine)) ++mismatchCount;
+    };
+
+    for (int i = 0; i < 1000; ++i) {
+        check(wellFormedPlanetLine(i));
+        check(wellFormedOrbitalDataLine(i));
+    }
+    for (int i = 0; i < FUZZED_LINE_COUNT; ++i) {
+        QString line;
+        const int fragmentCount = 1 + random() % 12;
+        for (int j = 0; j < fragmentCount; ++j) line += fragments[random() % fragments.size()];
+        check(line);
+    }
+    std::printf("%lld lines checked against the regular expressions: %lld mismatches\n", qlonglong(lineCount), qlonglong(mismatchCount));
+
+    bool allAccepted = benchmark<PlanetData>("Planet data", wellFormedPlanetLine,
+                                             CatalogParser::parsePlanetLine, referenceParsePlanetLine);
+    allAccepted &= benchmark<PlanetOrbitalData>("Orbital data", wellFormedOrbitalDataLine,
+                                                CatalogParser::parseOrbitalDataLine, referenceParseOrbitalDataLine);
+
+    return 0 == mismatchCount && allAccepted ? 0 : 1;
+}
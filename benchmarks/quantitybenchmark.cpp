@@ -0,0 +1,102 @@
+/**
+ * Checks that `Quantity` (see quantity.h) costs nothing over bare doubles:
+ * the same computations, written once with quantities and once with
+ * doubles and hand-written conversion factors, must give bit-identical
+ * results in the same time.
+ *
+ * The kernels are kept out of line so that their code can also be compared
+ * directly: in `objdump -d -C quantity_benchmark`, each `quantity...Kernel`
+ * should match its `double...Kernel` instruction for instruction.
+ */
+
+#include "quantity.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+    constexpr std::size_t VALUE_COUNT = 1 << 20;
+    constexpr int REPETITIONS = 200;
+
+    // What planning code does with times: offset a timeframe in years by days
+    [[gnu::noinline]] void quantityTimeKernel(const Years* starts, const Days* offsets, Years* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) out[i] = starts[i] + offsets[i];
+    }
+
+    [[gnu::noinline]] void doubleTimeKernel(const double* starts, const double* offsets, double* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) out[i] = starts[i] + offsets[i] * (86400.0 / 31556952.0);
+    }
+
+    // Mixed dimensions: distance covered at a speed over a time given in days
+    [[gnu::noinline]] void quantitySpeedKernel(const Metres* distances, const Days* times, MetresPerSecond* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) out[i] = distances[i] / Seconds(times[i]);
+    }
+
+    [[gnu::noinline]] void doubleSpeedKernel(const double* distances, const double* times, double* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) out[i] = distances[i] / (times[i] * 86400.0);
+    }
+
+    /**
+     * Best time (in nanoseconds per value) of the kernel over the repetitions.
+     */
+    template <class Kernel>
+    double bestTime(Kernel kernel) {
+        double best = 1e300;
+        for (int repetition = 0; repetition < REPETITIONS; ++repetition) {
+            const auto start = std::chrono::steady_clock::now();
+            kernel();
+            const auto end = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(end - start).count() / VALUE_COUNT);
+        }
+        return best;
+    }
+
+    template <class Q>
+    bool sameBits(const std::vector<Q>& quantities, const std::vector<double>& doubles) {
+        static_assert(sizeof(Q) == sizeof(double));
+        return 0 == std::memcmp(quantities.data(), doubles.data(), doubles.size() * sizeof(double));
+    }
+}
+
+int main() {
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> distribution(0.0, 1000.0);
+
+    std::vector<double> firstValues(VALUE_COUNT), secondValues(VALUE_COUNT);
+    for (std::size_t i = 0; i < VALUE_COUNT; ++i) {
+        firstValues[i] = distribution(random);
+        secondValues[i] = distribution(random) + 1;
+    }
+
+    std::vector<Years> starts(VALUE_COUNT);
+    std::vector<Days> offsets(VALUE_COUNT);
+    std::vector<Metres> distances(VALUE_COUNT);
+    for (std::size_t i = 0; i < VALUE_COUNT; ++i) {
+        starts[i] = Years(firstValues[i]);
+        offsets[i] = Days(secondValues[i]);
+        distances[i] = Metres(firstValues[i]);
+    }
+
+    std::vector<Years> quantityTimes(VALUE_COUNT);
+    std::vector<MetresPerSecond> quantitySpeeds(VALUE_COUNT);
+    std::vector<double> doubleTimes(VALUE_COUNT), doubleSpeeds(VALUE_COUNT);
+
+    const double quantityTimeTime = bestTime([&]() { quantityTimeKernel(starts.data(), offsets.data(), quantityTimes.data(), VALUE_COUNT); });
+    const double doubleTimeTime = bestTime([&]() { doubleTimeKernel(firstValues.data(), secondValues.data(), doubleTimes.data(), VALUE_COUNT); });
+    const double quantitySpeedTime = bestTime([&]() { quantitySpeedKernel(distances.data(), offsets.data(), quantitySpeeds.data(), VALUE_COUNT); });
+    const double doubleSpeedTime = bestTime([&]() { doubleSpeedKernel(firstValues.data(), secondValues.data(), doubleSpeeds.data(), VALUE_COUNT); });
+
+    const bool timesIdentical = sameBits(quantityTimes, doubleTimes);
+    const bool speedsIdentical = sameBits(quantitySpeeds, doubleSpeeds);
+
+    std::printf("Years + Days:    quantities %.3f ns/value, doubles %.3f ns/value, results %s\n",
+                quantityTimeTime, doubleTimeTime, timesIdentical ? "identical" : "DIFFERENT");
+    std::printf("Metres / Days:   quantities %.3f ns/value, doubles %.3f ns/value, results %s\n",
+                quantitySpeedTime, doubleSpeedTime, speedsIdentical ? "identical" : "DIFFERENT");
+
+    return timesIdentical && speedsIdentical ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+#include "catalogloader.h"
+
+#include <QtConcurrent>
+
+#include <cstring>
+#include <numeric>
+
+using CatalogLoader::ChunkCache;
+using CatalogLoader::ChunkKey;
+using CatalogLoader::ChunkResult;
+using CatalogParser::PlanetData;
+using CatalogParser::PlanetOrbitalData;
+
+namespace {
+    constexpr qint64 MINIMUM_CHUNK_SIZE = CatalogLoader::CHUNK_SIZE / 2;
+    constexpr qint64 MAXIMUM_CHUNK_SIZE = CatalogLoader::CHUNK_SIZE * 2;
+
+    // A line ends a chunk if the low bits of its hash are all clear, i.e.
+    // about one line in 8192 (so a few hundred kilobytes apart)
+    constexpr size_t CHUNK_BOUNDARY_MASK = (size_t(1) << 13) - 1;
+
+    /**
+     * Finds where the chunk starting at `start` ends: just after the first
+     * line that passes `MINIMUM_CHUNK_SIZE` and has a hash matching
+     * `CHUNK_BOUNDARY_MASK`, or just after the line that passes
+     * `MAXIMUM_CHUNK_SIZE` if there is no such line before.
+     */
+    qint64 findChunkEnd(const char* text, qint64 start, qint64 size) {
+        if (size - start <= MINIMUM_CHUNK_SIZE) return size;
+
+        // Skip to the first whole line past the minimum size
+        const void* lineBreak = std::memchr(text + start + MINIMUM_CHUNK_SIZE, '\n', size - start - MINIMUM_CHUNK_SIZE);
+        if (nullptr == lineBreak) return size;
+        qint64 lineStart = static_cast<const char*>(lineBreak) - text + 1;
+
+        while (lineStart < size) {
+            lineBreak = std::memchr(text + lineStart, '\n', size - lineStart);
+            if (nullptr == lineBreak) return size;
+            const qint64 lineEnd = static_cast<const char*>(lineBreak) - text + 1;
+
+            if (0 == (qHashBits(text + lineStart, lineEnd - lineStart, 0) & CHUNK_BOUNDARY_MASK)
+                || lineEnd - start >= MAXIMUM_CHUNK_SIZE) {
+                return lineEnd;
+            }
+            lineStart = lineEnd;
+        }
+        return size;
+    }
+
+    bool parseLine(QStringView line, PlanetData& planetData, QList<QString>& errors) {
+        return CatalogParser::parsePlanetLine(line, planetData, errors);
+    }
+
+    bool parseLine(QStringView line, PlanetOrbitalData& planetData, QList<QString>& errors) {
+        return CatalogParser::parseOrbitalDataLine(line, planetData, errors);
+    }
+
+    template <class Data>
+    ChunkResult<Data> parseChunk(const CatalogLoader::CatalogFile& file, qsizetype chunkIndex) {
+        return file.parseChunk<Data>(chunkIndex, [](QStringView line, Data& data, QList<QString>& errors) {
+            return parseLine(line, data, errors);
+        });
+    }
+}
+
+bool CatalogLoader::CatalogFile::open(const QString& fileName) {
+    file.setFileName(fileName);
+    if (!file.open(QIODeviceBase::ReadOnly)) return false;
+
+    // Map the file if possible; otherwise (e.g. for some special files), read it whole
+    qint64 size = file.size();
+    text = 0 == size ? nullptr : reinterpret_cast<const char*>(file.map(0, size));
+    if (nullptr == text) {
+        contents = file.readAll();
+        text = contents.constData();
+        size = contents.size();
+    }
+
+    // Skip the UTF-8 byte order mark, if any
+    qint64 start = size >= 3 && 0 == std::memcmp(text, "\xEF\xBB\xBF", 3) ? 3 : 0;
+
+    chunks.clear();
+    while (start < size) {
+        const qint64 end = findChunkEnd(text, start, size);
+        chunks.append({ start, end });
+        start = end;
+    }
+    return true;
+}
+
+qsizetype CatalogLoader::CatalogFile::chunkCount() const {
+    return chunks.size();
+}
+
+ChunkKey CatalogLoader::CatalogFile::chunkKey(qsizetype chunkIndex) const {
+    const Chunk& chunk = chunks[chunkIndex];
+    return { qHashBits(text + chunk.start, chunk.end - chunk.start, 0), chunk.end - chunk.start };
+}
+
+template <class Data>
+void ChunkCache<Data>::startLoad() {
+    QMutexLocker locker(&mutex);
+    previousChunks = std::move(currentChunks);
+    currentChunks.clear();
+    parsedCount = 0;
+}
+
+template <class Data>
+ChunkResult<Data> ChunkCache<Data>::parseChunk(const CatalogFile& file, qsizetype chunkIndex) {
+    const ChunkKey key = file.chunkKey(chunkIndex);
+    {
+        QMutexLocker locker(&mutex);
+        if (const auto current = currentChunks.constFind(key); current != currentChunks.constEnd()) return current.value();
+        if (const auto previous = previousChunks.constFind(key); previous != previousChunks.constEnd()) {
+            currentChunks.insert(key, previous.value());
+            return previous.value();
+        }
+    }
+
+    // Parse without holding the lock, so that other chunks can be parsed meanwhile
+    const ChunkResult<Data> result = ::parseChunk<Data>(file, chunkIndex);
+
+    QMutexLocker locker(&mutex);
+    currentChunks.insert(key, result);
+    ++parsedCount;
+    return result;
+}
+
+template <class Data>
+void ChunkCache<Data>::finishLoad() {
+    QMutexLocker locker(&mutex);
+    previousChunks.clear();
+}
+
+template <class Data>
+qsizetype ChunkCache<Data>::chunksParsed() const {
+    QMutexLocker locker(&mutex);
+    return parsedCount;
+}
+
+template class CatalogLoader::ChunkCache<PlanetData>;
+template class CatalogLoader::ChunkCache<PlanetOrbitalData>;
+
+namespace {
+    template <class Data>
+    bool loadCatalog(const QString& fileName, QList<Data>& entries, QList<QString>& errors, ChunkCache<Data>* cache) {
+        CatalogLoader::CatalogFile file;
+        if (!file.open(fileName)) return false;
+
+        QList<qsizetype> chunkIndices(file.chunkCount());
+        std::iota(chunkIndices.begin(), chunkIndices.end(), 0);
+
+        if (nullptr != cache) cache->startLoad();
+        const ChunkResult<Data> result = QtConcurrent::blockingMappedReduced<ChunkResult<Data>>(
+            chunkIndices,
+            [&](qsizetype chunkIndex) {
+                return nullptr != cache ? cache->parseChunk(file, chunkIndex) : parseChunk<Data>(file, chunkIndex);
+            },
+            [](ChunkResult<Data>& result, const ChunkResult<Data>& chunkResult) {
+                result.entries.append(chunkResult.entries);
+                result.errors.append(chunkResult.errors);
+            },
+            QtConcurrent::OrderedReduce
+            );
+        if (nullptr != cache) cache->finishLoad();
+
+        entries.append(result.entries);
+        errors.append(result.errors);
+        return true;
+    }
+}
+
+bool CatalogLoader::loadPlanetData(
+    const QString& fileName, QList<PlanetData>& planetDataList, QList<QString>& errors, ChunkCache<PlanetData>* cache
+    ) {
+    return loadCatalog(fileName, planetDataList, errors, cache);
+}
+
+bool CatalogLoader::loadOrbitalData(
+    const QString& fileName, QList<PlanetOrbitalData>& planetDataList, QList<QString>& errors, ChunkCache<PlanetOrbitalData>* cache
+    ) {
+    return loadCatalog(fileName, planetDataList, errors, cache);
+}
@@ -0,0 +1,161 @@
+#ifndef CATALOGLOADER_H
+#define CATALOGLOADER_H
+
+#include "catalogparser.h"
+
+#include <QByteArray>
+#include <QFile>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include <utility>
+
+/**
+ * Loads whole planet and orbital data files (see `CatalogParser`).
+ *
+ * Files are memory-mapped rather than read, and split into chunks that end
+ * on line breaks. Chunks are decoded and parsed in parallel on the global
+ * thread pool, each into its own lists of entries and errors, which are then
+ * concatenated in file order: the results (and the order of errors) are the
+ * same as parsing the file line by line. Only the chunks being parsed are
+ * held decoded in memory at any time.
+ */
+namespace CatalogLoader {
+    /**
+     * Typical size of the chunks (in bytes) the files are split into. Chunks
+     * are between half and twice that size, except at the end of the file.
+     */
+    constexpr qint64 CHUNK_SIZE = 4 * 1024 * 1024;
+
+    /**
+     * Entries parsed from a chunk, and the problems found in it (both in
+     * file order).
+     */
+    template <class Data>
+    struct ChunkResult {
+        QList<Data> entries;
+        QList<QString> errors;
+    };
+
+    /**
+     * Identifies the contents of a chunk: a hash of its bytes, and its size.
+     */
+    using ChunkKey = std::pair<size_t, qint64>;
+
+    /**
+     * A catalog file, memory-mapped (or read whole, if it cannot be mapped)
+     * and split into chunks. Chunks can be parsed from any thread, for as long
+     * as the file stays open.
+     *
+     * Chunks end after lines chosen by their contents (those whose hash has
+     * its low bits clear), rather than at given offsets: editing part of the
+     * file only changes the chunks around the edit, even if it shifts
+     * everything after it, so the other chunks can be reused (see
+     * `ChunkCache`) when the file is loaded again.
+     */
+    class CatalogFile {
+    public:
+        /**
+         * Opens and maps the file, and works out its chunks. Returns false if
+         * the file could not be opened.
+         */
+        bool open(const QString& fileName);
+
+        qsizetype chunkCount() const;
+        ChunkKey chunkKey(qsizetype chunkIndex) const;
+
+        /**
+         * Parses the lines of a chunk with `parseLine(line, data, errors)`
+         * (e.g. `CatalogParser::parsePlanetLine`).
+         */
+        template <class Data, class LineParser>
+        ChunkResult<Data> parseChunk(qsizetype chunkIndex, LineParser parseLine) const {
+            const Chunk& chunk = chunks[chunkIndex];
+            const QString chunkText = QString::fromUtf8(text + chunk.start, chunk.end - chunk.start);
+
+            ChunkResult<Data> result;
+            CatalogParser::forEachLine(chunkText, [&](QStringView line) {
+                // If no new errors were encountered (i.e. this line is fine), add to dataset
+                Data data;
+                if (parseLine(line, data, result.errors)) result.entries.append(std::move(data));
+            });
+            return result;
+        }
+
+    private:
+        struct Chunk {
+            qint64 start;
+            qint64 end;
+        };
+
+        QFile file;
+        QByteArray contents; // Only used if the file could not be mapped
+        const char* text = nullptr;
+        QList<Chunk> chunks;
+    };
+
+    /**
+     * Keeps the parsed chunks of a catalog file, by contents, so that loading
+     * the file again after it changed only parses the chunks that changed.
+     * Chunks are kept from one load to the next only; chunks of older
+     * versions of the file are dropped. Chunks can be parsed from any thread.
+     */
+    template <class Data>
+    class ChunkCache {
+    public:
+        /**
+         * Starts a new load of the file. Chunks of the previous load stay
+         * available for reuse until it finishes.
+         */
+        void startLoad();
+
+        /**
+         * Parses a chunk of the file, unless a chunk with the same contents
+         * was parsed during this load or the previous one.
+         */
+        ChunkResult<Data> parseChunk(const CatalogFile& file, qsizetype chunkIndex);
+
+        /**
+         * Drops the chunks of the previous load that were not reused.
+         */
+        void finishLoad();
+
+        /**
+         * Number of chunks actually parsed (rather than reused) since the
+         * load started.
+         */
+        qsizetype chunksParsed() const;
+
+    private:
+        mutable QMutex mutex;
+        QHash<ChunkKey, ChunkResult<Data>> previousChunks;
+        QHash<ChunkKey, ChunkResult<Data>> currentChunks;
+        qsizetype parsedCount = 0;
+    };
+
+    /**
+     * Parses each line of the planet data file, appending valid ones to
+     * `planetDataList` and problems to `errors` (in file order). Returns
+     * false if the file could not be opened. If a cache is given, chunks
+     * unchanged since it was last used are not parsed again.
+     */
+    bool loadPlanetData(
+        const QString& fileName, QList<CatalogParser::PlanetData>& planetDataList, QList<QString>& errors,
+        ChunkCache<CatalogParser::PlanetData>* cache = nullptr
+        );
+
+    /**
+     * Parses each line of the orbital data file, appending valid ones to
+     * `planetDataList` and problems to `errors` (in file order). Returns
+     * false if the file could not be opened. If a cache is given, chunks
+     * unchanged since it was last used are not parsed again.
+     */
+    bool loadOrbitalData(
+        const QString& fileName, QList<CatalogParser::PlanetOrbitalData>& planetDataList, QList<QString>& errors,
+        ChunkCache<CatalogParser::PlanetOrbitalData>* cache = nullptr
+        );
+}
+
+#endif // CATALOGLOADER_H
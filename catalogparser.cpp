@@ -0,0 +1,346 @@
+#include "catalogparser.h"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <optional>
+#include <string>
+
+namespace {
+    /**
+     * A "<key>(-?[0-9]+(?:.[0-9]+)?)(?: \* 10\^([0-9]+))? ?(<unit>+)" field,
+     * with the sign, exponent, unit and space before it each optional.
+     */
+    struct FieldPattern {
+        QStringView key;
+        bool isSigned = false;
+        bool hasExponent = false;
+        bool (*isUnitCharacter)(char16_t) = nullptr; // No unit if null
+        bool isUnitSpaceOptional = false;
+    };
+
+    struct FieldMatch {
+        QStringView number;
+        QStringView exponent;
+        QStringView unit;
+    };
+
+    bool isDigit(char16_t character) { return u'0' <= character && character <= u'9'; }
+    bool isLowercaseLetter(char16_t character) { return u'a' <= character && character <= u'z'; }
+    bool isLetter(char16_t character) { return isLowercaseLetter(character) || (u'A' <= character && character <= u'Z'); }
+    bool isUnitSymbolCharacter(char16_t character) { return u' ' != character && u',' != character && u';' != character; }
+    bool isNameCharacter(char16_t character) { return isLetter(character) || isDigit(character) || u' ' == character || u'_' == character; }
+
+    qsizetype countWhile(QStringView text, qsizetype start, bool (*predicate)(char16_t)) {
+        qsizetype end = start;
+        while (end < text.size() && predicate(text[end].unicode())) ++end;
+        return end - start;
+    }
+
+    /**
+     * Matches what follows the number (from `start`): the exponent, if any,
+     * then the unit, if any. Tries alternatives in the order the regular
+     * expression would.
+     */
+    std::optional<FieldMatch> matchAfterNumber(QStringView line, qsizetype start, const FieldPattern& pattern) {
+        const auto matchUnit = [&](qsizetype unitStart) -> std::optional<QStringView> {
+            if (nullptr == pattern.isUnitCharacter) return QStringView();
+            if (unitStart < line.size() && u' ' == line[unitStart]) {
+                const qsizetype unitLength = countWhile(line, unitStart + 1, pattern.isUnitCharacter);
+                if (unitLength > 0) return line.sliced(unitStart + 1, unitLength);
+            }
+            if (pattern.isUnitSpaceOptional) {
+                const qsizetype unitLength = countWhile(line, unitStart, pattern.isUnitCharacter);
+                if (unitLength > 0) return line.sliced(unitStart, unitLength);
+            }
+            return std::nullopt;
+        };
+
+        if (pattern.hasExponent && line.sliced(start).startsWith(u" * 10^")) {
+            const qsizetype exponentStart = start + 6;
+            const qsizetype exponentLength = countWhile(line, exponentStart, isDigit);
+            if (exponentLength > 0) {
+                // Shorter exponents would leave a digit where the unit's space goes
+                if (const auto unit = matchUnit(exponentStart + exponentLength)) {
+                    return FieldMatch { QStringView(), line.sliced(exponentStart, exponentLength), unit.value() };
+                }
+            }
+        }
+
+        if (const auto unit = matchUnit(start)) return FieldMatch { QStringView(), QStringView(), unit.value() };
+        return std::nullopt;
+    }
+
+    /**
+     * Matches the field's value at `start` (just after its key), with the
+     * backtracking of "(-?[0-9]+(?:.[0-9]+)?)" (where `.` is any character).
+     */
+    std::optional<FieldMatch> matchField(QStringView line, qsizetype start, const FieldPattern& pattern) {
+        qsizetype digitsStart = start;
+        if (pattern.isSigned && digitsStart < line.size() && u'-' == line[digitsStart]) ++digitsStart;
+
+        for (qsizetype integerLength = countWhile(line, digitsStart, isDigit); integerLength > 0; --integerLength) {
+            const qsizetype integerEnd = digitsStart + integerLength;
+
+            // With the fraction, longest first (its separator is any one code point)
+            if (integerEnd < line.size() && u'\n' != line[integerEnd]) {
+                const qsizetype separatorLength = line[integerEnd].isHighSurrogate() && integerEnd + 1 < line.size()
+                                                  && line[integerEnd + 1].isLowSurrogate() ? 2 : 1;
+                const qsizetype fractionStart = integerEnd + separatorLength;
+                for (qsizetype fractionLength = countWhile(line, fractionStart, isDigit); fractionLength > 0; --fractionLength) {
+                    const qsizetype numberEnd = fractionStart + fractionLength;
+                    if (auto match = matchAfterNumber(line, numberEnd, pattern)) {
+                        match->number = line.sliced(start, numberEnd - start);
+                        return match;
+                    }
+                }
+            }
+
+            // Without
+            if (auto match = matchAfterNumber(line, integerEnd, pattern)) {
+                match->number = line.sliced(start, integerEnd - start);
+                return match;
+            }
+        }
+
+        return std::nullopt;
+    }
+
+    /**
+     * Finds the leftmost match of each of a set of patterns, in a single
+     * pass over the line.
+     */
+    template <std::size_t FieldCount>
+    class FieldScanner {
+    private:
+        std::array<FieldPattern, FieldCount> patterns;
+        std::array<quint32, 128> keysStartingWith {}; // Per ASCII character; most characters start none
+
+    public:
+        explicit FieldScanner(const std::array<FieldPattern, FieldCount>& patterns): patterns(patterns) {
+            for (std::size_t i = 0; i < FieldCount; ++i) keysStartingWith[patterns[i].key.front().unicode()] |= quint32(1) << i;
+        }
+
+        std::array<std::optional<FieldMatch>, FieldCount> match(QStringView line) const {
+            std::array<std::optional<FieldMatch>, FieldCount> matches;
+            std::size_t remainingFields = FieldCount;
+
+            for (qsizetype position = 0; position < line.size() && remainingFields > 0; ++position) {
+                const char16_t character = line[position].unicode();
+                if (character >= 128) continue;
+
+                const QStringView rest = line.sliced(position);
+                for (quint32 candidates = keysStartingWith[character]; 0 != candidates; candidates &= candidates - 1) {
+                    const std::size_t i = std::countr_zero(candidates);
+                    if (matches[i].has_value() || !rest.startsWith(patterns[i].key)) continue;
+
+                    matches[i] = matchField(line, position + patterns[i].key.size(), patterns[i]);
+                    if (matches[i].has_value()) --remainingFields;
+                }
+            }
+
+            return matches;
+        }
+    };
+
+    /**
+     * The name before the first colon, if it only uses allowed characters
+     * ("^([a-zA-Z _0-9]+):").
+     */
+    std::optional<QStringView> matchName(QStringView line) {
+        const qsizetype nameLength = countWhile(line, 0, isNameCharacter);
+        if (0 == nameLength || nameLength == line.size() || u':' != line[nameLength]) return std::nullopt;
+        return line.first(nameLength);
+    }
+
+    /**
+     * Reads a number as `QString::toDouble` would (in the C locale), with
+     * an optional power-of-10 exponent, going through the characters once.
+     */
+    std::optional<double> toDouble(QStringView number, QStringView exponent = QStringView()) {
+        std::array<char, 64> buffer;
+        std::string longBuffer;
+        const qsizetype length = number.size() + (exponent.isEmpty() ? 0 : 1 + exponent.size());
+        char* characters = buffer.data();
+        if (length > qsizetype(buffer.size())) {
+            longBuffer.resize(length);
+            characters = longBuffer.data();
+        }
+
+        qsizetype i = 0;
+        const auto append = [&](QStringView text) {
+            for (const QChar character : text) {
+                if (character.unicode() > 0x7F) return false; // Never part of a number
+                characters[i++] = char(character.unicode());
+            }
+            return true;
+        };
+        if (!append(number)) return std::nullopt;
+        if (!exponent.isEmpty()) {
+            characters[i++] = 'e';
+            if (!append(exponent)) return std::nullopt;
+        }
+
+        double value;
+        const auto [end, error] = std::from_chars(characters, characters + length, value);
+        if (std::errc() != error || characters + length != end) return std::nullopt;
+        return value;
+    }
+}
+
+bool CatalogParser::parsePlanetLine(QStringView line, PlanetData& planetData, QList<QString>& errors) {
+    const auto errorsAtStart = errors.length(); // Hacky way to check if any new errors were added
+
+    // Planet name
+    const std::optional<QStringView> name = matchName(line);
+    if (!name.has_value()) {
+        errors.append(QString("No planet name specified in line '%1'; use format '<Planet name>: [...]'").arg(line));
+    }
+    else planetData.name = name.value().toString();
+
+    // Fields can come in any order
+    static const FieldScanner<2> fields({
+        FieldPattern { u"diameter = ", false, false, isLowercaseLetter, false },
+        FieldPattern { u"mass = ", false, true, isLetter, false }
+    });
+    const auto [diameterMatch, massMatch] = fields.match(line);
+
+    // Planet radius and unit
+    if (!diameterMatch.has_value()) {
+        errors.append(QString("No diameter specified in line '%1'; use format 'diameter = <value> <m|km>'").arg(line));
+    }
+    else {
+        const std::optional<double> diameter = toDouble(diameterMatch->number);
+        if (!diameter.has_value()) errors.append(QString("Invalid diameter value '%1'").arg(diameterMatch->number));
+        else planetData.diameter = diameter.value();
+
+        planetData.diameterUnit = DistanceUnit::parse(diameterMatch->unit);
+        if (DistanceUnit::INVALID == planetData.diameterUnit) {
+            errors.append(QString("Invalid distance unit '%1' in line '%2'; expected 'km' or 'm'")
+                              .arg(diameterMatch->unit, line));
+        }
+    }
+
+    // Planet mass and unit
+    // Basically, we accept mass in decimal + digits format w/ optional power-of-10 factor
+    if (!massMatch.has_value()) {
+        errors.append(QString("No mass specified in line '%1'; use format 'mass = <value> <kg|t|Earths>'").arg(line));
+    }
+    else {
+        // FIXME: currently, mass parsing fails on exponent-only mass, like "10^26 kg"
+        // Read as a single number (e.g. "6e24"), so that it rounds just once
+        const std::optional<double> mass = toDouble(massMatch->number, massMatch->exponent);
+        if (!mass.has_value()) {
+            if (!massMatch->exponent.isEmpty()) {
+                errors.append(QString("Invalid mass value '%1 * 10 ^ %2' in line '%3'")
+                                  .arg(massMatch->number, massMatch->exponent, line));
+            }
+            else errors.append(QString("Invalid mass value '%1' in line '%2'").arg(massMatch->number, line));
+        }
+        else planetData.mass = mass.value();
+
+        planetData.massUnit = MassUnit::parse(massMatch->unit);
+        if (MassUnit::INVALID == planetData.massUnit) {
+            errors.append(QString("Invalid mass unit '%1' in line '%2'; expected 'kg' or 't' or 'Earths'")
+                              .arg(massMatch->unit, line));
+        }
+    }
+
+    return errors.length() == errorsAtStart;
+}
+
+bool CatalogParser::parseOrbitalDataLine(QStringView line, PlanetOrbitalData& planetData, QList<QString>& errors) {
+    const auto errorsAtStart = errors.length(); // Hacky way to check if any new errors were added
+
+    // Planet name
+    const std::optional<QStringView> name = matchName(line);
+    if (!name.has_value()) {
+        errors.append(QString("No planet name specified in line '%1'; use format '<Planet name>: [...]'").arg(line));
+    }
+    else planetData.name = name.value().toString();
+
+    // Fields can come in any order
+    static const FieldScanner<5> fields({
+        FieldPattern { u"period = ", false, false, isLowercaseLetter, false },
+        FieldPattern { u"orbital radius = ", false, false, isLetter, false },
+        FieldPattern { u"eccentricity = ", false, false, nullptr, false },
+        FieldPattern { u"argument of periapsis = ", true, false, isUnitSymbolCharacter, true },
+        FieldPattern { u"epoch = ", true, false, isLowercaseLetter, false }
+    });
+    const auto [periodMatch, orbitalRadiusMatch, eccentricityMatch, argumentOfPeriapsisMatch, epochMatch] = fields.match(line);
+
+    // Planet period and unit
+    if (!periodMatch.has_value()) {
+        errors.append(QString("No period specified in line '%1'; use format 'period = <value> <s|h|days>'").arg(line));
+    }
+    else {
+        const std::optional<double> period = toDouble(periodMatch->number);
+        if (!period.has_value()) errors.append(QString("Invalid period value '%1'").arg(periodMatch->number));
+        else planetData.period = period.value();
+
+        planetData.periodUnit = TimeUnit::parse(periodMatch->unit);
+        if (TimeUnit::INVALID == planetData.periodUnit) {
+            errors.append(QString("Invalid time unit '%1' in line '%2'; expected 's' or 'h' or 'days'")
+                              .arg(periodMatch->unit, line));
+        }
+    }
+
+    // Planet orbital radius
+    if (!orbitalRadiusMatch.has_value()) {
+        errors.append(QString("No orbital radius specified in line '%1'; use format 'orbital radius = <value> <m|km|AU>'").arg(line));
+    }
+    else {
+        const std::optional<double> orbitalRadius = toDouble(orbitalRadiusMatch->number);
+        if (!orbitalRadius.has_value()) errors.append(QString("Invalid orbital radius value '%1'").arg(orbitalRadiusMatch->number));
+        else planetData.orbitalRadius = orbitalRadius.value();
+
+        planetData.orbitalRadiusUnit = DistanceUnit::parse(orbitalRadiusMatch->unit);
+        if (DistanceUnit::INVALID == planetData.orbitalRadiusUnit) {
+            errors.append(QString("Invalid distance unit '%1' in line '%2'; expected 'm' or 'km' or 'AU'")
+                              .arg(orbitalRadiusMatch->unit, line));
+        }
+    }
+
+    // Planet eccentricity (optional)
+    if (eccentricityMatch.has_value()) {
+        const std::optional<double> eccentricity = toDouble(eccentricityMatch->number);
+        if (!eccentricity.has_value()) errors.append(QString("Invalid eccentricity value '%1'").arg(eccentricityMatch->number));
+        else {
+            planetData.eccentricity = eccentricity.value();
+            if (planetData.eccentricity >= 1) {
+                errors.append(QString("Eccentricity %1 in line '%2' is not that of an orbit; expected a value from 0 up to (excluding) 1")
+                                  .arg(eccentricityMatch->number, line));
+            }
+        }
+    }
+
+    // Planet argument of periapsis and unit (optional)
+    if (argumentOfPeriapsisMatch.has_value()) {
+        const std::optional<double> argumentOfPeriapsis = toDouble(argumentOfPeriapsisMatch->number);
+        if (!argumentOfPeriapsis.has_value()) {
+            errors.append(QString("Invalid argument of periapsis value '%1'").arg(argumentOfPeriapsisMatch->number));
+        }
+        else planetData.argumentOfPeriapsis = argumentOfPeriapsis.value();
+
+        planetData.argumentOfPeriapsisUnit = AngleUnit::parse(argumentOfPeriapsisMatch->unit);
+        if (AngleUnit::INVALID == planetData.argumentOfPeriapsisUnit) {
+            errors.append(QString("Invalid angle unit '%1' in line '%2'; expected '°' or 'rad'")
+                              .arg(argumentOfPeriapsisMatch->unit, line));
+        }
+    }
+
+    // Planet epoch (time of periapsis passage) and unit (optional)
+    if (epochMatch.has_value()) {
+        const std::optional<double> epoch = toDouble(epochMatch->number);
+        if (!epoch.has_value()) errors.append(QString("Invalid epoch value '%1'").arg(epochMatch->number));
+        else planetData.epoch = epoch.value();
+
+        planetData.epochUnit = TimeUnit::parse(epochMatch->unit);
+        if (TimeUnit::INVALID == planetData.epochUnit) {
+            errors.append(QString("Invalid time unit '%1' in line '%2'; expected 's' or 'h' or 'days'")
+                              .arg(epochMatch->unit, line));
+        }
+    }
+
+    return errors.length() == errorsAtStart;
+}
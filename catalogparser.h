@@ -0,0 +1,92 @@
+#ifndef CATALOGPARSER_H
+#define CATALOGPARSER_H
+
+#include "measurementunits.h"
+
+#include <QList>
+#include <QString>
+#include <QStringView>
+
+#include <algorithm>
+
+/**
+ * Parsers for the lines of planet data files ("Earth: diameter = 12742 km,
+ * mass = 5.97 * 10^24 kg") and orbital data files ("Earth: period = 365.25
+ * days, orbital radius = 1 AU, ...").
+ *
+ * Each line is scanned once, by hand: fields are found by their key
+ * ("diameter = ", ...), so they may come in any order, and numbers are
+ * read with `std::from_chars`. Lines are accepted and rejected exactly as
+ * the regular expressions given with each field would, with the same
+ * error messages.
+ */
+namespace CatalogParser {
+    struct PlanetData {
+        QString name;
+        double diameter;
+        DistanceUnit diameterUnit = DistanceUnit::INVALID;
+        double mass;
+        MassUnit massUnit = MassUnit::INVALID;
+    };
+
+    struct PlanetOrbitalData {
+        QString name;
+        double period;
+        TimeUnit periodUnit = TimeUnit::INVALID;
+        double orbitalRadius;
+        DistanceUnit orbitalRadiusUnit = DistanceUnit::INVALID;
+
+        // Optional; default to a circular orbit, starting at 0° at time 0
+        double eccentricity = 0;
+        double argumentOfPeriapsis = 0;
+        AngleUnit argumentOfPeriapsisUnit = AngleUnit::DEGREES;
+        double epoch = 0;
+        TimeUnit epochUnit = TimeUnit::DAYS;
+    };
+
+    /**
+     * Parses a line of a planet data file into `planetData`, appending any
+     * problems to `errors`. Returns whether the line was free of errors.
+     *
+     * Fields are:
+     * - the name, "^([a-zA-Z _0-9]+):"
+     * - "diameter = ([0-9]+(?:.[0-9]+)?) ([a-z]+)"
+     * - "mass = ([0-9]+(?:.[0-9]+)?)(?: \* 10\^([0-9]+))? ([a-zA-Z]+)"
+     */
+    bool parsePlanetLine(QStringView line, PlanetData& planetData, QList<QString>& errors);
+
+    /**
+     * Parses a line of an orbital data file into `planetData`, appending any
+     * problems to `errors`. Returns whether the line was free of errors.
+     *
+     * Fields are:
+     * - the name, "^([a-zA-Z _0-9]+):"
+     * - "period = ([0-9]+(?:.[0-9]+)?) ([a-z]+)"
+     * - "orbital radius = ([0-9]+(?:.[0-9]+)?) ([a-zA-Z]+)"
+     * - optionally, "eccentricity = ([0-9]+(?:.[0-9]+)?)"
+     * - optionally, "argument of periapsis = (-?[0-9]+(?:.[0-9]+)?) ?([^ ,;]+)"
+     * - optionally, "epoch = (-?[0-9]+(?:.[0-9]+)?) ([a-z]+)"
+     */
+    bool parseOrbitalDataLine(QStringView line, PlanetOrbitalData& planetData, QList<QString>& errors);
+
+    /**
+     * Calls `parseLine(line)` for each non-blank line of `text`, without the
+     * line ending ("\n" or "\r\n").
+     */
+    template <class LineParser>
+    void forEachLine(QStringView text, LineParser parseLine) {
+        while (!text.isEmpty()) {
+            qsizetype lineEnd = text.indexOf(u'\n');
+            if (-1 == lineEnd) lineEnd = text.size();
+
+            QStringView line = text.first(lineEnd);
+            if (line.endsWith(u'\r')) line.chop(1);
+            text = text.sliced(std::min(lineEnd + 1, text.size()));
+
+            if (line.trimmed().isEmpty()) continue; // Skip empty lines, including whitespace-only
+            parseLine(line);
+        }
+    }
+}
+
+#endif // CATALOGPARSER_H
@@ -0,0 +1,257 @@
+#include "catalogsnapshot.h"
+
+#include <QDateTime>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+#include <array>
+#include <cstring>
+#include <span>
+#include <vector>
+
+namespace {
+    constexpr char MAGIC[8] = { 'S', 'S', 'C', 'A', 'T', 0, 0, 0 };
+    constexpr quint32 BYTE_ORDER_MARK = 0x01020304;
+    constexpr qint64 SECTION_ALIGNMENT = 64;
+
+    enum class Kind : quint32 {
+        PLANETS = 1,
+        ORBITAL_DATA = 2
+    };
+
+    // Columns of each kind of snapshot, in file order
+    enum PlanetColumn { MASS_IN_KILOGRAMS, RADIUS_IN_METRES, PLANET_COLUMN_COUNT };
+    enum OrbitalColumn {
+        ORBITAL_PERIOD_IN_DAYS, ORBITAL_RADIUS_IN_AU, ECCENTRICITY,
+        ARGUMENT_OF_PERIAPSIS_IN_DEGREES, EPOCH_IN_DAYS, ORBITAL_COLUMN_COUNT
+    };
+
+    /**
+     * Start of a snapshot file. It is followed by the sections, each starting
+     * on a multiple of `SECTION_ALIGNMENT` bytes:
+     * - `columnCount` columns of `entryCount` doubles
+     * - `entryCount + 1` qint64 offsets into the names (the last one being
+     * `nameLength`)
+     * - the names, back to back, as `nameLength` UTF-16 code units
+     */
+    struct Header {
+        char magic[8];
+        quint32 version;
+        quint32 byteOrderMark; // Reads differently if written with the other byte order
+        quint32 kind;
+        quint32 columnCount;
+        qint64 entryCount;
+        qint64 nameLength;
+        qint64 sourceSize;
+        qint64 sourceLastModified; // In milliseconds since the epoch
+        char padding[8];
+    };
+    static_assert(sizeof(Header) == SECTION_ALIGNMENT);
+
+    qint64 alignedSize(qint64 size) {
+        return (size + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+    }
+
+    /**
+     * Fills in the identity of the catalog file (size and modification time)
+     * in `header`. Returns false if the file does not exist.
+     */
+    bool identifySource(const QString& catalogFileName, Header& header) {
+        const QFileInfo info(catalogFileName);
+        if (!info.isFile()) return false;
+
+        header.sourceSize = info.size();
+        header.sourceLastModified = info.lastModified().toMSecsSinceEpoch();
+        return true;
+    }
+
+    bool writeSection(QSaveFile& file, const void* data, qint64 size) {
+        static constexpr char zeros[SECTION_ALIGNMENT] = {};
+        const qint64 paddingSize = alignedSize(size) - size;
+        return file.write(static_cast<const char*>(data), size) == size
+               && file.write(zeros, paddingSize) == paddingSize;
+    }
+
+    /**
+     * Writes a snapshot with the names given by `nameAt(index)` and the
+     * given columns (each holding one value per name).
+     */
+    template <class NameAt>
+    bool writeSnapshot(
+        const QString& catalogFileName, Kind kind, qsizetype entryCount, NameAt nameAt,
+        std::span<const std::span<const double>> columns
+        ) {
+        Header header = {};
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = CatalogSnapshot::FORMAT_VERSION;
+        header.byteOrderMark = BYTE_ORDER_MARK;
+        header.kind = quint32(kind);
+        header.columnCount = quint32(columns.size());
+        header.entryCount = entryCount;
+        if (!identifySource(catalogFileName, header)) return false;
+
+        std::vector<qint64> nameOffsets;
+        nameOffsets.reserve(entryCount + 1);
+        nameOffsets.push_back(0);
+        for (qsizetype i = 0; i < entryCount; ++i) nameOffsets.push_back(nameOffsets.back() + nameAt(i).size());
+        header.nameLength = nameOffsets.back();
+
+        QSaveFile file(CatalogSnapshot::snapshotFileName(catalogFileName));
+        if (!file.open(QIODeviceBase::WriteOnly)) return false;
+
+        bool written = writeSection(file, &header, sizeof(header));
+        for (std::span<const double> column : columns) {
+            written = written && writeSection(file, column.data(), entryCount * qint64(sizeof(double)));
+        }
+        written = written && writeSection(file, nameOffsets.data(), (entryCount + 1) * qint64(sizeof(qint64)));
+        for (qsizetype i = 0; written && i < entryCount; ++i) {
+            const QString& name = nameAt(i);
+            const qint64 nameSize = name.size() * qint64(sizeof(QChar));
+            written = file.write(reinterpret_cast<const char*>(name.constData()), nameSize) == nameSize;
+        }
+
+        // Only replaces any previous snapshot if everything was written
+        return written && file.commit();
+    }
+
+    /**
+     * A snapshot file, mapped into memory for as long as this object lives.
+     */
+    class MappedSnapshot {
+    public:
+        /**
+         * Maps the snapshot of the given catalog file. Returns false if there
+         * is none, or if it is not usable (different format, kind or number
+         * of columns, truncated, or taken of a different version of the file).
+         */
+        bool open(const QString& catalogFileName, Kind kind, quint32 columnCount) {
+            Header source = {};
+            if (!identifySource(catalogFileName, source)) return false;
+
+            file.setFileName(CatalogSnapshot::snapshotFileName(catalogFileName));
+            if (!file.open(QIODeviceBase::ReadOnly)) return false;
+            const qint64 fileSize = file.size();
+            if (fileSize < qint64(sizeof(Header))) return false;
+            data = file.map(0, fileSize);
+            if (nullptr == data) return false;
+
+            std::memcpy(&header, data, sizeof(Header));
+            if (0 != std::memcmp(header.magic, MAGIC, sizeof(MAGIC))
+                || CatalogSnapshot::FORMAT_VERSION != header.version
+                || BYTE_ORDER_MARK != header.byteOrderMark
+                || quint32(kind) != header.kind
+                || columnCount != header.columnCount
+                || source.sourceSize != header.sourceSize
+                || source.sourceLastModified != header.sourceLastModified
+                || header.entryCount < 0 || header.nameLength < 0) {
+                return false;
+            }
+
+            // Check sizes (guarding against overflow from corrupt counts) and that names stay in bounds
+            if (header.entryCount > fileSize / qint64(sizeof(double))
+                || header.nameLength > fileSize / qint64(sizeof(QChar))) {
+                return false;
+            }
+            const qint64 columnSize = alignedSize(header.entryCount * qint64(sizeof(double)));
+            const qint64 offsetsStart = qint64(sizeof(Header)) + header.columnCount * columnSize;
+            const qint64 namesStart = offsetsStart + alignedSize((header.entryCount + 1) * qint64(sizeof(qint64)));
+            if (namesStart + header.nameLength * qint64(sizeof(QChar)) > fileSize) return false;
+
+            nameOffsets = reinterpret_cast<const qint64*>(data + offsetsStart);
+            names = reinterpret_cast<const QChar*>(data + namesStart);
+            if (0 != nameOffsets[0] || header.nameLength != nameOffsets[header.entryCount]) return false;
+            for (qint64 i = 0; i < header.entryCount; ++i) {
+                if (nameOffsets[i] > nameOffsets[i + 1]) return false;
+            }
+            return true;
+        }
+
+        qsizetype size() const {
+            return header.entryCount;
+        }
+
+        QStringView name(qsizetype index) const {
+            return QStringView(names + nameOffsets[index], nameOffsets[index + 1] - nameOffsets[index]);
+        }
+
+        QStringList nameList() const {
+            QStringList nameList;
+            nameList.reserve(size());
+            for (qsizetype i = 0; i < size(); ++i) nameList.append(name(i).toString());
+            return nameList;
+        }
+
+        std::span<const double> column(int column) const {
+            return std::span(
+                reinterpret_cast<const double*>(
+                    data + sizeof(Header) + column * alignedSize(header.entryCount * qint64(sizeof(double)))
+                    ),
+                size()
+                );
+        }
+
+    private:
+        QFile file;
+        const uchar* data = nullptr;
+        Header header = {};
+        const qint64* nameOffsets = nullptr;
+        const QChar* names = nullptr;
+    };
+}
+
+QString CatalogSnapshot::snapshotFileName(const QString& catalogFileName) {
+    return catalogFileName + ".sscat";
+}
+
+bool CatalogSnapshot::writePlanets(const QString& catalogFileName, const SolarSystem& planets) {
+    const std::array<std::span<const double>, PLANET_COLUMN_COUNT> columns = {
+        planets.massesInKilograms(),
+        planets.radiiInMetres()
+    };
+    return writeSnapshot(
+        catalogFileName, Kind::PLANETS, planets.size(),
+        [&](qsizetype index) -> const QString& { return planets.getName(index); },
+        columns
+        );
+}
+
+bool CatalogSnapshot::readPlanets(const QString& catalogFileName, SolarSystem& planets) {
+    MappedSnapshot snapshot;
+    if (!snapshot.open(catalogFileName, Kind::PLANETS, PLANET_COLUMN_COUNT)) return false;
+
+    planets.appendPlanets(snapshot.nameList(), snapshot.column(MASS_IN_KILOGRAMS), snapshot.column(RADIUS_IN_METRES));
+    return true;
+}
+
+bool CatalogSnapshot::writeOrbitalData(const QString& catalogFileName, const OrbitalDataColumns& orbits) {
+    const std::array<std::span<const double>, ORBITAL_COLUMN_COUNT> columns = {
+        orbits.orbitalPeriodsInDays,
+        orbits.orbitalRadiiInAU,
+        orbits.eccentricities,
+        orbits.argumentsOfPeriapsisInDegrees,
+        orbits.epochsInDays
+    };
+    return writeSnapshot(
+        catalogFileName, Kind::ORBITAL_DATA, orbits.size(),
+        [&](qsizetype index) -> const QString& { return orbits.names[index]; },
+        columns
+        );
+}
+
+bool CatalogSnapshot::readOrbitalData(const QString& catalogFileName, OrbitalDataColumns& orbits) {
+    MappedSnapshot snapshot;
+    if (!snapshot.open(catalogFileName, Kind::ORBITAL_DATA, ORBITAL_COLUMN_COUNT)) return false;
+
+    orbits.names.append(snapshot.nameList());
+    const auto appendColumn = [&](AlignedVector<double>& column, int snapshotColumn) {
+        const std::span<const double> values = snapshot.column(snapshotColumn);
+        column.insert(column.end(), values.begin(), values.end());
+    };
+    appendColumn(orbits.orbitalPeriodsInDays, ORBITAL_PERIOD_IN_DAYS);
+    appendColumn(orbits.orbitalRadiiInAU, ORBITAL_RADIUS_IN_AU);
+    appendColumn(orbits.eccentricities, ECCENTRICITY);
+    appendColumn(orbits.argumentsOfPeriapsisInDegrees, ARGUMENT_OF_PERIAPSIS_IN_DEGREES);
+    appendColumn(orbits.epochsInDays, EPOCH_IN_DAYS);
+    return true;
+}
@@ -0,0 +1,64 @@
+#ifndef CATALOGSNAPSHOT_H
+#define CATALOGSNAPSHOT_H
+
+#include "solarsystem.h"
+
+#include <QList>
+#include <QString>
+
+/**
+ * Binary snapshots of catalog files, saved next to them (as "<catalog
+ * file>.sscat") after they were loaded without problems, so that later
+ * loads of the same, unchanged file can skip parsing altogether.
+ *
+ * Snapshots hold already-resolved values (masses and radii in SI units,
+ * orbital data in days, AU and degrees) column-wise, one 64-byte-aligned
+ * array of doubles per characteristic, plus a table of the names as
+ * UTF-16. They are memory-mapped when read and copied straight out, with
+ * no per-field decoding.
+ *
+ * A snapshot is only used if its format version, byte order and kind of
+ * catalog match, and if the catalog file still has the size and
+ * modification time it had when the snapshot was taken. Otherwise (or if
+ * a snapshot cannot be written, e.g. in a read-only directory) catalogs
+ * are just parsed as usual.
+ */
+namespace CatalogSnapshot {
+    /**
+     * Version of the snapshot format; snapshots of other versions are ignored.
+     */
+    constexpr quint32 FORMAT_VERSION = 1;
+
+    /**
+     * Name of the snapshot file for the given catalog file.
+     */
+    QString snapshotFileName(const QString& catalogFileName);
+
+    /**
+     * Saves the planets (names, masses and radii) read from the given planet
+     * data file. Returns whether the snapshot could be written.
+     */
+    bool writePlanets(const QString& catalogFileName, const SolarSystem& planets);
+
+    /**
+     * Appends the planets of the snapshot of the given planet data file to
+     * `planets`. Returns false (leaving `planets` unchanged) if there is no
+     * usable snapshot.
+     */
+    bool readPlanets(const QString& catalogFileName, SolarSystem& planets);
+
+    /**
+     * Saves the orbits read from the given orbital data file. Returns whether
+     * the snapshot could be written.
+     */
+    bool writeOrbitalData(const QString& catalogFileName, const OrbitalDataColumns& orbits);
+
+    /**
+     * Appends the orbits of the snapshot of the given orbital data file to
+     * `orbits`. Returns false (leaving `orbits` unchanged) if there is no
+     * usable snapshot.
+     */
+    bool readOrbitalData(const QString& catalogFileName, OrbitalDataColumns& orbits);
+}
+
+#endif // CATALOGSNAPSHOT_H
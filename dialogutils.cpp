@@ -1,9 +1,36 @@
 #include "dialogutils.h"
+#include "measurementunits.h"
 
 #include <QMessageBox>
+#include <QStringList>
 
 namespace DialogUtils {
     void showError(const QString& message) {
         QMessageBox::critical(nullptr, "Error", message);
     }
+
+    QString formatTime(const double timeInSeconds) {
+        static const int SECONDS_PER_DAY = TimeUnit::convert(1, TimeUnit::DAYS, TimeUnit::SECONDS);
+        static const int SECONDS_PER_HOUR = TimeUnit::convert(1, TimeUnit::HOURS, TimeUnit::SECONDS);
+        static const int SECONDS_PER_MINUTE = TimeUnit::convert(1, TimeUnit::MINUTES, TimeUnit::SECONDS);
+
+        double remainingSeconds = timeInSeconds;
+
+        int days = (int)(remainingSeconds / SECONDS_PER_DAY);
+        remainingSeconds -= days * SECONDS_PER_DAY;
+
+        int hours = (int)(remainingSeconds / SECONDS_PER_HOUR);
+        remainingSeconds -= hours * SECONDS_PER_HOUR;
+
+        int minutes = (int)(remainingSeconds / SECONDS_PER_MINUTE);
+        remainingSeconds -= minutes * SECONDS_PER_MINUTE;
+
+        QStringList fragments;
+        if (days) fragments.append(QString("%1 d").arg(days));
+        if (hours) fragments.append(QString("%1 h").arg(hours));
+        if (minutes) fragments.append(QString("%1 m").arg(minutes));
+        if (remainingSeconds) fragments.append(QString("%1 s").arg(remainingSeconds));
+
+        return fragments.join(' ');
+    }
 }
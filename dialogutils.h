@@ -5,6 +5,12 @@
 
 namespace DialogUtils {
     void showError(const QString& message);
+
+    /**
+     * Formats a duration given in seconds as days, hours,
+     * minutes and seconds, e.g. "2 d 3 h 15 s".
+     */
+    QString formatTime(const double timeInSeconds);
 }
 
 #endif // DIALOGUTILS_H
@@ -0,0 +1,220 @@
+#include "ephemeriscache.h"
+#include "orbitalmath.h"
+#include "planet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+    constexpr int COEFFICIENTS = EphemerisCache::COEFFICIENTS_PER_SEGMENT;
+
+    // Fitted per segment: unwrapped angular position, x, y
+    constexpr int CHANNELS = 3;
+
+    // Sampled per segment: the interpolation nodes, then the points where
+    // the fit is checked (both ends, and midway between consecutive nodes)
+    constexpr int SAMPLES_PER_SEGMENT = 2 * COEFFICIENTS + 1;
+
+    // First segment length tried, as a fraction of the orbital period
+    constexpr int INITIAL_SEGMENTS_PER_ORBIT = 4;
+
+    struct ChebyshevSamples {
+        double positions[SAMPLES_PER_SEGMENT]; // In [-1, 1]
+        double polynomials[COEFFICIENTS][COEFFICIENTS]; // T_j(node k)
+    };
+
+    const ChebyshevSamples& chebyshevSamples() {
+        static const ChebyshevSamples samples = []() {
+            ChebyshevSamples result;
+
+            // Chebyshev nodes, in increasing order (so that days increase along them)
+            for (int k = 0; k < COEFFICIENTS; ++k) {
+                const double angle = std::numbers::pi * (COEFFICIENTS - k - 0.5) / COEFFICIENTS;
+                result.positions[k] = std::cos(angle);
+                for (int j = 0; j < COEFFICIENTS; ++j) result.polynomials[j][k] = std::cos(j * angle);
+            }
+
+            // Checkpoints
+            result.positions[COEFFICIENTS] = -1;
+            for (int k = 0; k + 1 < COEFFICIENTS; ++k) {
+                result.positions[COEFFICIENTS + 1 + k] = (result.positions[k] + result.positions[k + 1]) / 2;
+            }
+            result.positions[SAMPLES_PER_SEGMENT - 1] = 1;
+
+            return result;
+        }();
+        return samples;
+    }
+
+    /**
+     * Evaluates a Chebyshev series at `u` (in [-1, 1]) with Clenshaw's recurrence.
+     */
+    double clenshaw(const double* coefficients, double u) {
+        double next = 0;
+        double afterNext = 0;
+        for (int j = COEFFICIENTS - 1; j >= 1; --j) {
+            const double current = 2 * u * next - afterNext + coefficients[j];
+            afterNext = next;
+            next = current;
+        }
+        return u * next - afterNext + coefficients[0];
+    }
+}
+
+EphemerisCache::EphemerisCache(const EphemerisCache& other) {
+    reset(other.fits.size(), other.startDay, other.endDay, other.toleranceInAU);
+}
+
+EphemerisCache& EphemerisCache::operator=(const EphemerisCache& other) {
+    if (this != &other) reset(other.fits.size(), other.startDay, other.endDay, other.toleranceInAU);
+    return *this;
+}
+
+void EphemerisCache::reset(qsizetype planetCount, double startDay, double endDay, double toleranceInAU) {
+    this->startDay = startDay;
+    this->endDay = endDay;
+    this->toleranceInAU = toleranceInAU;
+    fits.assign(planetCount, PlanetFit());
+    fitted = std::make_unique<std::once_flag[]>(planetCount);
+}
+
+double EphemerisCache::getStartDay() const {
+    return startDay;
+}
+
+double EphemerisCache::getEndDay() const {
+    return endDay;
+}
+
+double EphemerisCache::getToleranceInAU() const {
+    return toleranceInAU;
+}
+
+bool EphemerisCache::covers(const Planet& planet, double firstDay, double lastDay) const {
+    // In either order
+    return nullptr != fitCovering(planet, std::min(firstDay, lastDay)) && std::max(firstDay, lastDay) <= endDay;
+}
+
+std::optional<double> EphemerisCache::angularPosition(const Planet& planet, double day) const {
+    const PlanetFit* planetFit = fitCovering(planet, day);
+    if (nullptr == planetFit) return std::nullopt;
+
+    const auto [coefficients, u] = segmentAt(*planetFit, day);
+
+    // The fit is of the unwrapped angle, so bring it back to 0-360°
+    double angularPosition = std::fmod(clenshaw(coefficients, u), 360.0);
+    if (angularPosition < 0) angularPosition += 360.0;
+    return angularPosition;
+}
+
+std::optional<std::pair<double, double>> EphemerisCache::position(const Planet& planet, double day) const {
+    const PlanetFit* planetFit = fitCovering(planet, day);
+    if (nullptr == planetFit) return std::nullopt;
+
+    const auto [coefficients, u] = segmentAt(*planetFit, day);
+    return std::pair(clenshaw(coefficients + COEFFICIENTS, u), clenshaw(coefficients + 2 * COEFFICIENTS, u));
+}
+
+const EphemerisCache::PlanetFit* EphemerisCache::fitCovering(const Planet& planet, double day) const {
+    // Also rejects NaN days
+    if (!(day >= startDay && day <= endDay)) return nullptr;
+
+    const qsizetype index = planet.getIndex();
+    if (index >= qsizetype(fits.size())) return nullptr;
+
+    std::call_once(fitted[index], [this, &planet, index]() { fits[index] = fit(planet); });
+
+    const PlanetFit& planetFit = fits[index];
+    return std::isnan(planetFit.segmentLengthInDays) ? nullptr : &planetFit;
+}
+
+EphemerisCache::PlanetFit EphemerisCache::fit(const Planet& planet) const {
+    if (!planet.hasOrbitalData() || !(endDay > startDay)) return PlanetFit();
+
+    const ChebyshevSamples& samples = chebyshevSamples();
+    const double span = endDay - startDay;
+    const double orbitalPeriod = planet.getOrbitalPeriodInDays().value();
+
+    std::vector<double> days;
+    std::vector<double> angularPositions;
+    std::vector<double> x;
+    std::vector<double> y;
+
+    for (double segmentLength = std::min(span, orbitalPeriod / INITIAL_SEGMENTS_PER_ORBIT); ; segmentLength /= 2) {
+        const qsizetype segmentCount = qsizetype(std::ceil(span / segmentLength));
+        if (segmentCount > MAXIMUM_SEGMENTS_PER_PLANET) return PlanetFit();
+
+        // Compute the exact positions at all samples in one batch
+        const qsizetype sampleCount = segmentCount * SAMPLES_PER_SEGMENT;
+        days.resize(sampleCount);
+        angularPositions.resize(sampleCount);
+        x.resize(sampleCount);
+        y.resize(sampleCount);
+        for (qsizetype segment = 0; segment < segmentCount; ++segment) {
+            const double segmentStart = startDay + segment * segmentLength;
+            for (int k = 0; k < SAMPLES_PER_SEGMENT; ++k) {
+                days[segment * SAMPLES_PER_SEGMENT + k] = segmentStart + (samples.positions[k] + 1) * segmentLength / 2;
+            }
+        }
+        OrbitalMath::orbitalPositionsAfterDays(planet, days, angularPositions, x, y);
+
+        PlanetFit planetFit;
+        planetFit.segmentLengthInDays = segmentLength;
+        planetFit.segmentCount = segmentCount;
+        planetFit.coefficients.assign(segmentCount * CHANNELS * COEFFICIENTS, 0);
+
+        bool withinTolerance = true;
+        for (qsizetype segment = 0; segment < segmentCount && withinTolerance; ++segment) {
+            const qsizetype firstSample = segment * SAMPLES_PER_SEGMENT;
+
+            // Unwrap the angular positions at the nodes (planets only move forward),
+            // so that the fitted curve does not jump from 360° back to 0°
+            double unwrappedAngularPositions[COEFFICIENTS];
+            unwrappedAngularPositions[0] = angularPositions[firstSample];
+            for (int k = 1; k < COEFFICIENTS; ++k) {
+                const double step = std::fmod(angularPositions[firstSample + k] - angularPositions[firstSample + k - 1] + 360.0, 360.0);
+                unwrappedAngularPositions[k] = unwrappedAngularPositions[k - 1] + step;
+            }
+
+            // Interpolate at the nodes: c_j = (2 / n) * Σ f(node k) * T_j(node k), halved for j = 0
+            double* coefficients = planetFit.coefficients.data() + segment * CHANNELS * COEFFICIENTS;
+            const double* channelValues[CHANNELS] = { unwrappedAngularPositions, x.data() + firstSample, y.data() + firstSample };
+            for (int channel = 0; channel < CHANNELS; ++channel) {
+                for (int j = 0; j < COEFFICIENTS; ++j) {
+                    double sum = 0;
+                    for (int k = 0; k < COEFFICIENTS; ++k) sum += channelValues[channel][k] * samples.polynomials[j][k];
+                    coefficients[channel * COEFFICIENTS + j] = (0 == j ? 1.0 : 2.0) * sum / COEFFICIENTS;
+                }
+            }
+
+            // Check the fit between the nodes; angular errors count as the
+            // distance they amount to at the planet's distance from the sun
+            for (int k = COEFFICIENTS; k < SAMPLES_PER_SEGMENT; ++k) {
+                const qsizetype sample = firstSample + k;
+                const double u = samples.positions[k];
+
+                const double angularError = std::remainder(clenshaw(coefficients, u) - angularPositions[sample], 360.0);
+                const double positionError = std::hypot(clenshaw(coefficients + COEFFICIENTS, u) - x[sample],
+                                                        clenshaw(coefficients + 2 * COEFFICIENTS, u) - y[sample]);
+                const double error = std::max(positionError, std::hypot(x[sample], y[sample]) * std::abs(angularError) * std::numbers::pi / 180.0);
+
+                if (!(error <= toleranceInAU)) {
+                    withinTolerance = false;
+                    break;
+                }
+            }
+        }
+
+        if (withinTolerance) return planetFit;
+    }
+}
+
+std::pair<const double*, double> EphemerisCache::segmentAt(const PlanetFit& planetFit, double day) const {
+    // Clamped, since rounding can put the very end of the span one segment too far
+    const qsizetype segment = std::min(qsizetype((day - startDay) / planetFit.segmentLengthInDays), planetFit.segmentCount - 1);
+    const double segmentStart = startDay + segment * planetFit.segmentLengthInDays;
+    const double u = 2 * (day - segmentStart) / planetFit.segmentLengthInDays - 1;
+
+    return { planetFit.coefficients.data() + segment * CHANNELS * COEFFICIENTS, u };
+}
@@ -0,0 +1,125 @@
+#ifndef EPHEMERISCACHE_H
+#define EPHEMERISCACHE_H
+
+#include "alignedvector.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <utility>
+#include <vector>
+
+class Planet;
+
+/**
+ * Cache of planet positions over a span of time, so that positions that
+ * are queried over and over (e.g. by collision checks) can be found with a
+ * few multiply-adds instead of solving Kepler's equation every time.
+ *
+ * For each planet, the span is cut into segments of equal length, and the
+ * planet's (unwrapped) angular position and cartesian coordinates over each
+ * segment are approximated by Chebyshev polynomials, interpolated at the
+ * Chebyshev nodes of the segment. Segments are halved until the fit is
+ * within the tolerance everywhere between the nodes.
+ *
+ * Planets are only fitted the first time they are queried (safely so from
+ * any number of threads). Planets lacking orbital data, or needing more
+ * than `MAXIMUM_SEGMENTS_PER_PLANET` segments, are not cached, and neither
+ * are days outside the span; queries for those return nothing, and the
+ * caller should compute the position itself.
+ */
+class EphemerisCache
+{
+public:
+    /**
+     * Number of Chebyshev coefficients (i.e. degree + 1) per segment.
+     */
+    static constexpr int COEFFICIENTS_PER_SEGMENT = 13;
+
+    /**
+     * Largest number of segments we are willing to fit per planet
+     * (312 bytes each).
+     */
+    static constexpr qsizetype MAXIMUM_SEGMENTS_PER_PLANET = qsizetype(1) << 14;
+
+    /**
+     * Default position accuracy, in AU (about 150 m).
+     */
+    static constexpr double DEFAULT_TOLERANCE_IN_AU = 1e-9;
+
+    /**
+     * Default length of the cached span, in days (a century).
+     */
+    static constexpr double DEFAULT_SPAN_IN_DAYS = 36525;
+
+    EphemerisCache() = default;
+
+    // Copies keep the span and tolerance, but fit their planets anew
+    EphemerisCache(const EphemerisCache& other);
+    EphemerisCache& operator=(const EphemerisCache& other);
+
+    /**
+     * Discards all fits and sets up the cache for `planetCount` planets,
+     * over the days from `startDay` to `endDay`, with positions accurate
+     * to within `toleranceInAU` (angular positions to within the angle that
+     * spans that distance at the planet's distance from the sun).
+     */
+    void reset(qsizetype planetCount, double startDay, double endDay, double toleranceInAU = DEFAULT_TOLERANCE_IN_AU);
+
+    double getStartDay() const;
+    double getEndDay() const;
+    double getToleranceInAU() const;
+
+    /**
+     * Whether all days from `firstDay` to `lastDay` are cached for the planet.
+     */
+    bool covers(const Planet& planet, double firstDay, double lastDay) const;
+
+    /**
+     * Angular position (in degrees, in [0°, 360°)) of the planet at the
+     * given day, as `OrbitalMath::angularPositionAfterDays` would compute
+     * it from the planet's orbital elements. Nothing if not cached.
+     */
+    std::optional<double> angularPosition(const Planet& planet, double day) const;
+
+    /**
+     * Cartesian coordinates (in AU, see `OrbitalMath::polarToCartesianCoordinates`)
+     * of the planet at the given day. Nothing if not cached.
+     */
+    std::optional<std::pair<double, double>> position(const Planet& planet, double day) const;
+
+private:
+    struct PlanetFit {
+        double segmentLengthInDays = NAN; // NaN if the planet is not cached
+        qsizetype segmentCount = 0;
+
+        // Per segment: coefficients of the angular position, then of x, then of y
+        AlignedVector<double> coefficients;
+    };
+
+    double startDay = 0;
+    double endDay = 0;
+    double toleranceInAU = DEFAULT_TOLERANCE_IN_AU;
+
+    // One fit per planet, each made on first use
+    mutable std::vector<PlanetFit> fits;
+    mutable std::unique_ptr<std::once_flag[]> fitted;
+
+    /**
+     * The planet's fit (made now if needed), or nullptr if the day is not cached.
+     */
+    const PlanetFit* fitCovering(const Planet& planet, double day) const;
+
+    PlanetFit fit(const Planet& planet) const;
+
+    /**
+     * Coefficients of the segment containing `day`, and where the day lies
+     * within it (from -1 at its start to 1 at its end).
+     */
+    std::pair<const double*, double> segmentAt(const PlanetFit& planetFit, double day) const;
+};
+
+#endif // EPHEMERISCACHE_H
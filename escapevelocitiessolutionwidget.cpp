@@ -3,6 +3,9 @@
 
 #include "orbitalmath.h"
 
+#include <numeric>
+#include <vector>
+
 EscapeVelocitiesSolutionWidget::EscapeVelocitiesSolutionWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::EscapeVelocitiesSolutionWidget)
@@ -22,22 +25,52 @@ EscapeVelocitiesSolutionWidget::~EscapeVelocitiesSolutionWidget()
     delete ui;
 }
 
-void EscapeVelocitiesSolutionWidget::setPlanets(const QList<Planet>& newPlanets) {
+void EscapeVelocitiesSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
     // We could store the data if needed, but we don't do anything with it aside display this table
 
     // Clear table, re-set-up header row
     escapeVelocitiesTableModel->clear();
     escapeVelocitiesTableModel->setHorizontalHeaderLabels({"Name", "Escape Velocity"});
-    escapeVelocitiesTableModel->setRowCount(newPlanets.length());
+    escapeVelocitiesTableModel->setRowCount(newPlanets.size());
 
-    // Populate table
-    for (int i = 0; i < newPlanets.length(); ++i) {
-        const Planet& planet = newPlanets[i];
+    QList<qsizetype> rows(newPlanets.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    updateEscapeVelocityRows(newPlanets, rows);
+}
+
+void EscapeVelocitiesSolutionWidget::updatePlanets(const SolarSystem& newPlanets, const PlanetChangeSet& changes) {
+    // Start over if the table does not show the planets from before the change
+    if (escapeVelocitiesTableModel->rowCount() != newPlanets.size() - changes.added.size() + changes.removed.size()) {
+        setPlanets(newPlanets);
+        return;
+    }
+
+    // Drop the rows of removed planets, last first so that the other indices still hold
+    for (auto removed = changes.removed.crbegin(); removed != changes.removed.crend(); ++removed) {
+        escapeVelocitiesTableModel->removeRow(int(*removed));
+    }
+    escapeVelocitiesTableModel->setRowCount(newPlanets.size());
+
+    updateEscapeVelocityRows(newPlanets, changes.modified + changes.added);
+}
 
-        escapeVelocitiesTableModel->setData(escapeVelocitiesTableModel->index(i, 0),
-                                            planet.getName());
-        escapeVelocitiesTableModel->setData(escapeVelocitiesTableModel->index(i, 1),
-                                            QString("%1 m/s").arg(OrbitalMath::escapeVelocity(planet)));
+void EscapeVelocitiesSolutionWidget::updateEscapeVelocityRows(const SolarSystem& newPlanets, const QList<qsizetype>& rows) {
+    // Gather the planets of these rows, and compute their escape velocities in one batch
+    std::vector<double> masses(rows.size());
+    std::vector<double> radii(rows.size());
+    for (qsizetype k = 0; k < rows.size(); ++k) {
+        masses[k] = newPlanets.getMassInKilograms(rows[k]);
+        radii[k] = newPlanets.getRadiusInMetres(rows[k]);
+    }
+    std::vector<double> escapeVelocities(rows.size());
+    OrbitalMath::escapeVelocities(masses, radii, escapeVelocities);
+
+    // Populate table
+    for (qsizetype k = 0; k < rows.size(); ++k) {
+        escapeVelocitiesTableModel->setData(escapeVelocitiesTableModel->index(rows[k], 0),
+                                            newPlanets.getName(rows[k]));
+        escapeVelocitiesTableModel->setData(escapeVelocitiesTableModel->index(rows[k], 1),
+                                            QString("%1 m/s").arg(escapeVelocities[k]));
     }
 
     // Hide or display table as needed
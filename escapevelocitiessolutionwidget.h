@@ -1,7 +1,7 @@
 #ifndef ESCAPEVELOCITIESSOLUTIONWIDGET_H
 #define ESCAPEVELOCITIESSOLUTIONWIDGET_H
 
-#include "planet.h"
+#include "solarsystem.h"
 
 #include <QWidget>
 #include <QStandardItemModel>
@@ -19,11 +19,19 @@ public:
     ~EscapeVelocitiesSolutionWidget();
 
 public slots:
-    void setPlanets(const QList<Planet>& newPlanets);
+    void setPlanets(const SolarSystem& newPlanets);
+
+    /**
+     * Like `setPlanets`, but only recomputes the rows of the planets that
+     * changed since the last call.
+     */
+    void updatePlanets(const SolarSystem& newPlanets, const PlanetChangeSet& changes);
 
 private:
     Ui::EscapeVelocitiesSolutionWidget *ui;
     QStandardItemModel* escapeVelocitiesTableModel;
+
+    void updateEscapeVelocityRows(const SolarSystem& newPlanets, const QList<qsizetype>& rows);
 };
 
 #endif // ESCAPEVELOCITIESSOLUTIONWIDGET_H
@@ -12,6 +12,8 @@ MainWindow::MainWindow(QWidget *parent)
 
     connect(ui->planetsWidget, &PlanetsWidget::planetsChanged,
             ui->solutionWidget, &SolutionWidget::setPlanets);
+    connect(ui->planetsWidget, &PlanetsWidget::planetsUpdated,
+            ui->solutionWidget, &SolutionWidget::updatePlanets);
     connect(ui->rocketWidget, &RocketWidget::rocketChanged,
             ui->solutionWidget, &SolutionWidget::setRocket);
 }
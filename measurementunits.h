@@ -2,74 +2,226 @@
 #define MEASUREMENTUNITS_H
 
 #include <QString>
+#include <QStringView>
+
+#include <array>
+#include <bit>
+#include <cmath>
+#include <string_view>
 
 // TODO: maybe this header should be split?
 // E.g. one header for the template, then many small header+cpps for the units?
 
+/**
+ * Perfect-hash table from unit names to the index of their unit in a
+ * unit family, built at compile time (see `UnitType::parse`).
+ *
+ * Holds the abbreviations, then the names, then the abbreviations with
+ * superscripts spelled out (e.g. "m/s^2" for "m/s²"), case-folded, with
+ * earlier keys winning over later identical ones. The hash seed is
+ * searched for until every key lands in a slot of its own, so a lookup
+ * is one hash and one comparison, without allocating.
+ *
+ * Case folding is limited to ASCII letters, which is all unit names use.
+ */
+template <std::size_t UnitCount>
+class UnitLookupTable {
+private:
+    static constexpr std::size_t MAXIMUM_KEY_LENGTH = 32;
+    static constexpr std::size_t MAXIMUM_KEY_COUNT = 3 * UnitCount;
+    static constexpr std::size_t SLOT_COUNT = std::bit_ceil(2 * MAXIMUM_KEY_COUNT);
+
+    struct Key {
+        std::array<char16_t, MAXIMUM_KEY_LENGTH> text {};
+        std::size_t length = 0;
+        qsizetype unitIndex = -1;
+    };
+
+    std::array<Key, MAXIMUM_KEY_COUNT> keys {};
+    std::size_t keyCount = 0;
+    std::array<qsizetype, SLOT_COUNT> keySlots {}; // Index in `keys`, or -1 for empty slots
+    quint32 seed = 0;
+
+    static constexpr char16_t fold(char16_t character) {
+        return u'A' <= character && character <= u'Z' ? char16_t(character - u'A' + u'a') : character;
+    }
+
+    template <class Character>
+    static constexpr quint32 hash(const Character* text, std::size_t length, quint32 seed) {
+        // FNV-1a over the folded UTF-16 code units
+        quint32 value = 2166136261u ^ (seed * 0x9E3779B9u);
+        for (std::size_t i = 0; i < length; ++i) {
+            value ^= fold(char16_t(text[i]));
+            value *= 16777619u;
+        }
+        return value ^ (value >> 16);
+    }
+
+    static constexpr Key keyFromUtf8(const char* utf8, qsizetype unitIndex) {
+        Key key;
+        key.unitIndex = unitIndex;
+        for (std::size_t i = 0; '\0' != utf8[i];) {
+            const auto lead = static_cast<unsigned char>(utf8[i]);
+            char32_t codePoint;
+            if (lead < 0x80) {
+                codePoint = lead;
+                i += 1;
+            }
+            else if (lead < 0xE0) {
+                codePoint = ((lead & 0x1F) << 6) | (static_cast<unsigned char>(utf8[i + 1]) & 0x3F);
+                i += 2;
+            }
+            else {
+                // Unit names stay within the Basic Multilingual Plane
+                codePoint = ((lead & 0x0F) << 12) | ((static_cast<unsigned char>(utf8[i + 1]) & 0x3F) << 6)
+                            | (static_cast<unsigned char>(utf8[i + 2]) & 0x3F);
+                i += 3;
+            }
+            if (key.length == MAXIMUM_KEY_LENGTH) throw "Unit name too long for the lookup table";
+            key.text[key.length++] = fold(char16_t(codePoint));
+        }
+        return key;
+    }
+
+    static constexpr Key withSpelledOutSuperscripts(const Key& key) {
+        Key spelledOut;
+        spelledOut.unitIndex = key.unitIndex;
+        for (std::size_t i = 0; i < key.length; ++i) {
+            const bool isSuperscript = u'²' == key.text[i] || u'³' == key.text[i];
+            if (spelledOut.length + (isSuperscript ? 2 : 1) > MAXIMUM_KEY_LENGTH) throw "Unit name too long for the lookup table";
+            if (isSuperscript) {
+                spelledOut.text[spelledOut.length++] = u'^';
+                spelledOut.text[spelledOut.length++] = u'²' == key.text[i] ? u'2' : u'3';
+            }
+            else spelledOut.text[spelledOut.length++] = key.text[i];
+        }
+        return spelledOut;
+    }
+
+    constexpr void addKey(const Key& key) {
+        for (std::size_t i = 0; i < keyCount; ++i) {
+            if (std::u16string_view(keys[i].text.data(), keys[i].length) == std::u16string_view(key.text.data(), key.length)) return;
+        }
+        keys[keyCount++] = key;
+    }
+
+public:
+    consteval UnitLookupTable(const std::array<const char*, UnitCount>& abbreviations, const std::array<const char*, UnitCount>& names) {
+        for (std::size_t i = 0; i < UnitCount; ++i) addKey(keyFromUtf8(abbreviations[i], qsizetype(i)));
+        for (std::size_t i = 0; i < UnitCount; ++i) addKey(keyFromUtf8(names[i], qsizetype(i)));
+        for (std::size_t i = 0; i < UnitCount; ++i) {
+            const Key key = keyFromUtf8(abbreviations[i], qsizetype(i));
+            const Key spelledOut = withSpelledOutSuperscripts(key);
+            if (spelledOut.length != key.length) addKey(spelledOut);
+        }
+
+        for (seed = 0; ; ++seed) {
+            if (seed > 0xFFFF) throw "No perfect hash seed found for the unit names";
+            keySlots.fill(-1);
+            bool collided = false;
+            for (std::size_t i = 0; i < keyCount && !collided; ++i) {
+                qsizetype& slot = keySlots[hash(keys[i].text.data(), keys[i].length, seed) % SLOT_COUNT];
+                if (-1 != slot) collided = true;
+                else slot = qsizetype(i);
+            }
+            if (!collided) break;
+        }
+    }
+
+    /**
+     * Returns the index of the unit with the given name (case-insensitive),
+     * or -1 if no unit has that name.
+     */
+    constexpr qsizetype find(QStringView string) const {
+        const std::size_t length = std::size_t(string.size());
+        if (length > MAXIMUM_KEY_LENGTH) return -1;
+
+        const qsizetype slot = keySlots[hash(string.utf16(), length, seed) % SLOT_COUNT];
+        if (-1 == slot) return -1;
+
+        const Key& key = keys[slot];
+        if (key.length != length) return -1;
+        for (std::size_t i = 0; i < length; ++i) {
+            if (key.text[i] != fold(char16_t(string.utf16()[i]))) return -1;
+        }
+        return key.unitIndex;
+    }
+};
+
+/**
+ * Units are literal types: all of them are `constexpr` constants, with their
+ * names kept as UTF-8 literals until they are formatted. Conversions between
+ * units known at compile time (e.g. `DistanceUnit::convert(x, DistanceUnit::AU,
+ * DistanceUnit::METRES)`) fold down to a multiplication by a single constant.
+ */
 template <class DerivedUnit>
 class UnitType {
 protected:
-    QString _name;
-    QString _abbreviation;
+    const char* _name;
+    const char* _abbreviation;
     double _ratioToSIUnit;
 
-    UnitType(QString name, QString abbreviation, double ratioToSIUnit):
+    constexpr UnitType(const char* name, const char* abbreviation, double ratioToSIUnit):
         _name(name),
         _abbreviation(abbreviation),
         _ratioToSIUnit(ratioToSIUnit)
     {}
-    virtual ~UnitType() {}; // Virtual destructor to avoid polymorphic deletion
+    ~UnitType() = default; // Protected (and trivial) to avoid polymorphic deletion
+
+private:
+    static consteval auto lookupTable() {
+        constexpr auto units = DerivedUnit::allValues();
+        std::array<const char*, units.size()> abbreviations;
+        std::array<const char*, units.size()> names;
+        for (std::size_t i = 0; i < units.size(); ++i) {
+            abbreviations[i] = units[i]._abbreviation;
+            names[i] = units[i]._name;
+        }
+        return UnitLookupTable<units.size()>(abbreviations, names);
+    }
 
 public:
-    QString name() const { return _name; }
-    QString abbreviation() const { return _abbreviation; }
+    QString name() const { return QString::fromUtf8(_name); }
+    QString abbreviation() const { return QString::fromUtf8(_abbreviation); }
 
-    static double convert(double value, const DerivedUnit& from, const DerivedUnit& to) {
-        return value * from._ratioToSIUnit / to._ratioToSIUnit;
+    static constexpr double ratio(const DerivedUnit& from, const DerivedUnit& to) {
+        return from._ratioToSIUnit / to._ratioToSIUnit;
     }
 
-    bool operator==(const DerivedUnit& other) const {
-        return static_cast<const DerivedUnit*>(this)->_name == other._name;
-        // Could check abbreviation and ratio as well, but name should be unique
+    static constexpr double convert(double value, const DerivedUnit& from, const DerivedUnit& to) {
+        return value * ratio(from, to);
     }
-    bool operator!=(const DerivedUnit& other) const {
-        return static_cast<const DerivedUnit*>(this)->_name != other._name;
+
+    // Names are compared by content, as literals need not share an address across translation units
+    constexpr bool operator==(const DerivedUnit& other) const {
+        return std::string_view(static_cast<const DerivedUnit*>(this)->_name) == std::string_view(other._name);
         // Could check abbreviation and ratio as well, but name should be unique
     }
+    constexpr bool operator!=(const DerivedUnit& other) const {
+        return !(*this == other);
+    }
 
-    // Call `allValues()` static function of derived class to get all derived-class units
+    // Looks the string up in a table built at compile time from the `allValues()`
+    // static function of derived class (see `UnitLookupTable`)
     // Possibly return `INVALID` static value of derived class for no-matching-unit
-    static DerivedUnit parse(const QString& string, const std::vector<DerivedUnit>& acceptedUnits = DerivedUnit::allValues()) {
-        // Try abbreviations
-        for (DerivedUnit unit : acceptedUnits) {
-            if (0 == string.compare(unit._abbreviation, Qt::CaseInsensitive)) return unit;
-        }
-
-        // Try names
-        for (DerivedUnit unit : acceptedUnits) {
-            if (0 == string.compare(unit._name, Qt::CaseInsensitive)) return unit;
-        }
-
-        // Extra: if above failed, try replacing ^2 and ^3 with superscript ² and ³ and checking abbreviations again
-        QString stringWithReplacements(string);
-        stringWithReplacements.replace("^2", "²").replace("^3", "³");
-        for (DerivedUnit unit : acceptedUnits) {
-            if (0 == stringWithReplacements.compare(unit._abbreviation, Qt::CaseInsensitive)) return unit;
-        }
-
-        // If nothing matched, return invalid
-        return INVALID;
+    static DerivedUnit parse(QStringView string) {
+        static constexpr auto units = DerivedUnit::allValues();
+        static constexpr auto table = lookupTable();
+        const qsizetype unitIndex = table.find(string);
+        return -1 == unitIndex ? INVALID : units[unitIndex];
     }
 
     static const DerivedUnit INVALID;
 };
 template <class DerivedUnit>
-const DerivedUnit UnitType<DerivedUnit>::INVALID("Invalid unit", "invalid", NAN);
+constexpr DerivedUnit UnitType<DerivedUnit>::INVALID("Invalid unit", "invalid", NAN);
 
 
 class DistanceUnit : public UnitType<DistanceUnit> {
 private:
-    DistanceUnit(QString name, QString abbreviation, double ratioToMetres);
+    constexpr DistanceUnit(const char* name, const char* abbreviation, double ratioToMetres):
+        UnitType<DistanceUnit>(name, abbreviation, ratioToMetres)
+    {}
     friend class UnitType<DistanceUnit>; // Needed to allow UnitType to define INVALID
 
 public:
@@ -78,38 +230,80 @@ public:
     static const DistanceUnit FEET;
     static const DistanceUnit MILES;
     static const DistanceUnit AU;
-    static std::vector<DistanceUnit> allValues();
+    static constexpr std::array<DistanceUnit, 5> allValues();
 };
+inline constexpr DistanceUnit DistanceUnit::METRES("Metres", "m", 1.0);
+inline constexpr DistanceUnit DistanceUnit::KILOMETRES("Kilometres", "km", 1000.0);
+inline constexpr DistanceUnit DistanceUnit::FEET("Feet", "ft", 0.3048);
+inline constexpr DistanceUnit DistanceUnit::MILES("Miles", "mi", 1609.344);
+inline constexpr DistanceUnit DistanceUnit::AU("Astronomical units", "AU", 149597870700);
+constexpr std::array<DistanceUnit, 5> DistanceUnit::allValues() {
+    return {
+        DistanceUnit::METRES,
+        DistanceUnit::KILOMETRES,
+        DistanceUnit::FEET,
+        DistanceUnit::MILES,
+        DistanceUnit::AU
+    };
+}
 
 
 class MassUnit : public UnitType<MassUnit> {
 private:
-    MassUnit(QString name, QString abbreviation, double ratioToKilograms);
+    constexpr MassUnit(const char* name, const char* abbreviation, double ratioToKilograms):
+        UnitType<MassUnit>(name, abbreviation, ratioToKilograms)
+    {}
     friend class UnitType<MassUnit>; // Needed to allow UnitType to define INVALID
 
 public:
     static const MassUnit KILOGRAMS;
     static const MassUnit TONNES;
     static const MassUnit EARTHS;
-    static std::vector<MassUnit> allValues();
+    static constexpr std::array<MassUnit, 3> allValues();
 };
+inline constexpr MassUnit MassUnit::KILOGRAMS("Kilograms", "kg", 1.0);
+inline constexpr MassUnit MassUnit::TONNES("Tonnes", "t", 1000.0);
+inline constexpr MassUnit MassUnit::EARTHS("Earths", "Earths", NAN); // Special case, handle based on mass given to Earth in file
+// Arguably maybe 'Earths' should not even be a unit, but instead if some
+// gibberish unit is given we assume it refers to some other planet in the file and
+// compute based on that?
+// Probably not worth the extra logic, though, unless this is likely to be common.
+constexpr std::array<MassUnit, 3> MassUnit::allValues() {
+    return {
+        MassUnit::KILOGRAMS,
+        MassUnit::TONNES,
+        MassUnit::EARTHS
+    };
+}
 
 
 class AccelerationUnit : public UnitType<AccelerationUnit> {
 private:
-    AccelerationUnit(QString name, QString abbreviation, double ratioToMetresPerSecondSquare);
+    constexpr AccelerationUnit(const char* name, const char* abbreviation, double ratioToMetresPerSecondSquare):
+        UnitType<AccelerationUnit>(name, abbreviation, ratioToMetresPerSecondSquare)
+    {}
     friend class UnitType<AccelerationUnit>; // Needed to allow UnitType to define INVALID
 
 public:
     static const AccelerationUnit METERS_PER_SECOND_SQUARE;
     static const AccelerationUnit KILOMETERS_PER_SECOND_SQUARE;
-    static std::vector<AccelerationUnit> allValues();
+    static constexpr std::array<AccelerationUnit, 2> allValues();
 };
+inline constexpr AccelerationUnit AccelerationUnit::METERS_PER_SECOND_SQUARE("Meters per second square", "m/s²", 1.0);
+inline constexpr AccelerationUnit AccelerationUnit::KILOMETERS_PER_SECOND_SQUARE("Kilometers per second square", "km/s²", 1000.0);
+constexpr std::array<AccelerationUnit, 2> AccelerationUnit::allValues() {
+    return {
+        AccelerationUnit::METERS_PER_SECOND_SQUARE,
+        AccelerationUnit::KILOMETERS_PER_SECOND_SQUARE
+    };
+}
 
 
 class TimeUnit : public UnitType<TimeUnit> {
 private:
-    TimeUnit(QString name, QString abbreviation, double ratioToSeconds);
+    constexpr TimeUnit(const char* name, const char* abbreviation, double ratioToSeconds):
+        UnitType<TimeUnit>(name, abbreviation, ratioToSeconds)
+    {}
     friend class UnitType<TimeUnit>; // Needed to allow UnitType to define INVALID
 
 public:
@@ -118,13 +312,29 @@ public:
     static const TimeUnit HOURS;
     static const TimeUnit DAYS;
     static const TimeUnit YEARS;
-    static std::vector<TimeUnit> allValues();
+    static constexpr std::array<TimeUnit, 5> allValues();
 };
+inline constexpr TimeUnit TimeUnit::SECONDS("Seconds", "s", 1.0);
+inline constexpr TimeUnit TimeUnit::MINUTES("Minutes", "m", 60.0);
+inline constexpr TimeUnit TimeUnit::HOURS("Hours", "h", 3600.0);
+inline constexpr TimeUnit TimeUnit::DAYS("Days", "d", 86400.0);
+inline constexpr TimeUnit TimeUnit::YEARS("Years", "y", 31556952.0); // Assuming 365.2425 days per year to account for leap years
+constexpr std::array<TimeUnit, 5> TimeUnit::allValues() {
+    return {
+        TimeUnit::SECONDS,
+        TimeUnit::MINUTES,
+        TimeUnit::HOURS,
+        TimeUnit::DAYS,
+        TimeUnit::YEARS
+    };
+}
 
 
 class SpeedUnit : public UnitType<SpeedUnit> {
 private:
-    SpeedUnit(QString name, QString abbreviation, double ratioToMetresPerSecond);
+    constexpr SpeedUnit(const char* name, const char* abbreviation, double ratioToMetresPerSecond):
+        UnitType<SpeedUnit>(name, abbreviation, ratioToMetresPerSecond)
+    {}
     friend class UnitType<SpeedUnit>; // Needed to allow UnitType to define INVALID
 
 public:
@@ -132,19 +342,41 @@ public:
     static const SpeedUnit KILOMETRES_PER_HOUR;
     static const SpeedUnit MILES_PER_HOUR;
     static const SpeedUnit KILOMETRES_PER_SECOND;
-    static std::vector<SpeedUnit> allValues();
+    static constexpr std::array<SpeedUnit, 4> allValues();
 };
+inline constexpr SpeedUnit SpeedUnit::METRES_PER_SECOND("Metres per second", "m/s", 1.0);
+inline constexpr SpeedUnit SpeedUnit::KILOMETRES_PER_HOUR("Kilometres per hour", "km/h", 0.2778);
+inline constexpr SpeedUnit SpeedUnit::MILES_PER_HOUR("Miles per hour", "mph", 0.447);
+inline constexpr SpeedUnit SpeedUnit::KILOMETRES_PER_SECOND("Kilometres per second", "km/s", 1000.0);
+constexpr std::array<SpeedUnit, 4> SpeedUnit::allValues() {
+    return {
+        SpeedUnit::METRES_PER_SECOND,
+        SpeedUnit::KILOMETRES_PER_HOUR,
+        SpeedUnit::MILES_PER_HOUR,
+        SpeedUnit::KILOMETRES_PER_SECOND
+    };
+}
 
 
 class AngleUnit : public UnitType<AngleUnit> {
 private:
-    AngleUnit(QString name, QString abbreviation, double ratioToDegrees);
+    constexpr AngleUnit(const char* name, const char* abbreviation, double ratioToDegrees):
+        UnitType<AngleUnit>(name, abbreviation, ratioToDegrees)
+    {}
     friend class UnitType<AngleUnit>; // Needed to allow UnitType to define INVALID
 
 public:
     static const AngleUnit DEGREES;
     static const AngleUnit RADIANS;
-    static std::vector<AngleUnit> allValues();
+    static constexpr std::array<AngleUnit, 2> allValues();
 };
+inline constexpr AngleUnit AngleUnit::DEGREES("Degrees", "°", 1.0); // Use degrees as default because application does too
+inline constexpr AngleUnit AngleUnit::RADIANS("Radians", "rad", 57.295779513);
+constexpr std::array<AngleUnit, 2> AngleUnit::allValues() {
+    return {
+        AngleUnit::DEGREES,
+        AngleUnit::RADIANS
+    };
+}
 
 #endif // MEASUREMENTUNITS_H
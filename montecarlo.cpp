@@ -0,0 +1,152 @@
+#include "montecarlo.h"
+#include "orbitalmath.h"
+
+#include <QtConcurrent>
+
+#include <array>
+#include <numbers>
+
+void MonteCarlo::TransferDistribution::merge(const TransferDistribution& other) {
+    sampleCount += other.sampleCount;
+    cruisingVelocities.merge(other.cruisingVelocities);
+    accelerationTimes.merge(other.accelerationTimes);
+    cruisingTimes.merge(other.cruisingTimes);
+    decelerationTimes.merge(other.decelerationTimes);
+    totalTravelTimes.merge(other.totalTravelTimes);
+}
+
+namespace {
+    using Counter = std::array<quint32, 4>;
+
+    /**
+     * Philox4x32-10 (Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3"):
+     * 128 random bits for each (counter, key), with no state in between.
+     */
+    Counter philox(Counter counter, quint64 key) {
+        quint32 key0 = quint32(key);
+        quint32 key1 = quint32(key >> 32);
+        for (int round = 0; round < 10; ++round) {
+            const quint64 product0 = quint64(0xD2511F53) * counter[0];
+            const quint64 product1 = quint64(0xCD9E8D57) * counter[2];
+            counter = {
+                quint32(product1 >> 32) ^ counter[1] ^ key0,
+                quint32(product1),
+                quint32(product0 >> 32) ^ counter[3] ^ key1,
+                quint32(product0)
+            };
+            key0 += 0x9E3779B9;
+            key1 += 0xBB67AE85;
+        }
+        return counter;
+    }
+
+    /**
+     * Four standard normal numbers for the sample, from two Philox blocks
+     * (Box-Muller on each pair of 64-bit uniform numbers).
+     */
+    std::array<double, 4> standardNormals(quint64 seed, qint64 sample) {
+        std::array<double, 4> normals;
+        for (quint32 block = 0; block < 2; ++block) {
+            const Counter bits = philox({ quint32(sample), quint32(quint64(sample) >> 32), block, 0 }, seed);
+
+            // Uniform in (0, 1), so that the logarithm below is finite
+            const double u0 = ((((quint64(bits[0]) << 32) | bits[1]) >> 11) + 0.5) * 0x1p-53;
+            const double u1 = ((((quint64(bits[2]) << 32) | bits[3]) >> 11) + 0.5) * 0x1p-53;
+
+            const double radius = std::sqrt(-2 * std::log(u0));
+            const double angle = 2 * std::numbers::pi * u1;
+            normals[2 * block] = radius * std::cos(angle);
+            normals[2 * block + 1] = radius * std::sin(angle);
+        }
+        return normals;
+    }
+
+    /**
+     * Log-normal factor with mean 1 and the given relative standard deviation.
+     */
+    struct UncertaintyFactor {
+        double sigma;
+        double mu;
+
+        explicit UncertaintyFactor(double tolerance)
+            : sigma(std::sqrt(std::log1p(tolerance * tolerance)))
+            , mu(-sigma * sigma / 2)
+        {}
+
+        double operator()(double standardNormal) const {
+            return 0 == sigma ? 1.0 : std::exp(mu + sigma * standardNormal);
+        }
+    };
+}
+
+MonteCarlo::TransferDistribution
+MonteCarlo::simulateTransfer(
+    const Planet& from, const Planet& to, const Rocket& rocket, const Tolerances& tolerances, qint64 sampleCount,
+    double fromAngularPosition, double toAngularPosition, Days daysElapsed, quint64 seed
+    ) {
+    // Radii are not uncertain, so neither is the distance
+    const double distanceBetweenSurfaces = OrbitalMath::surfaceDistance(from, to, fromAngularPosition, toAngularPosition, daysElapsed).value();
+
+    const double nominalAcceleration = OrbitalMath::totalAcceleration(rocket);
+    const double nominalFromMass = from.getMassInKilograms();
+    const double nominalToMass = to.getMassInKilograms();
+    const double fromRadius = from.getRadiusInMetres();
+    const double toRadius = to.getRadiusInMetres();
+    const UncertaintyFactor accelerationFactor(tolerances.rocketAcceleration);
+    const UncertaintyFactor fromMassFactor(tolerances.fromMass);
+    const UncertaintyFactor toMassFactor(tolerances.toMass);
+
+    // Fixed chunks (whatever the thread count), merged in order
+    QList<qint64> chunkStarts;
+    for (qint64 start = 0; start < sampleCount; start += CHUNK_SIZE) chunkStarts.append(start);
+
+    const auto simulateChunk = [&](qint64 chunkStart) {
+        const qint64 chunkEnd = std::min(chunkStart + CHUNK_SIZE, sampleCount);
+
+        TransferDistribution distribution;
+        distribution.sampleCount = chunkEnd - chunkStart;
+
+        AlignedVector<double> rocketAccelerations(BATCH_SIZE);
+        AlignedVector<double> fromMasses(BATCH_SIZE);
+        AlignedVector<double> toMasses(BATCH_SIZE);
+        AlignedVector<double> fromRadii(BATCH_SIZE, fromRadius);
+        AlignedVector<double> toRadii(BATCH_SIZE, toRadius);
+        AlignedVector<double> fromEscapeVelocities(BATCH_SIZE);
+        AlignedVector<double> toEscapeVelocities(BATCH_SIZE);
+        OrbitalMath::TransferBatch transfers;
+
+        for (qint64 batchStart = chunkStart; batchStart < chunkEnd; batchStart += BATCH_SIZE) {
+            const qsizetype batchSize = qsizetype(std::min<qint64>(BATCH_SIZE, chunkEnd - batchStart));
+
+            for (qsizetype i = 0; i < batchSize; ++i) {
+                const std::array<double, 4> normals = standardNormals(seed, batchStart + i);
+                rocketAccelerations[i] = nominalAcceleration * accelerationFactor(normals[0]);
+                fromMasses[i] = nominalFromMass * fromMassFactor(normals[1]);
+                toMasses[i] = nominalToMass * toMassFactor(normals[2]);
+            }
+
+            const std::span<double> fromVelocities(fromEscapeVelocities.data(), batchSize);
+            const std::span<double> toVelocities(toEscapeVelocities.data(), batchSize);
+            OrbitalMath::escapeVelocities(std::span(fromMasses.data(), batchSize), fromRadii, fromVelocities);
+            OrbitalMath::escapeVelocities(std::span(toMasses.data(), batchSize), toRadii, toVelocities);
+            OrbitalMath::computeTransfers(fromVelocities, toVelocities, rocketAccelerations, distanceBetweenSurfaces, transfers);
+
+            for (qsizetype i = 0; i < batchSize; ++i) {
+                distribution.cruisingVelocities.add(transfers.cruisingVelocities[i]);
+                distribution.accelerationTimes.add(transfers.accelerationTimes[i]);
+                distribution.cruisingTimes.add(transfers.cruisingTimes[i]);
+                distribution.decelerationTimes.add(transfers.decelerationTimes[i]);
+                distribution.totalTravelTimes.add(transfers.totalTravelTimes[i]);
+            }
+        }
+
+        return distribution;
+    };
+
+    return QtConcurrent::blockingMappedReduced<TransferDistribution>(
+        chunkStarts,
+        simulateChunk,
+        [](TransferDistribution& result, const TransferDistribution& chunk) { result.merge(chunk); },
+        QtConcurrent::OrderedReduce
+        );
+}
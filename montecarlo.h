@@ -0,0 +1,93 @@
+#ifndef MONTECARLO_H
+#define MONTECARLO_H
+
+#include "planet.h"
+#include "quantilesketch.h"
+#include "quantity.h"
+#include "rocket.h"
+
+#include <QtGlobal>
+
+#include <cmath>
+
+/**
+ * Monte Carlo estimates of how uncertain transfer results (see
+ * `OrbitalMath::TransferResults`) are, when the rocket's acceleration and
+ * the planets' masses are only known within some tolerance.
+ *
+ * Every sample draws its own rocket acceleration and planet masses, and is
+ * evaluated (in batches, see `OrbitalMath::computeTransfers`) through the
+ * same maths as `OrbitalMath::computeSimpleTransfer`. Results are summed up
+ * in quantile sketches rather than stored, so any number of samples fits in
+ * memory.
+ *
+ * Random numbers come from a counter-based generator (Philox4x32-10): the
+ * numbers of a sample are a function of the seed and the sample's index only,
+ * so each worker thread generates the streams of its own samples without
+ * any shared state. Samples are split into fixed chunks, whose results are
+ * merged in order, so results are the same for any number of threads.
+ */
+namespace MonteCarlo {
+    /**
+     * Number of samples evaluated together through the transfer maths.
+     */
+    constexpr qsizetype BATCH_SIZE = 4096;
+
+    /**
+     * Number of samples per task on the thread pool.
+     */
+    constexpr qint64 CHUNK_SIZE = 16 * BATCH_SIZE;
+
+    constexpr quint64 DEFAULT_SEED = 0x5EED;
+
+    /**
+     * Relative standard deviations (e.g. 0.05 for ±5%) of the uncertain
+     * values, which are drawn from log-normal distributions with the
+     * nominal value as mean (so they stay positive).
+     */
+    struct Tolerances {
+        double rocketAcceleration = 0;
+        double fromMass = 0;
+        double toMass = 0;
+    };
+
+    /**
+     * Distributions of the transfer results over all samples
+     * (in the units of `OrbitalMath::TransferResults`).
+     */
+    struct TransferDistribution {
+        qint64 sampleCount = 0;
+
+        QuantileSketch cruisingVelocities;
+        QuantileSketch accelerationTimes;
+        QuantileSketch cruisingTimes;
+        QuantileSketch decelerationTimes;
+        QuantileSketch totalTravelTimes;
+
+        /**
+         * Adds the samples of the other distribution.
+         */
+        void merge(const TransferDistribution& other);
+    };
+
+    /**
+     * Samples `sampleCount` variations of the transfer computed by
+     * `OrbitalMath::computeSimpleTransfer` (with the same meaning for the
+     * angular positions and `daysElapsed`), on the global thread pool.
+     * Both planets must have orbital data. With all tolerances at zero,
+     * every sample matches `computeSimpleTransfer` exactly.
+     */
+    TransferDistribution simulateTransfer(
+        const Planet& from,
+        const Planet& to,
+        const Rocket& rocket,
+        const Tolerances& tolerances,
+        qint64 sampleCount,
+        double fromAngularPosition = NAN,
+        double toAngularPosition = NAN,
+        Days daysElapsed = Days(0),
+        quint64 seed = DEFAULT_SEED
+        );
+}
+
+#endif // MONTECARLO_H
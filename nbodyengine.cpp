@@ -0,0 +1,73 @@
+#include "nbodyengine.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+
+NBodyEngine::NBodyEngine(QObject *parent)
+    : QObject(parent)
+{
+    connect(&watcher, &QFutureWatcher<void>::progressValueChanged, this, [this](int batchesDone) {
+        emit progressChanged(batchesDone, watcher.progressMaximum());
+    });
+    connect(&watcher, &QFutureWatcher<void>::finished, this, [this]() {
+        if (!watcher.isCanceled()) emit finished();
+    });
+}
+
+NBodyEngine::~NBodyEngine()
+{
+    cancel();
+}
+
+void NBodyEngine::start(NBodySimulation& simulation, double day) {
+    cancel();
+
+    // The simulation only runs forward
+    if (day < simulation.currentDay()) simulation.reset();
+
+    watcher.setFuture(QtConcurrent::run([&simulation, day](QPromise<void>& promise) {
+        const double startDay = simulation.currentDay();
+        const double batchInDays = STEPS_PER_BATCH * simulation.getTimeStepInDays();
+        const qsizetype batchCount = qsizetype(std::ceil((day - startDay) / batchInDays));
+
+        promise.setProgressRange(0, int(batchCount));
+        for (qsizetype batch = 1; batch <= batchCount; ++batch) {
+            if (promise.isCanceled()) return;
+            simulation.advanceTo(std::min(day, startDay + batch * batchInDays));
+            promise.setProgressValue(int(batch));
+        }
+    }));
+}
+
+void NBodyEngine::record(NBodySimulation& simulation, NBodyEphemeris& ephemeris) {
+    cancel();
+
+    watcher.setFuture(QtConcurrent::run([&simulation, &ephemeris](QPromise<void>& promise) {
+        const qsizetype samplesPerBatch = std::max(STEPS_PER_BATCH / NBodyEphemeris::STEPS_PER_SAMPLE, qsizetype(1));
+        const qsizetype firstSample = ephemeris.recordedSampleCount();
+        const qsizetype batchCount = (ephemeris.sampleCount() - firstSample + samplesPerBatch - 1) / samplesPerBatch;
+
+        promise.setProgressRange(0, int(batchCount));
+        for (qsizetype batch = 1; batch <= batchCount; ++batch) {
+            if (promise.isCanceled()) return;
+            const qsizetype lastSample = std::min(ephemeris.sampleCount(), firstSample + batch * samplesPerBatch);
+            while (ephemeris.recordedSampleCount() < lastSample) ephemeris.recordNextSample(simulation);
+            promise.setProgressValue(int(batch));
+        }
+    }));
+}
+
+void NBodyEngine::cancel() {
+    watcher.cancel();
+    watcher.waitForFinished();
+
+    // Also drops the signals of the advance still waiting to be delivered,
+    // in case it finished before it could be cancelled
+    watcher.setFuture(QFuture<void>());
+}
+
+bool NBodyEngine::isRunning() const {
+    return watcher.isRunning();
+}
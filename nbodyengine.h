@@ -0,0 +1,63 @@
+#ifndef NBODYENGINE_H
+#define NBODYENGINE_H
+
+#include "nbodyephemeris.h"
+#include "nbodysimulation.h"
+
+#include <QFutureWatcher>
+#include <QObject>
+
+/**
+ * Advances N-body simulations (see `NBodySimulation`) in the background,
+ * a batch of steps at a time, so that long advances neither freeze the
+ * interface nor have to run to the end once they are no longer wanted.
+ * Can also record them as they go (see `NBodyEphemeris`).
+ */
+class NBodyEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Number of time steps taken between checks for cancellation
+     * (and progress reports).
+     */
+    static constexpr qsizetype STEPS_PER_BATCH = 256;
+
+    explicit NBodyEngine(QObject *parent = nullptr);
+    ~NBodyEngine();
+
+    /**
+     * Starts advancing the simulation to the given day, cancelling any
+     * advance still in progress. The simulation goes on from where it is,
+     * or from time 0 if the day is in its past. It must be left alone until
+     * the advance is finished or cancelled.
+     */
+    void start(NBodySimulation& simulation, double day);
+
+    /**
+     * Starts recording the rest of the ephemeris's samples, cancelling any
+     * advance still in progress. The simulation and ephemeris must be left
+     * alone until the recording is finished or cancelled; a cancelled
+     * recording can be picked up again from where it stopped.
+     */
+    void record(NBodySimulation& simulation, NBodyEphemeris& ephemeris);
+
+    /**
+     * Cancels the advance in progress (if any) and waits for the batch of
+     * steps being taken to be done; the simulation is left wherever it got
+     * to. No signals are emitted for a cancelled advance.
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+signals:
+    void progressChanged(qsizetype batchesDone, qsizetype batchCount);
+    void finished();
+
+private:
+    QFutureWatcher<void> watcher;
+};
+
+#endif // NBODYENGINE_H
@@ -0,0 +1,90 @@
+#include "nbodyephemeris.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    // Values kept per planet and sample: x, y, vx, vy
+    constexpr qsizetype VALUES_PER_SAMPLE = 4;
+}
+
+NBodyEphemeris::NBodyEphemeris(const NBodySimulation& simulation, double spanInDays)
+    : startDay(simulation.currentDay())
+    , sampleInterval(STEPS_PER_SAMPLE * simulation.getTimeStepInDays())
+{
+    // Only simulated planets are recorded
+    recordedIndices.assign(simulation.size(), -1);
+    for (qsizetype i = 0; i < simulation.size(); ++i) {
+        if (!std::isnan(simulation.x()[i])) recordedIndices[i] = recordedPlanetCount++;
+    }
+
+    // Enough samples to reach the end of the span, if we can afford them
+    const qsizetype affordableSamples = recordedPlanetCount > 0
+        ? MAXIMUM_SAMPLED_VALUES / (VALUES_PER_SAMPLE * recordedPlanetCount)
+        : 1;
+    samples = std::clamp(qsizetype(std::ceil(spanInDays / sampleInterval)) + 1, qsizetype(1), std::max(affordableSamples, qsizetype(1)));
+    values.reserve(samples * recordedPlanetCount * VALUES_PER_SAMPLE);
+
+    recordSample(simulation);
+}
+
+qsizetype NBodyEphemeris::sampleCount() const {
+    return samples;
+}
+
+qsizetype NBodyEphemeris::recordedSampleCount() const {
+    return recordedSamples;
+}
+
+double NBodyEphemeris::getSampleIntervalInDays() const {
+    return sampleInterval;
+}
+
+void NBodyEphemeris::recordNextSample(NBodySimulation& simulation) {
+    if (recordedSamples >= samples) return;
+
+    simulation.advanceTo(startDay + recordedSamples * sampleInterval);
+    recordSample(simulation);
+}
+
+void NBodyEphemeris::recordSample(const NBodySimulation& simulation) {
+    const std::span<const double> x = simulation.x(), y = simulation.y();
+    const std::span<const double> vx = simulation.vx(), vy = simulation.vy();
+
+    for (qsizetype i = 0; i < qsizetype(recordedIndices.size()); ++i) {
+        if (-1 == recordedIndices[i]) continue;
+        values.insert(values.end(), { x[i], y[i], vx[i], vy[i] });
+    }
+    ++recordedSamples;
+}
+
+bool NBodyEphemeris::covers(qsizetype planetIndex, Days firstDay, Days lastDay) const {
+    return planetIndex >= 0 && planetIndex < qsizetype(recordedIndices.size())
+           && -1 != recordedIndices[planetIndex]
+           && firstDay.value() >= startDay
+           && lastDay.value() <= startDay + (recordedSamples - 1) * sampleInterval;
+}
+
+std::optional<std::pair<double, double>> NBodyEphemeris::position(qsizetype planetIndex, Days day) const {
+    if (!covers(planetIndex, day, day)) return std::nullopt;
+
+    // Samples on either side of the day, and where the day lies between them (from 0 to 1)
+    const double samplePosition = (day.value() - startDay) / sampleInterval;
+    const qsizetype sample = std::clamp(qsizetype(samplePosition), qsizetype(0), std::max(recordedSamples - 2, qsizetype(0)));
+    const double s = samplePosition - sample;
+
+    const double* first = values.data() + (sample * recordedPlanetCount + recordedIndices[planetIndex]) * VALUES_PER_SAMPLE;
+    if (1 == recordedSamples) return std::pair(first[0], first[1]);
+    const double* second = first + recordedPlanetCount * VALUES_PER_SAMPLE;
+
+    // Cubic Hermite basis, with the velocities scaled to the sample interval
+    const double h00 = (1 + 2 * s) * (1 - s) * (1 - s);
+    const double h10 = s * (1 - s) * (1 - s) * sampleInterval;
+    const double h01 = s * s * (3 - 2 * s);
+    const double h11 = s * s * (s - 1) * sampleInterval;
+
+    return std::pair(
+        h00 * first[0] + h10 * first[2] + h01 * second[0] + h11 * second[2],
+        h00 * first[1] + h10 * first[3] + h01 * second[1] + h11 * second[3]
+        );
+}
@@ -0,0 +1,94 @@
+#ifndef NBODYEPHEMERIS_H
+#define NBODYEPHEMERIS_H
+
+#include "alignedvector.h"
+#include "nbodysimulation.h"
+#include "positionsource.h"
+
+#include <QtGlobal>
+
+#include <vector>
+
+/**
+ * Planet positions recorded from an N-body simulation (see `NBodySimulation`),
+ * so that they can stand in for the Keplerian model everywhere (see
+ * `PositionSource`) without running the simulation again for every query.
+ *
+ * The simulation is sampled every `STEPS_PER_SAMPLE` time steps, keeping the
+ * position and velocity of each simulated planet; positions in between are
+ * interpolated with cubic Hermite polynomials, which match both at either
+ * end. With the default time step, that is 64 samples per orbit of the
+ * fastest planet, and an interpolation error of about 1e-7 of its orbital
+ * radius (some 15 km for Mercury).
+ *
+ * Samples are taken one at a time with `recordNextSample` (see
+ * `NBodyEngine::record` to do so in the background), and cover days from
+ * the simulation's starting day onwards, up to the span asked for or as
+ * far as `MAXIMUM_SAMPLED_VALUES` lets them for large solar systems. Planets
+ * lacking orbital data are not covered, as they take no part in the simulation.
+ */
+class NBodyEphemeris : public PositionSource
+{
+public:
+    /**
+     * Number of simulation time steps between two samples.
+     */
+    static constexpr int STEPS_PER_SAMPLE = NBodySimulation::STEPS_PER_SHORTEST_ORBIT / 64;
+
+    /**
+     * Largest number of values (4 per simulated planet and sample) we are
+     * willing to keep (8 bytes each).
+     */
+    static constexpr qsizetype MAXIMUM_SAMPLED_VALUES = qsizetype(1) << 24;
+
+    /**
+     * Default length of the recorded span, in days (a century, like the
+     * ephemeris cache's).
+     */
+    static constexpr double DEFAULT_SPAN_IN_DAYS = 36525;
+
+    /**
+     * Sets up recording of the simulation from where it is now (the first
+     * sample), for the given number of days.
+     */
+    explicit NBodyEphemeris(const NBodySimulation& simulation, double spanInDays = DEFAULT_SPAN_IN_DAYS);
+
+    /**
+     * Number of samples in the full span, and number recorded so far.
+     */
+    qsizetype sampleCount() const;
+    qsizetype recordedSampleCount() const;
+
+    /**
+     * Days between two samples.
+     */
+    double getSampleIntervalInDays() const;
+
+    /**
+     * Advances the simulation to the day of the next sample, and records
+     * the planets there. The simulation must be the one the ephemeris was
+     * set up with, left where the last sample was taken. Does nothing once
+     * all samples are recorded.
+     */
+    void recordNextSample(NBodySimulation& simulation);
+
+    bool covers(qsizetype planetIndex, Days firstDay, Days lastDay) const override;
+    std::optional<std::pair<double, double>> position(qsizetype planetIndex, Days day) const override;
+
+private:
+    double startDay;
+    double sampleInterval;
+    qsizetype samples;
+    qsizetype recordedSamples = 0;
+
+    // Index of each planet (in solar system order) among the recorded ones, -1 if not recorded
+    std::vector<qsizetype> recordedIndices;
+    qsizetype recordedPlanetCount = 0;
+
+    // Per sample, then per recorded planet: x, y (in AU), vx, vy (in AU/day)
+    AlignedVector<double> values;
+
+    void recordSample(const NBodySimulation& simulation);
+};
+
+#endif // NBODYEPHEMERIS_H
@@ -0,0 +1,360 @@
+#include "nbodysimulation.h"
+#include "orbitalmath.h"
+#include "measurementunits.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+    // Beyond this depth, bodies are too close to tell apart and share a leaf
+    constexpr int MAXIMUM_TREE_DEPTH = 48;
+
+    // Distance (in AU) below which gravity stops growing. Encounters closer than
+    // this can't be resolved at any sensible time step anyway, and would otherwise
+    // fling planets out of the system
+    constexpr double SOFTENING_LENGTH = 1e-3;
+
+    // Number of bodies whose accelerations are computed by each task
+    constexpr qsizetype ACCELERATION_CHUNK_SIZE = 1024;
+
+    // Quadrant (child index) of a point relative to a centre: bit 0 for Y, bit 1 for X
+    int quadrantOf(double x, double y, double centreX, double centreY) {
+        return (x >= centreX ? 2 : 0) + (y >= centreY ? 1 : 0);
+    }
+}
+
+NBodySimulation::NBodySimulation(const SolarSystem& planets, double timeStepInDays, double openingAngle)
+    : timeStep(timeStepInDays)
+    , openingAngle(openingAngle)
+{
+    // Gravitational constant in AU³/(kg*day²)
+    const double metresPerAU = DistanceUnit::convert(1, DistanceUnit::AU, DistanceUnit::METRES);
+    const double secondsPerDay = TimeUnit::convert(1, TimeUnit::DAYS, TimeUnit::SECONDS);
+    const double gravitationalConstant = OrbitalMath::GRAVITATIONAL_CONSTANT * secondsPerDay * secondsPerDay
+                                         / (metresPerAU * metresPerAU * metresPerAU);
+
+    // Kepler's third law gives the sun's GM from each orbit: GM = 4π²r³/T².
+    // Catalogs are rarely perfectly consistent, so take the median.
+    std::vector<double> keplerGravitationalParameters;
+    double shortestOrbitalPeriod = INFINITY;
+
+    for (qsizetype i = 0; i < planets.size(); ++i) {
+        if (!planets.hasOrbitalData(i)) continue;
+
+        const double orbitalRadius = planets.getOrbitalRadiusInAU(i).value();
+        const double orbitalPeriod = planets.getOrbitalPeriodInDays(i).value();
+
+        shortestOrbitalPeriod = std::min(shortestOrbitalPeriod, orbitalPeriod);
+
+        simulatedIndices.push_back(i);
+        gravitationalParameters.push_back(gravitationalConstant * planets.getMassInKilograms(i));
+
+        // Start where the orbital elements put the planet at time 0, orbiting counterclockwise.
+        // On an ellipse, velocity has a radial and a transverse part (both in AU/day):
+        // v_r = n a e sin(ν) / √(1 - e²), v_t = n a (1 + e cos(ν)) / √(1 - e²)
+        const Planet planet = planets.at(i);
+        const double eccentricity = planets.getEccentricity(i).value();
+        const double angularPosition = OrbitalMath::angularPositionAfterDays(planet, Days(0));
+        const auto [x, y] = OrbitalMath::polarToCartesianCoordinates(planet, angularPosition);
+        const double angle = AngleUnit::convert(angularPosition, AngleUnit::DEGREES, AngleUnit::RADIANS);
+        const double trueAnomaly = AngleUnit::convert(angularPosition - planets.getArgumentOfPeriapsisInDegrees(i).value(),
+                                                      AngleUnit::DEGREES, AngleUnit::RADIANS);
+        const double orbitalSpeedScale = 2 * std::numbers::pi * orbitalRadius / orbitalPeriod
+                                         / std::sqrt(1 - eccentricity * eccentricity);
+        const double radialVelocity = orbitalSpeedScale * eccentricity * std::sin(trueAnomaly);
+        const double transverseVelocity = orbitalSpeedScale * (1 + eccentricity * std::cos(trueAnomaly));
+
+        initialX.push_back(x);
+        initialY.push_back(y);
+        initialVelocityX.push_back(radialVelocity * std::cos(angle) - transverseVelocity * std::sin(angle));
+        initialVelocityY.push_back(radialVelocity * std::sin(angle) + transverseVelocity * std::cos(angle));
+
+        keplerGravitationalParameters.push_back(
+            4 * std::numbers::pi * std::numbers::pi * orbitalRadius * orbitalRadius * orbitalRadius / (orbitalPeriod * orbitalPeriod)
+            );
+    }
+
+    if (!keplerGravitationalParameters.empty()) {
+        auto median = keplerGravitationalParameters.begin() + keplerGravitationalParameters.size() / 2;
+        std::nth_element(keplerGravitationalParameters.begin(), median, keplerGravitationalParameters.end());
+        sunGravitationalParameter = *median;
+    }
+
+    if (timeStep <= 0) {
+        timeStep = std::isfinite(shortestOrbitalPeriod) ? shortestOrbitalPeriod / STEPS_PER_SHORTEST_ORBIT : 1.0;
+    }
+
+    planetX.assign(planets.size(), NAN);
+    planetY.assign(planets.size(), NAN);
+    planetVelocityX.assign(planets.size(), NAN);
+    planetVelocityY.assign(planets.size(), NAN);
+
+    reset();
+}
+
+double NBodySimulation::currentDay() const {
+    return day;
+}
+
+double NBodySimulation::getTimeStepInDays() const {
+    return timeStep;
+}
+
+qsizetype NBodySimulation::size() const {
+    return planetX.size();
+}
+
+std::span<const double> NBodySimulation::x() const {
+    return planetX;
+}
+
+std::span<const double> NBodySimulation::y() const {
+    return planetY;
+}
+
+std::span<const double> NBodySimulation::vx() const {
+    return planetVelocityX;
+}
+
+std::span<const double> NBodySimulation::vy() const {
+    return planetVelocityY;
+}
+
+double NBodySimulation::angularPosition(qsizetype index) const {
+    const double angle = AngleUnit::convert(std::atan2(planetY[index], planetX[index]), AngleUnit::RADIANS, AngleUnit::DEGREES);
+    return angle < 0 ? angle + 360.0 : angle;
+}
+
+double NBodySimulation::centralGravitationalParameter() const {
+    return sunGravitationalParameter;
+}
+
+void NBodySimulation::reset() {
+    day = 0;
+    positionX = initialX;
+    positionY = initialY;
+    velocityX = initialVelocityX;
+    velocityY = initialVelocityY;
+    accelerationX.assign(positionX.size(), 0);
+    accelerationY.assign(positionX.size(), 0);
+
+    computeAccelerations();
+    updatePlanetPositions();
+}
+
+void NBodySimulation::advanceTo(double targetDay) {
+    // Whole steps first (counted rather than accumulated, so that rounding doesn't add a sliver of a step)
+    const qsizetype wholeSteps = qsizetype(std::floor((targetDay - day) / timeStep + 1e-9));
+    const double startDay = day;
+    for (qsizetype i = 1; i <= wholeSteps; ++i) {
+        step(timeStep);
+        day = startDay + i * timeStep;
+    }
+
+    // Then whatever is left
+    if (targetDay > day) {
+        step(targetDay - day);
+        day = targetDay;
+    }
+
+    updatePlanetPositions();
+}
+
+void NBodySimulation::step(double stepInDays) {
+    // Kick-drift-kick leapfrog
+    const qsizetype count = positionX.size();
+    for (qsizetype i = 0; i < count; ++i) {
+        velocityX[i] += accelerationX[i] * stepInDays / 2;
+        velocityY[i] += accelerationY[i] * stepInDays / 2;
+        positionX[i] += velocityX[i] * stepInDays;
+        positionY[i] += velocityY[i] * stepInDays;
+    }
+
+    computeAccelerations();
+
+    for (qsizetype i = 0; i < count; ++i) {
+        velocityX[i] += accelerationX[i] * stepInDays / 2;
+        velocityY[i] += accelerationY[i] * stepInDays / 2;
+    }
+}
+
+void NBodySimulation::buildTree() {
+    const qsizetype count = positionX.size();
+
+    // Root square: smallest one around all bodies
+    double minimumX = INFINITY, maximumX = -INFINITY, minimumY = INFINITY, maximumY = -INFINITY;
+    for (qsizetype i = 0; i < count; ++i) {
+        minimumX = std::min(minimumX, positionX[i]);
+        maximumX = std::max(maximumX, positionX[i]);
+        minimumY = std::min(minimumY, positionY[i]);
+        maximumY = std::max(maximumY, positionY[i]);
+    }
+    const double rootSize = std::max({ maximumX - minimumX, maximumY - minimumY, SOFTENING_LENGTH }) * (1 + 1e-9);
+    const double rootCentreX = (minimumX + maximumX) / 2;
+    const double rootCentreY = (minimumY + maximumY) / 2;
+
+    // Hand out bodies to the root's quadrants
+    for (Quadrant& quadrant : quadrants) {
+        quadrant.nodes.clear(); // Keeps capacity, so the arenas stop allocating after the first few steps
+        quadrant.bodies.clear();
+    }
+    for (qsizetype i = 0; i < count; ++i) {
+        quadrants[quadrantOf(positionX[i], positionY[i], rootCentreX, rootCentreY)].bodies.push_back(qint32(i));
+    }
+
+    // Then build the quadrants in parallel
+    QList<int> quadrantIndices { 0, 1, 2, 3 };
+    QtConcurrent::blockingMap(quadrantIndices, [&](int q) {
+        Quadrant& quadrant = quadrants[q];
+        const double centreX = rootCentreX + ((q & 2) ? rootSize / 4 : -rootSize / 4);
+        const double centreY = rootCentreY + ((q & 1) ? rootSize / 4 : -rootSize / 4);
+
+        quadrant.nodes.emplace_back();
+        buildNode(quadrant, 0, centreX, centreY, rootSize / 2, 0, qint32(quadrant.bodies.size()), 1);
+    });
+}
+
+void NBodySimulation::buildNode(
+    Quadrant& quadrant, qint32 nodeIndex, double centreX, double centreY, double size,
+    qint32 firstBody, qint32 bodyCount, int depth
+    ) {
+
+    // Note: nodes may move as the arena grows, so always go through the index
+    quadrant.nodes[nodeIndex].centreX = centreX;
+    quadrant.nodes[nodeIndex].centreY = centreY;
+    quadrant.nodes[nodeIndex].size = size;
+    quadrant.nodes[nodeIndex].firstBody = firstBody;
+    quadrant.nodes[nodeIndex].bodyCount = bodyCount;
+
+    double mass = 0, weightedX = 0, weightedY = 0;
+
+    if (bodyCount <= 1 || depth >= MAXIMUM_TREE_DEPTH) {
+        // Leaf
+        quadrant.nodes[nodeIndex].firstChild = -1;
+        for (qint32 b = firstBody; b < firstBody + bodyCount; ++b) {
+            const qint32 body = quadrant.bodies[b];
+            mass += gravitationalParameters[body];
+            weightedX += gravitationalParameters[body] * positionX[body];
+            weightedY += gravitationalParameters[body] * positionY[body];
+        }
+    }
+    else {
+        // Sort bodies into the four child quadrants (same order as quadrantOf)
+        const auto begin = quadrant.bodies.begin() + firstBody;
+        const auto end = begin + bodyCount;
+        const auto splitX = std::partition(begin, end, [&](qint32 body) { return positionX[body] < centreX; });
+        const auto splitLowY = std::partition(begin, splitX, [&](qint32 body) { return positionY[body] < centreY; });
+        const auto splitHighY = std::partition(splitX, end, [&](qint32 body) { return positionY[body] < centreY; });
+        const std::array<qint32, 5> bounds {
+            firstBody,
+            qint32(splitLowY - quadrant.bodies.begin()),
+            qint32(splitX - quadrant.bodies.begin()),
+            qint32(splitHighY - quadrant.bodies.begin()),
+            firstBody + bodyCount
+        };
+
+        const qint32 firstChild = qint32(quadrant.nodes.size());
+        quadrant.nodes[nodeIndex].firstChild = firstChild;
+        quadrant.nodes.resize(quadrant.nodes.size() + 4);
+
+        for (int child = 0; child < 4; ++child) {
+            const double childCentreX = centreX + ((child & 2) ? size / 4 : -size / 4);
+            const double childCentreY = centreY + ((child & 1) ? size / 4 : -size / 4);
+            buildNode(quadrant, firstChild + child, childCentreX, childCentreY, size / 2,
+                      bounds[child], bounds[child + 1] - bounds[child], depth + 1);
+
+            const Node& childNode = quadrant.nodes[firstChild + child];
+            mass += childNode.mass;
+            weightedX += childNode.mass * childNode.centreOfMassX;
+            weightedY += childNode.mass * childNode.centreOfMassY;
+        }
+    }
+
+    Node& node = quadrant.nodes[nodeIndex];
+    node.mass = mass;
+    node.centreOfMassX = mass > 0 ? weightedX / mass : centreX;
+    node.centreOfMassY = mass > 0 ? weightedY / mass : centreY;
+}
+
+void NBodySimulation::computeAccelerations() {
+    buildTree();
+
+    const qsizetype count = positionX.size();
+    const double openingAngleSquared = openingAngle * openingAngle;
+    const double softeningSquared = SOFTENING_LENGTH * SOFTENING_LENGTH;
+
+    QList<qsizetype> chunkStarts;
+    for (qsizetype start = 0; start < count; start += ACCELERATION_CHUNK_SIZE) chunkStarts.append(start);
+
+    QtConcurrent::blockingMap(chunkStarts, [&](qsizetype start) {
+        const qsizetype end = std::min(start + ACCELERATION_CHUNK_SIZE, count);
+
+        // Nodes left to visit; each level adds at most 3 to the stack
+        std::array<qint32, 4 * MAXIMUM_TREE_DEPTH> stack;
+
+        for (qsizetype i = start; i < end; ++i) {
+            const double x = positionX[i];
+            const double y = positionY[i];
+
+            // The sun, fixed at the origin
+            const double sunDistanceSquared = x * x + y * y;
+            const double sunFactor = -sunGravitationalParameter / (sunDistanceSquared * std::sqrt(sunDistanceSquared));
+            double ax = sunFactor * x;
+            double ay = sunFactor * y;
+
+            const auto pull = [&](double mass, double otherX, double otherY) {
+                const double dx = otherX - x;
+                const double dy = otherY - y;
+                const double distanceSquared = dx * dx + dy * dy + softeningSquared;
+                const double factor = mass / (distanceSquared * std::sqrt(distanceSquared));
+                ax += factor * dx;
+                ay += factor * dy;
+            };
+
+            for (const Quadrant& quadrant : quadrants) {
+                if (quadrant.nodes.empty()) continue;
+
+                int stackSize = 0;
+                stack[stackSize++] = 0;
+                while (stackSize > 0) {
+                    const Node& node = quadrant.nodes[stack[--stackSize]];
+                    if (0 == node.mass) continue;
+
+                    if (node.firstChild < 0) {
+                        for (qint32 b = node.firstBody; b < node.firstBody + node.bodyCount; ++b) {
+                            const qint32 body = quadrant.bodies[b];
+                            if (body != i) pull(gravitationalParameters[body], positionX[body], positionY[body]);
+                        }
+                        continue;
+                    }
+
+                    // Far enough (and not containing us): treat as a single body
+                    const double dx = node.centreOfMassX - x;
+                    const double dy = node.centreOfMassY - y;
+                    const bool containsBody = std::abs(x - node.centreX) <= node.size / 2 && std::abs(y - node.centreY) <= node.size / 2;
+                    if (!containsBody && node.size * node.size < openingAngleSquared * (dx * dx + dy * dy)) {
+                        pull(node.mass, node.centreOfMassX, node.centreOfMassY);
+                        continue;
+                    }
+
+                    for (int child = 0; child < 4; ++child) stack[stackSize++] = node.firstChild + child;
+                }
+            }
+
+            accelerationX[i] = ax;
+            accelerationY[i] = ay;
+        }
+    });
+}
+
+void NBodySimulation::updatePlanetPositions() {
+    for (qsizetype i = 0; i < qsizetype(simulatedIndices.size()); ++i) {
+        planetX[simulatedIndices[i]] = positionX[i];
+        planetY[simulatedIndices[i]] = positionY[i];
+        planetVelocityX[simulatedIndices[i]] = velocityX[i];
+        planetVelocityY[simulatedIndices[i]] = velocityY[i];
+    }
+}
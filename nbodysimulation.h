@@ -0,0 +1,160 @@
+#ifndef NBODYSIMULATION_H
+#define NBODYSIMULATION_H
+
+#include "alignedvector.h"
+#include "solarsystem.h"
+
+#include <QtGlobal>
+
+#include <array>
+#include <span>
+
+/**
+ * N-body propagation of the planets of a solar system, as an alternative
+ * to the Keplerian (two-body) model of `OrbitalMath::angularPositionAfterDays`
+ * that captures the planets' gravitational pull on each other.
+ *
+ * The simulation is two-dimensional, like the rest of the model. The sun
+ * is a fixed mass at the origin, whose mass is derived from the planets'
+ * orbits with Kepler's third law. Planets start where their orbital
+ * elements put them at time 0, moving at their orbital velocity there.
+ *
+ * Forces between planets are approximated with a Barnes–Hut quadtree
+ * (O(n log n) instead of O(n²) for direct summation), which is rebuilt
+ * in parallel at every step from a node arena. Positions are advanced
+ * with a kick-drift-kick leapfrog, which is symplectic and so keeps
+ * orbits stable over long runs.
+ *
+ * Planets lacking orbital data take no part in the simulation, and
+ * their positions are NaN.
+ */
+class NBodySimulation
+{
+public:
+    /**
+     * Unless given explicitly, the time step is the shortest orbital period
+     * divided by this. The leapfrog's phase error grows with the square of
+     * the time step, so this keeps it to a fraction of a degree per dozen
+     * orbits of the fastest planet.
+     */
+    static constexpr int STEPS_PER_SHORTEST_ORBIT = 512;
+
+    /**
+     * Default Barnes–Hut opening angle: a tree node is treated as a single
+     * body when its size divided by its distance is below this.
+     * 0 gives direct summation.
+     */
+    static constexpr double DEFAULT_OPENING_ANGLE = 0.5;
+
+    /**
+     * Sets up the simulation at time 0. A time step of 0 picks one
+     * automatically (see `STEPS_PER_SHORTEST_ORBIT`).
+     */
+    explicit NBodySimulation(
+        const SolarSystem& planets,
+        double timeStepInDays = 0,
+        double openingAngle = DEFAULT_OPENING_ANGLE
+        );
+
+    /**
+     * Current simulation time, in days.
+     */
+    double currentDay() const;
+
+    /**
+     * Time step, in days.
+     */
+    double getTimeStepInDays() const;
+
+    /**
+     * Advances the simulation to the given day (in whole time steps,
+     * plus a shorter final one if needed). Cannot go back in time;
+     * use `reset` first for that.
+     */
+    void advanceTo(double day);
+
+    /**
+     * Puts all planets back at their initial positions (time 0).
+     */
+    void reset();
+
+    /**
+     * Number of planets (simulated or not), in solar system order.
+     */
+    qsizetype size() const;
+
+    // Current positions (in AU, origin at the sun, see
+    // `OrbitalMath::polarToCartesianCoordinates`), in solar system order
+    std::span<const double> x() const;
+    std::span<const double> y() const;
+
+    // Current velocities (in AU/day), in solar system order
+    std::span<const double> vx() const;
+    std::span<const double> vy() const;
+
+    /**
+     * Current angular position (in degrees, normalized to [0°, 360°))
+     * of the given planet, comparable to `OrbitalMath::angularPositionAfterDays`.
+     */
+    double angularPosition(qsizetype index) const;
+
+    /**
+     * Sun's gravitational parameter GM (in AU³/day²) derived from the
+     * planets' orbits.
+     */
+    double centralGravitationalParameter() const;
+
+private:
+    /**
+     * A quadtree node. Leaves hold a range of bodies (usually one, more only
+     * if bodies are too close to be separated); inner nodes have four
+     * consecutive children starting at `firstChild`.
+     */
+    struct Node {
+        double centreX; // Centre of the node's square, in AU
+        double centreY;
+        double size; // Side of the node's square, in AU
+        double centreOfMassX;
+        double centreOfMassY;
+        double mass; // As gravitational parameter GM, in AU³/day²
+        qint32 firstChild; // -1 for leaves
+        qint32 firstBody;
+        qint32 bodyCount;
+    };
+
+    /**
+     * One quadrant of the tree (a child of the root). Each quadrant is built
+     * by a separate task, with its own node arena and body order.
+     */
+    struct Quadrant {
+        std::vector<Node> nodes; // Arena; nodes[0] is the quadrant's root
+        std::vector<qint32> bodies; // Simulated body indices, grouped by leaf
+    };
+
+    double timeStep;
+    double openingAngle;
+    double day = 0;
+    double sunGravitationalParameter = 0;
+
+    // Simulated bodies only (see simulatedIndices)
+    std::vector<qsizetype> simulatedIndices; // Index in the solar system of each simulated body
+    AlignedVector<double> gravitationalParameters; // GM, in AU³/day²
+    AlignedVector<double> initialX, initialY, initialVelocityX, initialVelocityY;
+    AlignedVector<double> positionX, positionY, velocityX, velocityY;
+    AlignedVector<double> accelerationX, accelerationY;
+
+    // Positions and velocities of all planets, in solar system order (NaN if not simulated)
+    AlignedVector<double> planetX, planetY;
+    AlignedVector<double> planetVelocityX, planetVelocityY;
+
+    std::array<Quadrant, 4> quadrants;
+
+    void buildTree();
+    void buildNode(Quadrant& quadrant, qint32 nodeIndex, double centreX, double centreY, double size,
+                   qint32 firstBody, qint32 bodyCount, int depth);
+    void computeAccelerations();
+    void step(double stepInDays);
+    void updatePlanetPositions();
+};
+
+#endif // NBODYSIMULATION_H
@@ -1,13 +1,18 @@
 #include "orbitalmath.h"
 #include "measurementunits.h"
 
-double OrbitalMath::escapeVelocity(const Planet& planet) {
-    static const double gravitationalConstant = 6.67e-11; // m³/kg*s²
+#include <QElapsedTimer>
+#include <QThread>
+#include <QtConcurrent>
+
+#include <numbers>
+#include <tuple>
 
+double OrbitalMath::escapeVelocity(const Planet& planet) {
     const double planetMass = planet.getMassInKilograms();
     const double planetRadius = planet.getRadiusInMetres();
 
-    return sqrt(2 * gravitationalConstant * planetMass / planetRadius);
+    return sqrt(2 * GRAVITATIONAL_CONSTANT * planetMass / planetRadius);
 }
 
 double OrbitalMath::totalAcceleration(const Rocket& rocket) {
@@ -41,12 +46,14 @@ OrbitalMath::computeAccelerationValues(const Rocket& rocket, double targetVeloci
     return { accelerationTime, accelerationDistance };
 }
 
-double OrbitalMath::daysUntilAligned(const Planet& first, double firstAngularPosition, const Planet& second, double secondAngularPosition) {
+Days OrbitalMath::daysUntilAligned(const Planet& first, double firstAngularPosition, const Planet& second, double secondAngularPosition) {
     // If already aligned, shortcut
-    if (firstAngularPosition == secondAngularPosition) return 0;
+    if (firstAngularPosition == secondAngularPosition) return Days(0);
 
     // Discard extraneous rotations, keep angularΔ between + and - 360°.
-    const double angularDelta = std::fmod(secondAngularPosition - firstAngularPosition, 360.0);
+    // This is the gap the second planet has to make up on the first one
+    // (its lead shrinks as angularVelocityΔ accumulates), hence first - second.
+    const double angularDelta = std::fmod(firstAngularPosition - secondAngularPosition, 360.0);
 
     // Angular velocities in °/day
     const double firstAngularVelocity = angularVelocity(first);
@@ -63,7 +70,7 @@ double OrbitalMath::daysUntilAligned(const Planet& first, double firstAngularPos
     // #days = angularΔ (°) / angularVelocityΔ (°/day)
     // Will always be positive since angularΔ and angularVelocityΔ
     // have the same sign.
-    return targetAngularDelta / angularVelocityDelta;
+    return Days(targetAngularDelta / angularVelocityDelta);
 }
 
 double OrbitalMath::shortestDistance(const Planet& from, const Planet& to) {
@@ -73,7 +80,19 @@ double OrbitalMath::shortestDistance(const Planet& from, const Planet& to) {
     const double fromOrbitalRadius = from.getOrbitalRadiusInAU().value();
     const double toOrbitalRadius = to.getOrbitalRadiusInAU().value();
 
-    const double distanceBetweenCentres = abs(fromOrbitalRadius - toOrbitalRadius);
+    double distanceBetweenCentres = abs(fromOrbitalRadius - toOrbitalRadius);
+    if (0 != from.getEccentricity().value() || 0 != to.getEccentricity().value()) {
+        // Elliptical orbits: smallest radial gap over all directions
+        static const double SEARCH_STEP_IN_DEGREES = 0.1;
+        distanceBetweenCentres = INFINITY;
+        for (int step = 0; step * SEARCH_STEP_IN_DEGREES < 360.0; ++step) {
+            const double angularPosition = step * SEARCH_STEP_IN_DEGREES;
+            distanceBetweenCentres = std::min(distanceBetweenCentres, std::abs(
+                orbitalRadiusAtAngularPosition(from, angularPosition) - orbitalRadiusAtAngularPosition(to, angularPosition)
+                ));
+        }
+    }
+
     const double distanceBetweenSurfaces = distanceBetweenCentres
                                            - DistanceUnit::convert(from.getRadiusInMetres(), DistanceUnit::METRES, DistanceUnit::AU)
                                            - DistanceUnit::convert(to.getRadiusInMetres(), DistanceUnit::METRES, DistanceUnit::AU);
@@ -86,11 +105,11 @@ double OrbitalMath::shortestDistanceConstrained(
     double fromAngularPosition,
     const Planet& to,
     double toAngularPosition,
-    double maximumTimeframe
+    Days maximumTimeframe
     ) {
 
     // Compute time until planets align
-    const double daysUntilAligned = OrbitalMath::daysUntilAligned(from, fromAngularPosition, to, toAngularPosition);
+    const Days daysUntilAligned = OrbitalMath::daysUntilAligned(from, fromAngularPosition, to, toAngularPosition);
 
     // If time is within timeframe, compute with simple formula
     if (daysUntilAligned <= maximumTimeframe) return shortestDistance(from, to);
@@ -119,23 +138,81 @@ double OrbitalMath::shortestDistanceConstrained(
     if (angularDeltaStart <= angularDeltaEnd) {
         // Starting alignment is closer and should be preferred
         // (Or equal, and in case of ties we favour the earlier moment.)
-        return distance(from, fromAngularPosition, to, toAngularPosition);
+        return distance(from, fromAngularPosition, to, toAngularPosition).value();
     }
     else {
         // Final alignment is closer and should be preferred
-        return distance(from, fromAngularPositionEnd, to, toAngularPositionEnd);
+        return distance(from, fromAngularPositionEnd, to, toAngularPositionEnd).value();
     }
 }
 
-double OrbitalMath::angularPositionAfterDays(const Planet& planet, double daysElapsed, double initialAngularPosition) {
+double OrbitalMath::angularPositionAfterDays(const Planet& planet, Days daysElapsed, double initialAngularPosition) {
     // TODO: how should we handle planets lacking orbital data?
     // Currently we simply trigger an error trying to access the optional.
     const double orbitalPeriod = planet.getOrbitalPeriodInDays().value();
+    const double eccentricity = planet.getEccentricity().value();
+
+    // From the solar system's position source instead, if it has one for the day
+    if (std::isnan(initialAngularPosition)) {
+        const PositionSource* positionSource = planet.getSolarSystem().getPositionSource();
+        if (nullptr != positionSource) {
+            const std::optional<double> sourcedAngularPosition = positionSource->angularPosition(planet.getIndex(), daysElapsed);
+            if (sourcedAngularPosition.has_value()) return sourcedAngularPosition.value();
+        }
+    }
+
+    if (0 != eccentricity) {
+        // Elliptical orbit: advance the mean anomaly (which grows linearly
+        // with time), then solve Kepler's equation for the position
+        if (std::isnan(initialAngularPosition)) {
+            // Cheaper from the ephemeris cache, if there is one for the day
+            const EphemerisCache* ephemerisCache = planet.getSolarSystem().getEphemerisCache();
+            if (nullptr != ephemerisCache) {
+                const std::optional<double> cachedAngularPosition = ephemerisCache->angularPosition(planet, daysElapsed.value());
+                if (cachedAngularPosition.has_value()) return cachedAngularPosition.value();
+            }
+        }
+
+        const double argumentOfPeriapsis = planet.getArgumentOfPeriapsisInDegrees().value();
+        const double semiMinorAxisRatio = std::sqrt(1 - eccentricity * eccentricity);
+
+        double meanAnomaly;
+        if (std::isnan(initialAngularPosition)) {
+            // From the elements: the planet is at its periapsis at the epoch
+            const double orbits = (daysElapsed.value() - planet.getEpochInDays().value()) / orbitalPeriod;
+            meanAnomaly = 2 * std::numbers::pi * (orbits - std::nearbyint(orbits));
+        }
+        else {
+            // From the given position: true anomaly -> eccentric anomaly -> mean anomaly
+            const double initialTrueAnomaly = AngleUnit::convert(initialAngularPosition - argumentOfPeriapsis,
+                                                                 AngleUnit::DEGREES, AngleUnit::RADIANS);
+            const double initialEccentricAnomaly = std::atan2(semiMinorAxisRatio * std::sin(initialTrueAnomaly),
+                                                              eccentricity + std::cos(initialTrueAnomaly));
+            const double initialMeanAnomaly = initialEccentricAnomaly - eccentricity * std::sin(initialEccentricAnomaly);
+            const double orbits = daysElapsed.value() / orbitalPeriod;
+            meanAnomaly = initialMeanAnomaly + 2 * std::numbers::pi * (orbits - std::nearbyint(orbits));
+        }
+
+        const double eccentricAnomaly = OrbitalMath::eccentricAnomaly(meanAnomaly, eccentricity);
+        const double trueAnomaly = std::atan2(semiMinorAxisRatio * std::sin(eccentricAnomaly), std::cos(eccentricAnomaly) - eccentricity);
+
+        double finalAngularPosition = std::fmod(
+            argumentOfPeriapsis + AngleUnit::convert(trueAnomaly, AngleUnit::RADIANS, AngleUnit::DEGREES), 360.0);
+        if (finalAngularPosition < 0) finalAngularPosition += 360.0;
+        return finalAngularPosition;
+    }
+
+    // Circular orbit: without a starting position, the planet passes its
+    // "periapsis" (any point will do) at the epoch
+    if (std::isnan(initialAngularPosition)) {
+        initialAngularPosition = planet.getArgumentOfPeriapsisInDegrees().value()
+                                 - (360.0 / orbitalPeriod) * planet.getEpochInDays().value();
+    }
 
     // angularΔ = angularVelocity [°/day] * time [days]
     // angularVelocity = 360° / orbitalPeriod [days]
     // So angularΔ = (360 / orbitalPeriod) * time
-    const double angularDelta = (360.0 / orbitalPeriod) * daysElapsed;
+    const double angularDelta = (360.0 / orbitalPeriod) * daysElapsed.value();
 
     // modulo to within 0-360°
     const double finalAngularPosition = std::fmod(initialAngularPosition + angularDelta, 360.0);
@@ -143,10 +220,53 @@ double OrbitalMath::angularPositionAfterDays(const Planet& planet, double daysEl
     return finalAngularPosition;
 }
 
-std::pair<double, double> OrbitalMath::polarToCartesianCoordinates(const Planet& planet, double angularPosition) {
+double OrbitalMath::meanAngularPositionAfterDays(const Planet& planet, Days daysElapsed) {
+    // Planets without an orbit have no position (like in `orbitalPositionsAfterDays`)
+    if (!planet.hasOrbitalData()) return NAN;
+
+    const double orbitalPeriod = planet.getOrbitalPeriodInDays().value();
+    const double initialAngularPosition = planet.getArgumentOfPeriapsisInDegrees().value()
+                                          - (360.0 / orbitalPeriod) * planet.getEpochInDays().value();
+
+    return std::fmod(initialAngularPosition + (360.0 / orbitalPeriod) * daysElapsed.value(), 360.0);
+}
+
+double OrbitalMath::orbitalRadiusAtAngularPosition(const Planet& planet, double angularPosition) {
     // TODO: how should we handle planets lacking orbital data?
     // Currently we simply trigger an error trying to access the optional.
     const double orbitalRadius = planet.getOrbitalRadiusInAU().value();
+    const double eccentricity = planet.getEccentricity().value();
+    if (0 == eccentricity) return orbitalRadius;
+
+    // Polar equation of an ellipse with the sun at a focus: r = a(1 - e²) / (1 + e cos(ν))
+    const double trueAnomaly = AngleUnit::convert(angularPosition - planet.getArgumentOfPeriapsisInDegrees().value(),
+                                                  AngleUnit::DEGREES, AngleUnit::RADIANS);
+    return orbitalRadius * (1 - eccentricity * eccentricity) / (1 + eccentricity * std::cos(trueAnomaly));
+}
+
+std::pair<double, double> OrbitalMath::cartesianCoordinatesAfterDays(const Planet& planet, Days daysElapsed) {
+    // Planets without an orbit have no position (like in `orbitalPositionsAfterDays`)
+    if (!planet.hasOrbitalData()) return {NAN, NAN};
+
+    const PositionSource* positionSource = planet.getSolarSystem().getPositionSource();
+    if (nullptr != positionSource) {
+        const std::optional<std::pair<double, double>> sourcedCoordinates = positionSource->position(planet.getIndex(), daysElapsed);
+        if (sourcedCoordinates.has_value()) return sourcedCoordinates.value();
+    }
+
+    if (0 != planet.getEccentricity().value()) {
+        const EphemerisCache* ephemerisCache = planet.getSolarSystem().getEphemerisCache();
+        if (nullptr != ephemerisCache) {
+            const std::optional<std::pair<double, double>> cachedCoordinates = ephemerisCache->position(planet, daysElapsed.value());
+            if (cachedCoordinates.has_value()) return cachedCoordinates.value();
+        }
+    }
+
+    return polarToCartesianCoordinates(planet, angularPositionAfterDays(planet, daysElapsed));
+}
+
+std::pair<double, double> OrbitalMath::polarToCartesianCoordinates(const Planet& planet, double angularPosition) {
+    const double orbitalRadius = orbitalRadiusAtAngularPosition(planet, angularPosition);
     const double angularPositionInRadians = AngleUnit::convert(angularPosition, AngleUnit::DEGREES, AngleUnit::RADIANS);
 
     const double x = orbitalRadius * std::cos(angularPositionInRadians);
@@ -155,25 +275,25 @@ std::pair<double, double> OrbitalMath::polarToCartesianCoordinates(const Planet&
     return {x, y};
 }
 
-double OrbitalMath::distance(const Planet& from, double fromAngularPosition, const Planet& to, double toAngularPosition) {
+AstronomicalUnits OrbitalMath::distance(const Planet& from, double fromAngularPosition, const Planet& to, double toAngularPosition) {
     // TODO: how should we handle planets lacking orbital data?
     // Currently we simply trigger an error trying to access the optional.
     const double angularDelta = std::fmod(toAngularPosition - fromAngularPosition, 360.0);
 
     // Simple case: planets are aligned
     if (0 == angularDelta) {
-        const double fromOrbitalRadius = from.getOrbitalRadiusInAU().value();
-        const double toOrbitalRadius = to.getOrbitalRadiusInAU().value();
+        const double fromOrbitalRadius = orbitalRadiusAtAngularPosition(from, fromAngularPosition);
+        const double toOrbitalRadius = orbitalRadiusAtAngularPosition(to, toAngularPosition);
 
-        return std::abs(toOrbitalRadius - fromOrbitalRadius);
+        return AstronomicalUnits(std::abs(toOrbitalRadius - fromOrbitalRadius));
     }
 
     // Simple case: planets are in opposing directions
     if (180.0 == angularDelta || -180.0 == angularDelta) {
-        const double fromOrbitalRadius = from.getOrbitalRadiusInAU().value();
-        const double toOrbitalRadius = to.getOrbitalRadiusInAU().value();
+        const double fromOrbitalRadius = orbitalRadiusAtAngularPosition(from, fromAngularPosition);
+        const double toOrbitalRadius = orbitalRadiusAtAngularPosition(to, toAngularPosition);
 
-        return toOrbitalRadius + fromOrbitalRadius;
+        return AstronomicalUnits(toOrbitalRadius + fromOrbitalRadius);
     }
 
     // Otherwise, translate to cartesian and use Pythagorean theorem.
@@ -183,24 +303,88 @@ double OrbitalMath::distance(const Planet& from, double fromAngularPosition, con
     // distance = √( (x1-x2)² + (y1-y2)² )
     const double deltaX = toCoords.first - fromCoords.first;
     const double deltaY = toCoords.second - fromCoords.second;
-    return std::sqrt( deltaX * deltaX  +  deltaY * deltaY );
+    return AstronomicalUnits(std::sqrt( deltaX * deltaX  +  deltaY * deltaY ));
+}
+
+namespace {
+    /**
+     * Distance between the surfaces of two planets, each where it is on the
+     * given day (see `OrbitalMath::cartesianCoordinatesAfterDays`).
+     */
+    Metres surfaceDistanceAtDays(const Planet& from, Days fromDay, const Planet& to, Days toDay) {
+        const auto [fromX, fromY] = OrbitalMath::cartesianCoordinatesAfterDays(from, fromDay);
+        const auto [toX, toY] = OrbitalMath::cartesianCoordinatesAfterDays(to, toDay);
+
+        const double deltaX = toX - fromX;
+        const double deltaY = toY - fromY;
+        const Metres distanceBetweenCentres = AstronomicalUnits(std::sqrt(deltaX * deltaX + deltaY * deltaY));
+        return distanceBetweenCentres
+               - Metres(from.getRadiusInMetres())
+               - Metres(to.getRadiusInMetres());
+    }
+}
+
+Metres OrbitalMath::surfaceDistance(
+    const Planet& from, const Planet& to, double fromAngularPosition, double toAngularPosition, Days daysElapsed
+    ) {
+    // A position source puts planets where it likes, not necessarily on their
+    // orbits, so positions that aren't given are taken from it whole
+    if (std::isnan(fromAngularPosition) && std::isnan(toAngularPosition)
+        && nullptr != from.getSolarSystem().getPositionSource()) {
+        return surfaceDistanceAtDays(from, daysElapsed, to, daysElapsed);
+    }
+
+    // Adjust angular positions if needed (missing ones come from the orbital elements)
+    if (Days(0) != daysElapsed || std::isnan(fromAngularPosition) || std::isnan(toAngularPosition)) {
+        fromAngularPosition = OrbitalMath::angularPositionAfterDays(from, daysElapsed, fromAngularPosition);
+        toAngularPosition = OrbitalMath::angularPositionAfterDays(to, daysElapsed, toAngularPosition);
+    }
+
+    const Metres distanceBetweenCentres = OrbitalMath::distance(from, fromAngularPosition, to, toAngularPosition);
+    return distanceBetweenCentres
+           - Metres(from.getRadiusInMetres())
+           - Metres(to.getRadiusInMetres());
 }
 
 OrbitalMath::TransferResults
-OrbitalMath::computeTransfer(const Planet& from, const Planet& to, const Rocket& rocket, double totalDistance, bool realisticGravity) {
+OrbitalMath::computeTransfer(
+    const Planet& from, const Planet& to, const Rocket& rocket, Metres totalDistance,
+    bool realisticGravity, const GravityIntegrationSettings& gravitySettings
+    ) {
     const double fromEscapeVelocity = OrbitalMath::escapeVelocity(from);
     const double toEscapeVelocity = OrbitalMath::escapeVelocity(to);
     const double cruisingVelocity = std::max(fromEscapeVelocity, toEscapeVelocity);
 
-    // TODO: if realistic gravity, include effect here
-    const OrbitalMath::AccelerationResult launchAcceleration =
-        OrbitalMath::computeAccelerationValues(rocket, cruisingVelocity);
-
-    // TODO: if realistic gravity, include effect here
-    const OrbitalMath::AccelerationResult landingDeceleration =
-        OrbitalMath::computeAccelerationValues(rocket, 0.0, cruisingVelocity);
+    OrbitalMath::AccelerationResult launchAcceleration;
+    OrbitalMath::AccelerationResult landingDeceleration;
+    GravityIntegrationReport gravityIntegration;
+
+    if (realisticGravity) {
+        QElapsedTimer timer;
+        timer.start();
+
+        // Landing is launching in reverse, see integrateLaunch
+        const GravityPhaseResult launch = OrbitalMath::integrateLaunch(rocket, from, cruisingVelocity, gravitySettings);
+        const GravityPhaseResult landing = OrbitalMath::integrateLaunch(rocket, to, cruisingVelocity, gravitySettings);
+
+        launchAcceleration = { launch.accelerationTime, launch.accelerationDistance };
+        landingDeceleration = { landing.accelerationTime, landing.accelerationDistance };
+
+        gravityIntegration.launchSteps = launch.steps;
+        gravityIntegration.landingSteps = landing.steps;
+        gravityIntegration.rejectedSteps = launch.rejectedSteps + landing.rejectedSteps;
+        gravityIntegration.launchReachedFarField = launch.reachedFarField;
+        gravityIntegration.landingReachedFarField = landing.reachedFarField;
+        gravityIntegration.launchReused = launch.reused;
+        gravityIntegration.landingReused = landing.reused;
+        gravityIntegration.integrationTime = timer.nsecsElapsed() * 1e-9; // ns to s
+    }
+    else {
+        launchAcceleration = OrbitalMath::computeAccelerationValues(rocket, cruisingVelocity);
+        landingDeceleration = OrbitalMath::computeAccelerationValues(rocket, 0.0, cruisingVelocity);
+    }
 
-    const double cruisingDistance = totalDistance
+    const double cruisingDistance = totalDistance.value()
                                     - launchAcceleration.accelerationDistance
                                     - landingDeceleration.accelerationDistance;
     const double cruisingTime = cruisingDistance / cruisingVelocity;
@@ -210,88 +394,541 @@ OrbitalMath::computeTransfer(const Planet& from, const Planet& to, const Rocket&
                                    + landingDeceleration.accelerationTime;
 
     return {
-        cruisingVelocity,
-        launchAcceleration.accelerationTime,
-        launchAcceleration.accelerationDistance,
-        cruisingTime,
-        landingDeceleration.accelerationTime,
-        landingDeceleration.accelerationDistance,
-        totalTravelTime
+        MetresPerSecond(cruisingVelocity),
+        Seconds(launchAcceleration.accelerationTime),
+        Metres(launchAcceleration.accelerationDistance),
+        Seconds(cruisingTime),
+        Seconds(landingDeceleration.accelerationTime),
+        Metres(landingDeceleration.accelerationDistance),
+        Seconds(totalTravelTime),
+        gravityIntegration
     };
 }
 
 OrbitalMath::TransferResults
 OrbitalMath::computeSimpleTransfer(
     const Planet& from, const Planet& to, const Rocket& rocket,
-    double fromAngularPosition, double toAngularPosition, double daysElapsed,
-    bool realisticGravity
+    double fromAngularPosition, double toAngularPosition, Days daysElapsed,
+    bool realisticGravity, const GravityIntegrationSettings& gravitySettings
     ) {
 
-    // Adjust angular positions if needed
-    if (daysElapsed) {
-        fromAngularPosition = OrbitalMath::angularPositionAfterDays(from, daysElapsed, fromAngularPosition);
-        toAngularPosition = OrbitalMath::angularPositionAfterDays(to, daysElapsed, toAngularPosition);
+    const Metres distanceBetweenSurfaces = OrbitalMath::surfaceDistance(from, to, fromAngularPosition, toAngularPosition, daysElapsed);
+
+    return computeTransfer(from, to, rocket, distanceBetweenSurfaces, realisticGravity, gravitySettings);
+}
+
+OrbitalMath::InterceptResult
+OrbitalMath::solveIntercept(const Planet& from, const Planet& to, const Rocket& rocket, Days departureDay, Days initialFlightTime) {
+    const double fromAngularPosition = OrbitalMath::angularPositionAfterDays(from, departureDay);
+    const bool positionsSourced = nullptr != from.getSolarSystem().getPositionSource(); // See surfaceDistance
+
+    // Evaluates a flight time (in days, like the whole iteration): fills in the result
+    // for it, and returns how far off it is (travel time it implies - flight time)
+    InterceptResult result;
+    const auto evaluate = [&](double flightTime) {
+        result.flightTime = Days(flightTime);
+        result.arrivalAngularPosition = OrbitalMath::angularPositionAfterDays(to, departureDay + result.flightTime);
+        result.transfer = positionsSourced
+            ? OrbitalMath::computeTransfer(from, to, rocket, surfaceDistanceAtDays(from, departureDay, to, departureDay + result.flightTime))
+            : OrbitalMath::computeSimpleTransfer(from, to, rocket, fromAngularPosition, result.arrivalAngularPosition);
+        return Days(result.transfer.totalTravelTime).value() - flightTime;
+    };
+
+    // Longest flight time known to be too short (error > 0) and shortest one known to be
+    // too long (error < 0). A flight time of 0 is always too short, since any trip takes
+    // some time, so we have a bracket as soon as we find a flight time that is too long.
+    double tooShort = 0;
+    double tooLong = INFINITY;
+
+    double previousFlightTime = std::isfinite(initialFlightTime.value()) ? std::max(0.0, initialFlightTime.value()) : 0;
+    double previousError = evaluate(previousFlightTime);
+    result.iterations = 1;
+    if (std::abs(previousError) <= INTERCEPT_TOLERANCE.value()) {
+        result.converged = true;
+        return result;
+    }
+    if (previousError > 0) tooShort = previousFlightTime;
+    else tooLong = previousFlightTime;
+
+    // Second point for the secant: one fixed-point step (fly for as long as the last guess implies)
+    double flightTime = previousFlightTime + previousError;
+
+    while (result.iterations < INTERCEPT_MAXIMUM_ITERATIONS) {
+        const double error = evaluate(flightTime);
+        ++result.iterations;
+
+        if (std::abs(error) <= INTERCEPT_TOLERANCE.value()) {
+            result.converged = true;
+            return result;
+        }
+        if (error > 0) tooShort = std::max(tooShort, flightTime);
+        else tooLong = std::min(tooLong, flightTime);
+
+        // Secant step, as long as it heads somewhere we don't know to be wrong:
+        // within the bracket if we have one, past the longest too-short flight
+        // time otherwise. If it doesn't (e.g. near a local extremum), bisect the
+        // bracket, or take a fixed-point step (fly for as long as the current
+        // guess implies), which always moves forward while flights are too short.
+        double nextFlightTime = flightTime - error * (flightTime - previousFlightTime) / (error - previousError);
+        const bool bracketed = std::isfinite(tooLong);
+        if (bracketed) {
+            if (!(nextFlightTime > tooShort && nextFlightTime < tooLong)) nextFlightTime = (tooShort + tooLong) / 2;
+        }
+        else if (!(nextFlightTime > tooShort)) {
+            nextFlightTime = flightTime + error;
+        }
+
+        previousFlightTime = flightTime;
+        previousError = error;
+        flightTime = nextFlightTime;
     }
 
-    // Compute distance between planet *surfaces*
-    const double distanceBetweenCentres = DistanceUnit::convert(
-        OrbitalMath::distance(from, fromAngularPosition, to, toAngularPosition),
-        DistanceUnit::AU,
-        DistanceUnit::METRES
-        );
-    const double distanceBetweenSurfaces = distanceBetweenCentres
-                                           - from.getRadiusInMetres()
-                                           - to.getRadiusInMetres();
+    result.converged = false;
+    return result;
+}
+
+namespace {
+    // Number of departures solved one after the other (warm-starting each other) by each task
+    constexpr qsizetype INTERCEPT_CHUNK_SIZE = 256;
+}
+
+void OrbitalMath::solveIntercepts(
+    const Planet& from, const Planet& to, const Rocket& rocket,
+    std::span<const double> departureDays, std::span<InterceptResult> results
+    ) {
+
+    const qsizetype count = departureDays.size();
+
+    QList<qsizetype> chunkStarts;
+    for (qsizetype start = 0; start < count; start += INTERCEPT_CHUNK_SIZE) chunkStarts.append(start);
+
+    QtConcurrent::blockingMap(chunkStarts, [&](qsizetype start) {
+        const qsizetype end = std::min(start + INTERCEPT_CHUNK_SIZE, count);
+
+        Days guess = Days(NAN);
+        for (qsizetype i = start; i < end; ++i) {
+            results[i] = solveIntercept(from, to, rocket, Days(departureDays[i]), guess);
+            guess = results[i].converged ? results[i].flightTime : Days(NAN);
+        }
+    });
+}
+
+OrbitalMath::PorkchopTile
+OrbitalMath::porkchopTile(
+    const Planet& from, const Planet& to, const Rocket& rocket, const PorkchopGridSpec& spec,
+    qsizetype firstDeparture, qsizetype departureCount, qsizetype firstFlightTime, qsizetype flightTimeCount
+    ) {
+
+    PorkchopTile tile;
+    tile.firstDeparture = firstDeparture;
+    tile.departureCount = departureCount;
+    tile.firstFlightTime = firstFlightTime;
+    tile.flightTimeCount = flightTimeCount;
+    tile.distances.resize(departureCount * flightTimeCount);
+    tile.travelTimes.resize(departureCount * flightTimeCount);
+
+    const double planetRadii = from.getRadiusInMetres() + to.getRadiusInMetres();
+
+    // Acceleration and deceleration are the same for every cell, only cruising time varies:
+    // total time = total time for a 0 m transfer + distance / cruising velocity
+    const TransferResults baseTransfer = computeTransfer(from, to, rocket, Metres(0));
+
+    // Rotation of the destination during each flight time, shared by all departures.
+    // Only works for circular orbits: on elliptical ones, the destination's arrival
+    // positions are computed for each departure instead (with the batched Kepler solver),
+    // as they are when planets are placed by a position source (by asking it).
+    const bool positionsSourced = nullptr != to.getSolarSystem().getPositionSource();
+    const bool computeArrivalPositions = 0 != to.getEccentricity().value() || positionsSourced;
+    const double toAngularVelocity = angularVelocity(to);
+    AlignedVector<double> flightRotationCos(flightTimeCount);
+    AlignedVector<double> flightRotationSin(flightTimeCount);
+    AlignedVector<double> arrivalDays, arrivalX, arrivalY; // In days, and AU
+    if (computeArrivalPositions) {
+        arrivalDays.resize(flightTimeCount);
+        arrivalX.resize(flightTimeCount);
+        arrivalY.resize(flightTimeCount);
+    }
+    else {
+        for (qsizetype j = 0; j < flightTimeCount; ++j) {
+            const double flightTime = spec.firstFlightTimeInDays + (firstFlightTime + j) * spec.flightTimeStepInDays;
+            const double rotation = AngleUnit::convert(toAngularVelocity * flightTime, AngleUnit::DEGREES, AngleUnit::RADIANS);
+            flightRotationCos[j] = std::cos(rotation);
+            flightRotationSin[j] = std::sin(rotation);
+        }
+    }
+    const double metresPerAU = DistanceUnit::convert(1, DistanceUnit::AU, DistanceUnit::METRES);
+
+    for (qsizetype i = 0; i < departureCount; ++i) {
+        const double departureDay = spec.firstDepartureDay + (firstDeparture + i) * spec.departureStepInDays;
+
+        // Positions at departure, in metres
+        double fromX, fromY, toDepartureX, toDepartureY;
+        if (positionsSourced) {
+            const auto [x, y] = cartesianCoordinatesAfterDays(from, Days(departureDay));
+            fromX = x * metresPerAU;
+            fromY = y * metresPerAU;
+            toDepartureX = toDepartureY = NAN; // Not rotated, see above
+        }
+        else {
+            const double fromAngularPosition = angularPositionAfterDays(from, Days(departureDay));
+            const double toAngularPosition = angularPositionAfterDays(to, Days(departureDay));
+            const double fromOrbitalRadius = DistanceUnit::convert(orbitalRadiusAtAngularPosition(from, fromAngularPosition),
+                                                                   DistanceUnit::AU, DistanceUnit::METRES);
+            const double toOrbitalRadius = DistanceUnit::convert(orbitalRadiusAtAngularPosition(to, toAngularPosition),
+                                                                 DistanceUnit::AU, DistanceUnit::METRES);
+            const double fromAngle = AngleUnit::convert(fromAngularPosition, AngleUnit::DEGREES, AngleUnit::RADIANS);
+            const double toAngle = AngleUnit::convert(toAngularPosition, AngleUnit::DEGREES, AngleUnit::RADIANS);
+            fromX = fromOrbitalRadius * std::cos(fromAngle);
+            fromY = fromOrbitalRadius * std::sin(fromAngle);
+            toDepartureX = toOrbitalRadius * std::cos(toAngle);
+            toDepartureY = toOrbitalRadius * std::sin(toAngle);
+        }
+
+        if (computeArrivalPositions) {
+            for (qsizetype j = 0; j < flightTimeCount; ++j) {
+                arrivalDays[j] = departureDay + spec.firstFlightTimeInDays + (firstFlightTime + j) * spec.flightTimeStepInDays;
+            }
+            if (positionsSourced) {
+                for (qsizetype j = 0; j < flightTimeCount; ++j) {
+                    std::tie(arrivalX[j], arrivalY[j]) = cartesianCoordinatesAfterDays(to, Days(arrivalDays[j]));
+                }
+            }
+            else orbitalPositionsAfterDays(to, arrivalDays, {}, arrivalX, arrivalY);
+        }
+
+        double* distances = tile.distances.data() + i * flightTimeCount;
+        double* travelTimes = tile.travelTimes.data() + i * flightTimeCount;
+        for (qsizetype j = 0; j < flightTimeCount; ++j) {
+            // Destination at arrival: its departure position, rotated by the flight time
+            // (or, on an elliptical orbit or from a position source, its own computed position)
+            const double toX = computeArrivalPositions
+                ? arrivalX[j] * metresPerAU
+                : toDepartureX * flightRotationCos[j] - toDepartureY * flightRotationSin[j];
+            const double toY = computeArrivalPositions
+                ? arrivalY[j] * metresPerAU
+                : toDepartureY * flightRotationCos[j] + toDepartureX * flightRotationSin[j];
+
+            const double deltaX = toX - fromX;
+            const double deltaY = toY - fromY;
+            distances[j] = std::sqrt(deltaX * deltaX + deltaY * deltaY) - planetRadii;
+            travelTimes[j] = baseTransfer.totalTravelTime.value() + distances[j] / baseTransfer.cruisingVelocity.value();
+        }
+    }
+
+    return tile;
+}
 
-    return computeTransfer(from, to, rocket, distanceBetweenSurfaces, realisticGravity);
+namespace {
+    using Point = std::pair<double, double>;
+
+    /**
+     * Distance between point `p` and the segment from `a` to `b`.
+     */
+    double distanceToSegment(const Point& p, const Point& a, const Point& b) {
+        const double segmentX = b.first - a.first;
+        const double segmentY = b.second - a.second;
+        const double segmentLengthSquared = segmentX * segmentX + segmentY * segmentY;
+
+        // Project p onto the segment, clamping to its ends
+        double projection = 0;
+        if (segmentLengthSquared > 0) {
+            projection = ((p.first - a.first) * segmentX + (p.second - a.second) * segmentY) / segmentLengthSquared;
+            projection = std::clamp(projection, 0.0, 1.0);
+        }
+
+        const double deltaX = a.first + projection * segmentX - p.first;
+        const double deltaY = a.second + projection * segmentY - p.second;
+        return std::sqrt(deltaX * deltaX + deltaY * deltaY);
+    }
+
+    /**
+     * Time after launch at which a rocket following the given transfer
+     * has travelled `distanceTravelled`.
+     */
+    Seconds timeToTravelDistance(const OrbitalMath::TransferResults& transfer, Metres distanceTravelled) {
+        // In metres and seconds from here on
+        const double velocity = transfer.cruisingVelocity.value();
+        const double accelerationTime = transfer.accelerationTime.value();
+        const double cruisingTime = transfer.cruisingTime.value();
+        double distance = distanceTravelled.value();
+
+        // Accelerating from 0: d = at²/2, with a = v / t_acc
+        if (distance <= transfer.accelerationDistance.value()) {
+            const double acceleration = velocity / accelerationTime;
+            return Seconds(std::sqrt(2 * distance / acceleration));
+        }
+        distance -= transfer.accelerationDistance.value();
+
+        // Cruising
+        const double cruisingDistance = velocity * cruisingTime;
+        if (distance <= cruisingDistance) {
+            return Seconds(accelerationTime + distance / velocity);
+        }
+        distance -= cruisingDistance;
+
+        // Decelerating to 0: d = vt - at²/2, solved for the earliest t
+        const double deceleration = velocity / transfer.decelerationTime.value();
+        const double discriminant = std::max(0.0, velocity * velocity - 2 * deceleration * distance);
+        return Seconds(accelerationTime + cruisingTime + (velocity - std::sqrt(discriminant)) / deceleration);
+    }
+
+    /**
+     * Smallest angle (in degrees, between 0° and 180°) between two angular positions.
+     */
+    double angularSeparation(double firstAngularPosition, double secondAngularPosition) {
+        double separation = std::fmod(std::abs(secondAngularPosition - firstAngularPosition), 360.0);
+        return separation > 180.0 ? 360.0 - separation : separation;
+    }
+
+    /**
+     * Everything needed to check a launch window for collisions,
+     * shared (read-only) by all the worker threads.
+     */
+    struct CollisionCheckContext {
+        const Planet& from;
+        const Planet& to;
+        const Rocket& rocket;
+        const SolarSystem& solarSystem;
+        const OrbitalRadiusIndex& radiusIndex;
+        bool systemStatic;
+    };
+
+    /**
+     * Checks whether a rocket launched at `departureDay` would collide with
+     * any planet on its way. Returns the index of the first planet it would
+     * collide with, or -1 if the trip is collision-free.
+     */
+    qsizetype findCollision(const CollisionCheckContext& context, Days departureDay) {
+        const double fromAngularPosition = OrbitalMath::angularPositionAfterDays(context.from, departureDay);
+
+        // The rocket heads for the destination where it is at launch if the system is static,
+        // or where it will be on arrival otherwise
+        std::optional<OrbitalMath::TransferResults> transfer; // Only needed if the system keeps moving
+        double toAngularPosition;
+        Days arrivalDay = departureDay;
+        if (context.systemStatic) toAngularPosition = OrbitalMath::angularPositionAfterDays(context.to, departureDay);
+        else {
+            const OrbitalMath::InterceptResult intercept = OrbitalMath::solveIntercept(context.from, context.to, context.rocket, departureDay);
+            toAngularPosition = intercept.arrivalAngularPosition;
+            arrivalDay = departureDay + intercept.flightTime;
+            transfer = intercept.transfer;
+        }
+
+        // Planets placed by a position source are taken where it puts them (see surfaceDistance)
+        const bool positionsSourced = nullptr != context.solarSystem.getPositionSource();
+        const Point fromCoords = positionsSourced
+            ? OrbitalMath::cartesianCoordinatesAfterDays(context.from, departureDay)
+            : OrbitalMath::polarToCartesianCoordinates(context.from, fromAngularPosition);
+        const Point toCoords = positionsSourced
+            ? OrbitalMath::cartesianCoordinatesAfterDays(context.to, arrivalDay)
+            : OrbitalMath::polarToCartesianCoordinates(context.to, toAngularPosition);
+
+        // The rocket only ever gets as close to the sun as the closest point of
+        // its path, and as far as the furthest end of it; only planets whose
+        // orbits (plus their own radius) touch that band can get in the way
+        const double closestRadius = distanceToSegment({0.0, 0.0}, fromCoords, toCoords);
+        const double furthestRadius = positionsSourced
+            ? std::max(std::hypot(fromCoords.first, fromCoords.second), std::hypot(toCoords.first, toCoords.second))
+            : std::max(OrbitalMath::orbitalRadiusAtAngularPosition(context.from, fromAngularPosition),
+                       OrbitalMath::orbitalRadiusAtAngularPosition(context.to, toAngularPosition));
+
+        const double pathX = toCoords.first - fromCoords.first;
+        const double pathY = toCoords.second - fromCoords.second;
+        const double pathLength = std::sqrt(pathX * pathX + pathY * pathY);
+
+        QList<qsizetype> obstructingPlanets;
+        context.radiusIndex.findPlanetsInAnnulus(closestRadius, furthestRadius, obstructingPlanets);
+
+        for (const qsizetype i : obstructingPlanets) {
+            if (i == context.from.getIndex() || i == context.to.getIndex()) continue;
+
+            const Planet planet = context.solarSystem.at(i);
+            const double orbitalRadius = planet.getOrbitalRadiusInAU().value();
+            const double eccentricity = planet.getEccentricity().value();
+            const double radius = DistanceUnit::convert(planet.getRadiusInMetres(), DistanceUnit::METRES, DistanceUnit::AU);
+
+            // Moments at which to check the planet's position
+            QList<Days> checkDays;
+            if (context.systemStatic) checkDays.append(departureDay);
+            else {
+                // Check when the rocket crosses the planet's (Keplerian) orbit, i.e. solve
+                // |fromCoords + s * path| = r(s) for s in [0, 1], where r(s) is the
+                // orbit's radius in the direction of the rocket. On an ellipse,
+                // r = a(1 - e²) - e * (periapsis direction · position), which is
+                // linear in s, so this is still a quadratic: r(s) = k0 - k1 * s
+                // (and on a circle, simply r = orbitalRadius).
+                const double periapsisDirection = AngleUnit::convert(
+                    planet.getArgumentOfPeriapsisInDegrees().value(), AngleUnit::DEGREES, AngleUnit::RADIANS);
+                const double periapsisX = std::cos(periapsisDirection);
+                const double periapsisY = std::sin(periapsisDirection);
+                const double k0 = orbitalRadius * (1 - eccentricity * eccentricity)
+                                  - eccentricity * (periapsisX * fromCoords.first + periapsisY * fromCoords.second);
+                const double k1 = eccentricity * (periapsisX * pathX + periapsisY * pathY);
+
+                const double a = pathX * pathX + pathY * pathY - k1 * k1;
+                const double b = 2 * (fromCoords.first * pathX + fromCoords.second * pathY) + 2 * k0 * k1;
+                const double c = fromCoords.first * fromCoords.first + fromCoords.second * fromCoords.second
+                                 - k0 * k0;
+                const double discriminant = b * b - 4 * a * c;
+
+                if (discriminant >= 0 && a != 0) {
+                    for (const double s : { (-b - std::sqrt(discriminant)) / (2 * a), (-b + std::sqrt(discriminant)) / (2 * a) }) {
+                        if (s < 0 || s > 1 || k0 - k1 * s < 0) continue;
+
+                        const Metres distanceTravelled = AstronomicalUnits(s * pathLength) - Metres(context.from.getRadiusInMetres());
+                        checkDays.append(departureDay + timeToTravelDistance(transfer.value(), std::max(Metres(0), distanceTravelled)));
+                    }
+                }
+                // Orbit only grazed (within the planet's radius): check at launch
+                if (checkDays.empty()) checkDays.append(departureDay);
+            }
+
+            for (const Days checkDay : checkDays) {
+                const Point coords = OrbitalMath::cartesianCoordinatesAfterDays(planet, checkDay);
+                if (distanceToSegment(coords, fromCoords, toCoords) < radius) return i;
+            }
+        }
+
+        return -1;
+    }
+
+    /**
+     * Finds the first (in list order) collision-free launch day among
+     * `candidateDays`. Candidates are checked in parallel, in batches, so
+     * that we can stop early once a batch contains a collision-free one.
+     *
+     * Also returns the collisions found for the checked candidates (-1 for
+     * collision-free ones), in list order.
+     */
+    std::pair<std::optional<qsizetype>, QList<qsizetype>>
+    findFirstCollisionFree(const CollisionCheckContext& context, const QList<Days>& candidateDays) {
+        const qsizetype batchSize = std::max(16, QThread::idealThreadCount() * 4);
+        QList<qsizetype> collisions;
+
+        for (qsizetype batchStart = 0; batchStart < candidateDays.size(); batchStart += batchSize) {
+            const QList<Days> batch = candidateDays.mid(batchStart, batchSize);
+            collisions.append(QtConcurrent::blockingMapped<QList<qsizetype>>(batch, [&context](Days departureDay) {
+                return findCollision(context, departureDay);
+            }));
+
+            for (qsizetype i = batchStart; i < collisions.size(); ++i) {
+                if (-1 == collisions[i]) return { i, collisions };
+            }
+        }
+
+        return { std::nullopt, collisions };
+    }
 }
 
 OrbitalMath::TransferPlanning
 OrbitalMath::planTransfer(
-    const Planet& from, const Planet& to, const Rocket& rocket, const QList<Planet>& solarSystem,
-    double timeframeStart, double timeframeEnd, bool systemStatic
+    const Planet& from, const Planet& to, const Rocket& rocket, const SolarSystem& solarSystem,
+    Years timeframeStart, Years timeframeEnd, bool systemStatic
     ) {
 
     // Step 1: compute initial angular positions of planets
-    // Note: assuming angular positions of planets at time 0 as 0°
-    const double daysToTimeframeStart = TimeUnit::convert(timeframeStart, TimeUnit::YEARS, TimeUnit::DAYS);
-    const double fromStartAngularPosition = OrbitalMath::angularPositionAfterDays(from, daysToTimeframeStart, 0.0);
-    const double toStartAngularPosition = OrbitalMath::angularPositionAfterDays(to, daysToTimeframeStart, 0.0);
+    // Note: planets start where their orbital elements put them at time 0
+    // The search below works in days; results go back to years once, when stored
+    const Days daysToTimeframeStart = timeframeStart;
+    const Days daysToTimeframeEnd = timeframeEnd;
+    const double fromStartAngularPosition = OrbitalMath::angularPositionAfterDays(from, daysToTimeframeStart);
+    const double toStartAngularPosition = OrbitalMath::angularPositionAfterDays(to, daysToTimeframeStart);
 
     // Step 2: find closest-approach time with no restrictions; this is the theoretical best
-    const double daysUntilAligned = OrbitalMath::daysUntilAligned(from, fromStartAngularPosition, to, toStartAngularPosition);
-    const double theoreticalBest = timeframeStart + TimeUnit::convert(daysUntilAligned, TimeUnit::DAYS, TimeUnit::YEARS);
+    // Looked up in the solar system's alignment cache, if that is up to date
+    // (alignments are those of the mean angular positions, see daysUntilAligned)
+    const AlignmentCache* alignmentCache = solarSystem.getAlignmentCache();
+    const Days daysUntilAligned = nullptr != alignmentCache
+        ? alignmentCache->nextAlignmentAfter(from.getIndex(), to.getIndex(), daysToTimeframeStart) - daysToTimeframeStart
+        : OrbitalMath::daysUntilAligned(from, OrbitalMath::meanAngularPositionAfterDays(from, daysToTimeframeStart),
+                                        to, OrbitalMath::meanAngularPositionAfterDays(to, daysToTimeframeStart));
+
+    TransferPlanning planning;
+    planning.theoreticalBestStartTime = timeframeStart + daysUntilAligned;
+    planning.isTheoreticalBestValid = false;
+    planning.isPracticalBestCollisionFree = false;
 
     // Step 3: find closest-approach times within timeframe; these are potential "ideal" candidates
-    // TODO
-    // likely steps:
-    // - compute least common multiple of orbital periods
-    // - skip forward from theoretical best one realignment period at a time until out of the timeframe
+    // The planets realign once every synodic period, i.e. every time their angular
+    // delta has grown by a full 360°
+    const double angularVelocityDelta = std::abs(angularVelocity(to) - angularVelocity(from));
+    const Days synodicPeriod = nullptr != alignmentCache
+        ? alignmentCache->synodicPeriod(from.getIndex(), to.getIndex())
+        : Days(360.0 / angularVelocityDelta); // Infinite if planets never realign
+
+    QList<Days> alignmentDays;
+    if (std::isfinite(daysUntilAligned.value())) {
+        const Days firstAlignmentDay = daysToTimeframeStart + daysUntilAligned;
+        Days alignmentDay = firstAlignmentDay;
+        for (qsizetype k = 1; alignmentDay <= daysToTimeframeEnd; ++k) {
+            alignmentDays.append(alignmentDay);
+            alignmentDay = firstAlignmentDay + double(k) * synodicPeriod; // Infinite if the planets only align once
+        }
+    }
 
     // Step 4: take them one-by-one and check them for collisions; if any is safe, that's the practical best
-    // TODO
-    // likely steps:
-    // - filter `solarSystem` for planets with orbitalRadius between `to` and `from`
-    // - if none are found, first launch window is automatically good
-    // - for each possible launch window:
-    // - - for each planet in the filtered list:
-    // - - - compute position at the given time
-    // - - - compute distance between planet and the to-from line (if to-from line needs to be formulated, can do that only-once earlier)
-    // - - - if distance is less than planet's radius, we have a collision; current launch window is invalid, skip
-    // - - if no collisions found, launch window is good, break out of loop
+    // Potential obstructors are looked up in the solar system's orbital radius index,
+    // or in a temporary one if that is out of date
+    std::optional<OrbitalRadiusIndex> temporaryRadiusIndex;
+    const OrbitalRadiusIndex* radiusIndex = solarSystem.getOrbitalRadiusIndex();
+    if (nullptr == radiusIndex) radiusIndex = &temporaryRadiusIndex.emplace(solarSystem);
+
+    const CollisionCheckContext context { from, to, rocket, solarSystem, *radiusIndex, systemStatic };
+    const auto [firstCollisionFreeAlignment, alignmentCollisions] = findFirstCollisionFree(context, alignmentDays);
+
+    if (alignmentDays.empty()) {
+        planning.reasonTheoreticalBestInvalid = "Out of timeframe";
+    }
+    else if (-1 != alignmentCollisions.first()) {
+        planning.reasonTheoreticalBestInvalid = QString("Collision with %1").arg(solarSystem.getName(alignmentCollisions.first()));
+    }
+    else planning.isTheoreticalBestValid = true;
+
+    if (firstCollisionFreeAlignment.has_value()) {
+        planning.practicalBestStartTime = alignmentDays[firstCollisionFreeAlignment.value()];
+        planning.isPracticalBestCollisionFree = true;
+        return planning;
+    }
 
     // Step 5: if none work (out of timeframe or collisions), take the first closest approach within the timeframe
     //         and try adjusting the launch earlier (earlier and later should work the same, and we prefer earlier;
     //         if earlier goes out of timeframe, though, try later) as needed until we dodge collisions
-    // TODO
-    // likely steps:
-    // - hmm
-    // considerations:
-    // - if you're looking for "shortest travel time", you'd need to do some fancy analysis on the collisions to
-    //   decide which one can be "fixed" with the smallest desync (= extra distance) between the planets
-    // - if you don't care that much about travel time as long as it's not the optimal one, you're probably best
-    //   off taking the first alignment time within the timeframe (maybe check the first one *before* the timeframe
-    //   too?) an searching for a good solution around that one (e.g. a bit earlier / a bit later)
-    // - for maximal mathematical rigor, you should compute the "collision window" of any given collision, then skip
-    //   exactly that far earlier/later
+    // If the planets never align within the timeframe, the closest they get is at either end of it
+    // (see shortestDistanceConstrained), so we start from there instead.
+    Days anchorDay;
+    if (!alignmentDays.empty()) anchorDay = alignmentDays.first();
+    else {
+        const double startSeparation = angularSeparation(fromStartAngularPosition, toStartAngularPosition);
+        const double endSeparation = angularSeparation(
+            OrbitalMath::angularPositionAfterDays(from, daysToTimeframeEnd),
+            OrbitalMath::angularPositionAfterDays(to, daysToTimeframeEnd)
+            );
+        anchorDay = startSeparation <= endSeparation ? daysToTimeframeStart : daysToTimeframeEnd;
+    }
+    planning.practicalBestStartTime = anchorDay;
+
+    if (0 == angularVelocityDelta) return planning; // Alignment never changes, nothing to search
+
+    // Search in steps of 0.25° of relative drift between the planets, up to half a
+    // synodic period away (further than that, we'd be closer to the next alignment).
+    // Candidates are ordered by preference: closest first, earlier before later.
+    static const double SEARCH_STEP_IN_DEGREES = 0.25;
+    const Days searchStep = Days(SEARCH_STEP_IN_DEGREES / angularVelocityDelta);
+    const qsizetype maximumSteps = 180.0 / SEARCH_STEP_IN_DEGREES;
+
+    QList<Days> nearAlignmentDays;
+    for (qsizetype step = 1; step <= maximumSteps; ++step) {
+        const Days earlierDay = anchorDay - double(step) * searchStep;
+        const Days laterDay = anchorDay + double(step) * searchStep;
+        if (earlierDay >= daysToTimeframeStart) nearAlignmentDays.append(earlierDay);
+        if (laterDay <= daysToTimeframeEnd) nearAlignmentDays.append(laterDay);
+    }
+
+    const auto [firstCollisionFreeNearAlignment, nearAlignmentCollisions] = findFirstCollisionFree(context, nearAlignmentDays);
+    if (firstCollisionFreeNearAlignment.has_value()) {
+        planning.practicalBestStartTime = nearAlignmentDays[firstCollisionFreeNearAlignment.value()];
+        planning.isPracticalBestCollisionFree = true;
+    }
+
+    return planning;
 }
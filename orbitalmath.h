@@ -2,19 +2,44 @@
 #define ORBITALMATH_H
 
 #include "planet.h"
+#include "quantity.h"
 #include "rocket.h"
+#include "solarsystem.h"
+
+#include <cmath>
+#include <span>
 
 namespace OrbitalMath {
 
+    /**
+     * Gravitational constant, in m³/kg*s².
+     */
+    constexpr double GRAVITATIONAL_CONSTANT = 6.67e-11;
+
     /**
      * Computes the escape velocity for the given planet
      * in metres per second.
      */
     double escapeVelocity(const Planet& planet);
 
+    /**
+     * Batched version of `escapeVelocity`: computes the escape
+     * velocities (in metres per second) of many planets at once,
+     * given their masses (in kilograms) and radii (in metres).
+     * `radius` and `out` must be at least as long as `mass`.
+     *
+     * Uses AVX-512 or AVX2 kernels when the CPU supports them (picked
+     * at runtime), and a scalar loop otherwise. Every path performs the
+     * same correctly-rounded operations in the same order as
+     * `escapeVelocity`, so results match the scalar function exactly
+     * (0 ULP difference).
+     */
+    void escapeVelocities(std::span<const double> mass, std::span<const double> radius, std::span<double> out);
+
     /**
      * Computes the angular orbital velocity for the given
-     * planet in degrees per day
+     * planet in degrees per day. For elliptical orbits, this
+     * is the mean angular velocity (over a whole orbit).
      */
     double angularVelocity(const Planet& planet);
 
@@ -66,12 +91,39 @@ namespace OrbitalMath {
         );
 
     /**
-     * Computes the time, in days, until two planets are aligned
+     * Batched version of `computeAccelerationValues`: computes the
+     * acceleration time (in seconds) and distance (in metres) for the
+     * rocket to reach each of the given target velocities. The initial
+     * velocity and ambient acceleration are shared by all targets.
+     * `accelerationTimes` and `accelerationDistances` must be at least
+     * as long as `targetVelocities`.
+     *
+     * Dispatches to AVX-512 / AVX2 / scalar code like `escapeVelocities`.
+     * Times match the scalar function exactly. Distances match exactly
+     * as well on x86-64; on platforms where the compiler fuses the
+     * scalar multiply-add (e.g. ARM), they may differ by up to 2 ULP.
+     */
+    void computeAccelerationValues(
+        const Rocket& rocket,
+        std::span<const double> targetVelocities,
+        std::span<double> accelerationTimes,
+        std::span<double> accelerationDistances,
+        double initialVelocity = 0,
+        double ambientAcceleration = 0
+        );
+
+    /**
+     * Computes the time until two planets are aligned
      * (i.e. their angular positions are identical), given their
      * initial angular positions (expressed as degrees of rotation
      * around the sun in their orbits)
+     *
+     * Planets are assumed to move at their mean angular velocity,
+     * which is exact for circular orbits only. For elliptical ones,
+     * pass mean angular positions (see `meanAngularPositionAfterDays`)
+     * to get the alignments of those.
      */
-    double daysUntilAligned(const Planet& first, double firstAngularPosition, const Planet& second, double secondAngularPosition);
+    Days daysUntilAligned(const Planet& first, double firstAngularPosition, const Planet& second, double secondAngularPosition);
 
     /**
      * Computes the shortest distance, in AU, between two planets' surfaces.
@@ -81,6 +133,10 @@ namespace OrbitalMath {
      * If the planets cannot align (e.g. because there is a constant
      * angular position difference between them or because there is
      * a limited timeframe to work with), use `shortestDistanceConstrained` instead.
+     *
+     * For elliptical orbits, the planets could align at any angular position,
+     * so this is the smallest gap between the orbits along any direction
+     * (searched in steps of 0.1°).
      */
     double shortestDistance(const Planet& from, const Planet& to);
 
@@ -88,31 +144,108 @@ namespace OrbitalMath {
      * Computes the shortest distance, in AU, between two planets' surfaces.
      * Takes into account their initial angular positions (expressed
      * as degrees of rotation around the sun in their orbits), as
-     * well as a maximum timeframe (expressed in days) that can be
-     * waited for in order for the planets to better align.
+     * well as a maximum timeframe that can be waited for in order
+     * for the planets to better align.
      */
     double shortestDistanceConstrained(
         const Planet& from,
         double fromAngularPosition,
         const Planet& to,
         double toAngularPosition,
-        double maximumTimeframe
+        Days maximumTimeframe
         );
 
     /**
      * Computes the new angular position (expressed in degrees of
      * rotation around the sun) of a planet after an amount of
-     * time (given in days) has elapsed.
+     * time has elapsed.
+     *
+     * Without an initial angular position, starts from where the
+     * planet's orbital elements put it at time 0 (0° for circular
+     * orbits with default elements, see `SolarSystem::setOrbitalCharacteristics`).
+     *
+     * For elliptical orbits, the planet moves faster near its periapsis
+     * (Kepler's second law); positions are found by solving Kepler's
+     * equation (see `eccentricAnomaly`) and normalized to [0°, 360°).
+     * If the planet's solar system has an ephemeris cache covering the day
+     * (see `SolarSystem::buildEphemerisCache`), those positions (without an
+     * initial angular position) are read from there instead, to within the
+     * cache's tolerance. If it has a position source covering the planet and
+     * day (see `SolarSystem::setPositionSource`), they come from that instead.
+     */
+    double angularPositionAfterDays(const Planet& planet, Days daysElapsed, double initialAngularPosition = NAN);
+
+    /**
+     * Computes the cartesian coordinates (see `polarToCartesianCoordinates`)
+     * of a planet at the given day, starting from where its orbital elements
+     * put it at time 0. Uses the ephemeris cache and position source like
+     * `angularPositionAfterDays`. Planets without orbital data get NaN coordinates.
+     */
+    std::pair<double, double> cartesianCoordinatesAfterDays(const Planet& planet, Days daysElapsed);
+
+    /**
+     * Computes the mean angular position (in degrees) of a planet at the
+     * given day: where it would be if it moved at its mean angular velocity.
+     * Identical to `angularPositionAfterDays` for circular orbits.
+     * Planets without orbital data get NaN.
+     */
+    double meanAngularPositionAfterDays(const Planet& planet, Days daysElapsed);
+
+    /**
+     * Solves Kepler's equation M = E - e*sin(E) for the eccentric anomaly E
+     * (in radians), given the mean anomaly M (in radians) and the
+     * eccentricity e (in [0, 1)). M is first reduced to [-π, π], and E is
+     * returned in the same range. Gives E = M exactly for circular orbits.
+     *
+     * Uses Halley's method from Danby's starting guess, which converges to
+     * full precision in 3 iterations for most inputs (6 at most for
+     * eccentricities up to 0.999).
+     */
+    double eccentricAnomaly(double meanAnomaly, double eccentricity);
+
+    /**
+     * Batched version of `eccentricAnomaly`, for many bodies at once.
+     * `eccentricities` and `out` must be at least as long as `meanAnomalies`.
+     *
+     * Dispatches to AVX-512 / AVX2 / scalar code like `escapeVelocities`
+     * (with a polynomial sine and cosine, since the C library's are not
+     * vectorized). Results match the scalar function exactly.
      */
-    double angularPositionAfterDays(const Planet& planet, double daysElapsed, double initialAngularPosition = 0);
+    void eccentricAnomalies(std::span<const double> meanAnomalies, std::span<const double> eccentricities, std::span<double> out);
+
+    /**
+     * Computes the angular positions (in degrees, normalized to [0°, 360°))
+     * and/or cartesian coordinates (in AU, see `polarToCartesianCoordinates`)
+     * of a planet at many days at once, from its orbital elements. Outputs
+     * left empty are not computed; the others must be at least as long as
+     * `days`.
+     *
+     * Works for any orbit, using the batched Kepler solver (see
+     * `eccentricAnomalies`). Matches `angularPositionAfterDays` up to rounding.
+     * Planets without orbital data get NaN for every output.
+     */
+    void orbitalPositionsAfterDays(
+        const Planet& planet,
+        std::span<const double> days,
+        std::span<double> angularPositions,
+        std::span<double> x = {},
+        std::span<double> y = {}
+        );
+
+    /**
+     * Computes a planet's distance (in AU) from the sun when it is at the
+     * given angular position (in degrees). Equal to its orbital radius for
+     * circular orbits.
+     */
+    double orbitalRadiusAtAngularPosition(const Planet& planet, double angularPosition);
 
     /**
      * Converts a planet's position from a polar coordinate
-     * system (given by its orbital radius and angular position
-     * in its orbit given in degrees) to a cartesian coordinate
-     * system with (0,0) origin at the sun, 0° corresponding to the
-     * direction of the positive X axis (like in trigonometry), and
-     * distances expressed in AU.
+     * system (given by its angular position in its orbit given
+     * in degrees, and the orbital radius at that position) to a
+     * cartesian coordinate system with (0,0) origin at the sun, 0°
+     * corresponding to the direction of the positive X axis (like
+     * in trigonometry), and distances expressed in AU.
      *
      * E.g. if the Earth (orbital radius 1 AU) were at 150° in its
      * rotation around the sun, this function would return coordinates
@@ -121,11 +254,235 @@ namespace OrbitalMath {
     std::pair<double, double> polarToCartesianCoordinates(const Planet& planet, double angularPosition);
 
     /**
-     * Computes the distance, in AU, between the centres of two given planets.
+     * A grid of planet positions sampled at regularly spaced
+     * moments in time (see `ephemerisGrid`).
+     *
+     * Values are stored one row per planet, one column per time
+     * step, i.e. the value for planet `i` at step `j` is at index
+     * `i * stepCount + j`. Rows for planets lacking orbital data
+     * are filled with NaN.
+     */
+    struct EphemerisGrid {
+        /**
+         * Number of planets (rows) in the grid.
+         */
+        qsizetype planetCount = 0;
+
+        /**
+         * Number of time steps (columns) in the grid.
+         */
+        qsizetype stepCount = 0;
+
+        /**
+         * Time (in days) of the first column.
+         */
+        double startDay = 0;
+
+        /**
+         * Time (in days) between two consecutive columns.
+         */
+        double stepInDays = 0;
+
+        /**
+         * Angular positions (in degrees, normalized to [0°, 360°)).
+         */
+        AlignedVector<double> angularPositions;
+
+        /**
+         * Cartesian coordinates (in AU, see `polarToCartesianCoordinates`).
+         * Empty unless requested.
+         */
+        AlignedVector<double> x;
+        AlignedVector<double> y;
+
+        double angularPosition(qsizetype planetIndex, qsizetype step) const {
+            return angularPositions[planetIndex * stepCount + step];
+        }
+    };
+
+    /**
+     * Computes the angular positions of all planets in `planets`
+     * at `steps` moments in time, starting at `startDay` and spaced
+     * `stepInDays` days apart (starting from where their orbital
+     * elements put them at time 0). Optionally also computes their
+     * cartesian coordinates.
+     *
+     * Equivalent to calling `angularPositionAfterDays` for every planet
+     * and step (up to rounding in the 360° reduction, below 1e-9° for
+     * any realistic time span), but precomputes the angular velocities
+     * once and fills the grid in cache-sized blocks with vectorized
+     * kernels (see `escapeVelocities` for how those are picked).
+     * Elliptical orbits go through `orbitalPositionsAfterDays`, or the
+     * ephemeris cache if the solar system has one covering the grid's days.
+     * Planets the solar system's position source covers (see `PositionSource`)
+     * are taken from it instead.
+     */
+    EphemerisGrid ephemerisGrid(
+        const SolarSystem& planets,
+        double startDay,
+        double stepInDays,
+        qsizetype steps,
+        bool computeCartesianCoordinates = false
+        );
+
+    /**
+     * Computes the distance between the centres of two given planets.
      * Takes into account their current angular positions, expressed
      * as degrees of rotation around the sun in their orbits.
      */
-    double distance(const Planet& from, double fromAngularPosition, const Planet& to, double toAngularPosition);
+    AstronomicalUnits distance(const Planet& from, double fromAngularPosition, const Planet& to, double toAngularPosition);
+
+    /**
+     * Computes the distance between the *surfaces* of two given planets,
+     * from angular positions as `computeSimpleTransfer` takes them
+     * (missing ones come from the orbital elements, and all are adjusted
+     * by `daysElapsed`). If both are missing and the solar system has a
+     * position source, the planets are taken wherever it puts them.
+     */
+    Metres surfaceDistance(
+        const Planet& from,
+        const Planet& to,
+        double fromAngularPosition = NAN,
+        double toAngularPosition = NAN,
+        Days daysElapsed = Days(0)
+        );
+
+    /**
+     * Settings for the computation of launch and landing phases under
+     * realistic gravity (see `integrateLaunch`).
+     */
+    struct GravityIntegrationSettings {
+        /**
+         * Maximum error, relative to the size of the result. With
+         * `integrateNumerically`, the maximum error per step, relative to
+         * the size of the state (distance from the planet's centre and
+         * velocity).
+         */
+        double relativeTolerance = 1e-9;
+
+        /**
+         * Maximum error per step of the numerical integration, in metres for
+         * distances and metres per second for velocities, when those are small.
+         */
+        double absoluteTolerance = 1e-6;
+
+        /**
+         * Once the planet's gravity drops below this fraction of the rocket's
+         * acceleration, the rest of a numerically integrated phase is computed
+         * in closed form.
+         */
+        double farFieldGravityRatio = 1e-3;
+
+        /**
+         * Maximum number of integration steps (accepted or rejected) before
+         * giving up.
+         */
+        int maximumSteps = 100000;
+
+        /**
+         * Whether to integrate phases step by step rather than solve them in
+         * closed form (see `integrateLaunch`). Much slower; mostly useful to
+         * check the closed form against.
+         */
+        bool integrateNumerically = false;
+
+        /**
+         * Whether phases computed recently may be reused (see
+         * `integrateLaunch`). Turn off to measure what computing them costs.
+         */
+        bool reuseRecentPhases = true;
+    };
+
+    /**
+     * A packed result storing the outcome of an integrated launch
+     * (or landing) phase (see `integrateLaunch`).
+     */
+    struct GravityPhaseResult {
+        /**
+         * Time (in seconds) for the rocket to reach the target velocity.
+         */
+        double accelerationTime;
+
+        /**
+         * Distance (in metres) from the planet's surface at which the
+         * rocket reaches the target velocity.
+         */
+        double accelerationDistance;
+
+        /**
+         * Number of steps taken (integration steps, or duplication steps of
+         * the elliptic integrals for the closed form), and how many of them
+         * were rejected (and retried with a smaller step).
+         */
+        int steps;
+        int rejectedSteps;
+
+        /**
+         * Whether a numerically integrated phase ended in the closed-form far field.
+         */
+        bool reachedFarField;
+
+        /**
+         * Whether the phase was reused from an earlier call rather than
+         * computed (in which case no steps were taken).
+         */
+        bool reused;
+    };
+
+    /**
+     * Computes the time and distance for a rocket to launch from the surface
+     * of a planet and accelerate straight up to `targetVelocity`, taking the
+     * planet's gravity (which weakens with distance) into account.
+     *
+     * The motion has an energy integral, so the distance is found in closed
+     * form, and the time as an elliptic integral evaluated with Carlson's
+     * duplication algorithm to `GravityIntegrationSettings::relativeTolerance`.
+     *
+     * With `GravityIntegrationSettings::integrateNumerically`, the motion near
+     * the planet is instead integrated with an adaptive-step Dormand–Prince
+     * RK45 integrator, within the tolerances given in `settings`. Once gravity
+     * becomes negligible (see `GravityIntegrationSettings::farFieldGravityRatio`),
+     * the rest of the phase is computed in closed form: distance from the
+     * energy integral, time as if acceleration were constant from there on.
+     *
+     * Landing is the exact time-mirror of launching (the rocket brakes
+     * against gravity rather than pushing against it), so the same function
+     * gives the time and distance to decelerate from `targetVelocity` down
+     * to a landing at 0.
+     *
+     * If the rocket is too weak to lift off, time and distance are infinite.
+     *
+     * The last few phases computed are remembered (per thread), since a phase
+     * does not depend on the rest of the transfer: batched computations over the
+     * same planets only pay for them once. Reused phases report no
+     * steps (see `GravityPhaseResult::reused`).
+     */
+    GravityPhaseResult integrateLaunch(
+        const Rocket& rocket,
+        const Planet& planet,
+        double targetVelocity,
+        const GravityIntegrationSettings& settings = GravityIntegrationSettings()
+        );
+
+    /**
+     * Statistics on the realistic gravity integration of a transfer
+     * (see `computeTransfer`).
+     */
+    struct GravityIntegrationReport {
+        int launchSteps = 0;
+        int landingSteps = 0;
+        int rejectedSteps = 0;
+        bool launchReachedFarField = false;
+        bool landingReachedFarField = false;
+        bool launchReused = false;
+        bool landingReused = false;
+
+        /**
+         * Wall-clock time (in seconds) spent integrating, which for reused
+         * phases is only the time to look them up.
+         */
+        double integrationTime = 0;
+    };
 
     /**
      * A packed result storing data about a transfer maneuver
@@ -140,50 +497,55 @@ namespace OrbitalMath {
      * - total travel time
      *
      * All distances are expressed in metres, all times are expressed
-     * in seconds, cruising velocity is expressed in metres per second.
+     * in seconds, cruising velocity is expressed in metres per second
+     * (and typed as such).
      */
     struct TransferResults {
         /**
-         * Velocity (in metres per second) that the rocket travels at
-         * between the initial acceleration and the final deceleration.
+         * Velocity that the rocket travels at between the initial
+         * acceleration and the final deceleration.
          */
-        double cruisingVelocity;
+        MetresPerSecond cruisingVelocity;
 
         /**
-         * Time (in seconds) for the rocket to reach cruising velocity
-         * at the start of the transfer
+         * Time for the rocket to reach cruising velocity at the start
+         * of the transfer
          */
-        double accelerationTime;
+        Seconds accelerationTime;
 
         /**
-         * Distance (in metres) that the rocket travels until reaching
-         * cruising velocity at the start of the transfer.
+         * Distance that the rocket travels until reaching cruising
+         * velocity at the start of the transfer.
          */
-        double accelerationDistance;
+        Metres accelerationDistance;
 
         /**
-         * Total time (in seconds) that the rocket spends moving at
-         * cruising velocity.
+         * Total time that the rocket spends moving at cruising velocity.
          */
-        double cruisingTime;
+        Seconds cruisingTime;
 
         /**
-         * Time (in seconds) for the rocket to decelerate from cruising
-         * velocity to zero at the end of the transfer.
+         * Time for the rocket to decelerate from cruising velocity to
+         * zero at the end of the transfer.
          */
-        double decelerationTime;
+        Seconds decelerationTime;
 
         /**
-         * Distance (in metres) that the rocket travels while decelerating
-         * from cruising velocity to zero at the end of the transfer.
+         * Distance that the rocket travels while decelerating from
+         * cruising velocity to zero at the end of the transfer.
          */
-        double decelerationDistance;
+        Metres decelerationDistance;
 
         /**
-         * Total duration (in seconds) of the transfer, including acceleration,
+         * Total duration of the transfer, including acceleration,
          * cruising, and deceleration.
          */
-        double totalTravelTime;
+        Seconds totalTravelTime;
+
+        /**
+         * Integration statistics. All zero unless realistic gravity was enabled.
+         */
+        GravityIntegrationReport gravityIntegration = {};
     };
 
     /**
@@ -195,25 +557,28 @@ namespace OrbitalMath {
      * velocities of the two planets
      * - rocket decelerates when approaching second planet, such
      * as to land on its surface with velocity zero
-     * - the `realisticGravity` flag currently does nothing
-     * (Ideally, if realistic gravity was enabled then the
-     * computation would include the effect of planets'
-     * gravities on the acceleration and deceleration efforts.)
+     * - if `realisticGravity` is enabled, the acceleration and
+     * deceleration phases include the effect of the planets'
+     * gravities (see `integrateLaunch`), and the integration
+     * statistics are reported in the results; otherwise
+     * gravity is ignored
      *
      * @param from - the starting/source planet
      * @param to - the destination/target planet
      * @param rocket - the rocket used for the transfer
      * @param totalDistance - the distance the rocket must
-     * travel, given in metres
+     * travel
      * @param realisticGravity - whether to use (more) realistic
      * gravity for acceleration calculations
+     * @param gravitySettings - integration settings for realistic gravity
      */
     TransferResults computeTransfer(
         const Planet& from,
         const Planet& to,
         const Rocket& rocket,
-        double totalDistance,
-        bool realisticGravity = false
+        Metres totalDistance,
+        bool realisticGravity = false,
+        const GravityIntegrationSettings& gravitySettings = GravityIntegrationSettings()
         );
 
     /**
@@ -223,22 +588,354 @@ namespace OrbitalMath {
      *
      * Optionally accepts initial angular positions (expressed as degrees
      * of rotation around the sun) for the planets and will compute distance
-     * between them based on these. If `daysElapsed` is given, the angular
-     * positions will be adjusted based on the elapsed time first.
+     * between them based on these; without them, the planets start where
+     * their orbital elements put them at time 0. If `daysElapsed` is given,
+     * the angular positions will be adjusted based on the elapsed time first.
      *
-     * The `realisticGravity` flag currently does nothing. (Ideally, if
-     * realistic gravity was enabled then the computation would include the
-     * effects of planets' gravities on the acceleration and deceleration
-     * efforts.)
+     * The `realisticGravity` flag and `gravitySettings` are passed on to
+     * `computeTransfer`.
      */
     TransferResults computeSimpleTransfer(
         const Planet& from,
         const Planet& to,
         const Rocket& rocket,
-        double fromAngularPosition = 0,
-        double toAngularPosition = 0,
-        double daysElapsed = 0,
-        bool realisticGravity = false
+        double fromAngularPosition = NAN,
+        double toAngularPosition = NAN,
+        Days daysElapsed = Days(0),
+        bool realisticGravity = false,
+        const GravityIntegrationSettings& gravitySettings = GravityIntegrationSettings()
+        );
+
+    /**
+     * Travel data (see `TransferResults`) for many variations of the same
+     * transfer, one column per field (see `computeTransfers`).
+     */
+    struct TransferBatch {
+        AlignedVector<double> cruisingVelocities;
+        AlignedVector<double> accelerationTimes;
+        AlignedVector<double> accelerationDistances;
+        AlignedVector<double> cruisingTimes;
+        AlignedVector<double> decelerationTimes;
+        AlignedVector<double> decelerationDistances;
+        AlignedVector<double> totalTravelTimes;
+    };
+
+    /**
+     * Batched version of `computeTransfer` (without realistic gravity) for
+     * many variations of a transfer over `totalDistance` metres: for each
+     * variation i, the planets have escape velocities `fromEscapeVelocities[i]`
+     * and `toEscapeVelocities[i]` (see `escapeVelocities`), and the rocket
+     * accelerates at `rocketAccelerations[i]` (see `totalAcceleration`).
+     * `toEscapeVelocities` and `rocketAccelerations` must be at least as long
+     * as `fromEscapeVelocities`; `out` is resized to fit.
+     *
+     * Performs the same operations as `computeTransfer`, so results match
+     * it exactly (on x86-64, see `computeAccelerationValues`).
+     */
+    void computeTransfers(
+        std::span<const double> fromEscapeVelocities,
+        std::span<const double> toEscapeVelocities,
+        std::span<const double> rocketAccelerations,
+        double totalDistance,
+        TransferBatch& out
+        );
+
+    /**
+     * A packed result storing the solution of an intercept problem
+     * (see `solveIntercept`).
+     */
+    struct InterceptResult {
+        /**
+         * Flight time after which the rocket meets the destination planet.
+         */
+        Days flightTime;
+
+        /**
+         * Angular position (in degrees) of the destination planet at the
+         * moment the rocket arrives.
+         */
+        double arrivalAngularPosition;
+
+        /**
+         * Travel data for the transfer, covering the distance between the start
+         * planet at departure and the destination planet at arrival.
+         */
+        TransferResults transfer;
+
+        /**
+         * Number of iterations it took to converge (or to give up).
+         */
+        int iterations;
+
+        /**
+         * Whether the flight time converged to within `INTERCEPT_TOLERANCE`.
+         * If not, the other fields hold the last iterate.
+         */
+        bool converged;
+    };
+
+    /**
+     * Flight time accuracy that `solveIntercept` iterates until.
+     */
+    constexpr Days INTERCEPT_TOLERANCE = Days(1e-6);
+
+    /**
+     * Maximum number of iterations `solveIntercept` takes before giving up.
+     */
+    constexpr int INTERCEPT_MAXIMUM_ITERATIONS = 50;
+
+    /**
+     * Computes a transfer (see `computeSimpleTransfer`) towards a moving destination:
+     * the rocket launches at `departureDay` and heads for the point where the
+     * destination planet will be when the rocket gets there, i.e. the flight time T
+     * satisfies T = travel time for the distance to the destination at `departureDay` + T.
+     *
+     * Solved with a secant iteration on that equation, falling back to bisection
+     * once the solution is bracketed, so that it converges in a few steps. Without
+     * a guess, it starts from a flight time of 0 and finds the first intercept.
+     * Given `initialFlightTime` (e.g. the solution for a nearby departure),
+     * it starts from there instead, which usually takes only a couple of steps.
+     *
+     * Planets start where their orbital elements put them at time 0, or are
+     * wherever the solar system's position source puts them.
+     */
+    InterceptResult solveIntercept(
+        const Planet& from,
+        const Planet& to,
+        const Rocket& rocket,
+        Days departureDay,
+        Days initialFlightTime = Days(NAN)
+        );
+
+    /**
+     * Batched version of `solveIntercept`: solves the intercepts for many departure
+     * days at once. `results` must be at least as long as `departureDays`.
+     *
+     * Departures are split into chunks solved in parallel on the global thread
+     * pool. Within a chunk, each departure starts from the previous one's solution,
+     * so sorted, closely spaced departures converge fastest.
+     */
+    void solveIntercepts(
+        const Planet& from,
+        const Planet& to,
+        const Rocket& rocket,
+        std::span<const double> departureDays,
+        std::span<InterceptResult> results
+        );
+
+    /**
+     * Describes the grid of a porkchop plot: launch times (departure days)
+     * along one axis, flight times along the other, both regularly spaced.
+     * All times are expressed in days.
+     */
+    struct PorkchopGridSpec {
+        double firstDepartureDay = 0;
+        double departureStepInDays = 1;
+        qsizetype departureCount = 0;
+
+        double firstFlightTimeInDays = 0;
+        double flightTimeStepInDays = 1;
+        qsizetype flightTimeCount = 0;
+    };
+
+    /**
+     * A rectangular block of a porkchop plot (see `porkchopTile`).
+     *
+     * Values are stored one row per departure, one column per flight
+     * time, i.e. the value for departure `firstDeparture + i` and flight
+     * time `firstFlightTime + j` is at index `i * flightTimeCount + j`.
+     */
+    struct PorkchopTile {
+        qsizetype firstDeparture = 0;
+        qsizetype departureCount = 0;
+        qsizetype firstFlightTime = 0;
+        qsizetype flightTimeCount = 0;
+
+        /**
+         * Distance (in metres) between the start planet's surface at
+         * departure and the destination planet's surface at arrival.
+         */
+        AlignedVector<double> distances;
+
+        /**
+         * Total travel time (in seconds, see `computeTransfer`) needed
+         * to cover that distance.
+         */
+        AlignedVector<double> travelTimes;
+    };
+
+    /**
+     * Computes one tile of a porkchop plot for a transfer between two planets:
+     * for every departure day and flight time of the tile, the distance between
+     * the start planet (where it is at departure) and the destination planet
+     * (where it will be once the flight time has elapsed), and the travel time
+     * `computeTransfer` gives for that distance.
+     *
+     * Angular positions are computed once per departure, and the destination's
+     * rotation once per flight time; each cell then only rotates the destination
+     * by its flight time, without any trigonometry. If the destination's orbit
+     * is elliptical, its arrival positions are instead computed per departure
+     * with the batched Kepler solver (see `orbitalPositionsAfterDays`), and
+     * if the solar system has a position source, all positions come from it
+     * (see `cartesianCoordinatesAfterDays`). Travel times match `computeTransfer`
+     * up to rounding.
+     *
+     * Tiles are independent of each other, so a large grid can be split into
+     * tiles computed on different threads (see `PorkchopEngine`).
+     */
+    PorkchopTile porkchopTile(
+        const Planet& from,
+        const Planet& to,
+        const Rocket& rocket,
+        const PorkchopGridSpec& spec,
+        qsizetype firstDeparture,
+        qsizetype departureCount,
+        qsizetype firstFlightTime,
+        qsizetype flightTimeCount
+        );
+
+    /**
+     * Travel data (see `TransferResults`) for every pair of planets of a
+     * solar system at a given moment (see `transferMatrix`).
+     *
+     * Values are stored one row per start planet, one column per destination
+     * planet, i.e. the value for the transfer from planet `i` to planet `j` is
+     * at index `i * planetCount + j`. Cells on the diagonal and cells involving
+     * planets lacking orbital data hold NaN.
+     */
+    struct TransferMatrix {
+        qsizetype planetCount = 0;
+
+        /**
+         * Moment of the departures.
+         */
+        Days day;
+
+        /**
+         * Distance (in metres) between the planets' surfaces.
+         */
+        AlignedVector<double> distances;
+
+        // Same fields as TransferResults (in the same units, untyped)
+        AlignedVector<double> cruisingVelocities;
+        AlignedVector<double> accelerationTimes;
+        AlignedVector<double> accelerationDistances;
+        AlignedVector<double> cruisingTimes;
+        AlignedVector<double> decelerationTimes;
+        AlignedVector<double> decelerationDistances;
+        AlignedVector<double> totalTravelTimes;
+
+        TransferResults transfer(qsizetype from, qsizetype to) const {
+            const qsizetype cell = from * planetCount + to;
+            return {
+                MetresPerSecond(cruisingVelocities[cell]),
+                Seconds(accelerationTimes[cell]),
+                Metres(accelerationDistances[cell]),
+                Seconds(cruisingTimes[cell]),
+                Seconds(decelerationTimes[cell]),
+                Metres(decelerationDistances[cell]),
+                Seconds(totalTravelTimes[cell])
+            };
+        }
+    };
+
+    /**
+     * Number of planets per side of the blocks `transferMatrix` fills at once.
+     */
+    constexpr qsizetype TRANSFER_MATRIX_BLOCK = 64;
+
+    /**
+     * Computes a transfer (see `computeSimpleTransfer`) between every pair of
+     * planets, departing at the given day (with planets where their orbital
+     * elements put them), ignoring realistic gravity.
+     *
+     * Everything that only depends on one planet is computed once per planet:
+     * escape velocities (batched, see `escapeVelocities`), acceleration and
+     * deceleration phases (a transfer cruises at the larger escape velocity of
+     * its two planets, so it takes the phases of that planet), and positions.
+     * The matrix is then filled in square blocks of `TRANSFER_MATRIX_BLOCK`
+     * planets, so that the per-planet values of a block stay in cache, with
+     * blocks spread across the global thread pool. Results match
+     * `computeSimpleTransfer` up to rounding.
+     */
+    TransferMatrix transferMatrix(const SolarSystem& planets, const Rocket& rocket, Days day);
+
+    /**
+     * Range of rocket configurations to sweep (see `rocketSweep`): every
+     * engine count from `minimumEngines` to `maximumEngines`, with each of
+     * `accelerationCount` per-engine accelerations (in metres per second
+     * square) evenly spaced from `minimumAccelerationPerEngine` to
+     * `maximumAccelerationPerEngine`, both included.
+     */
+    struct RocketSweepSpec {
+        short minimumEngines = 1;
+        short maximumEngines = 1;
+        double minimumAccelerationPerEngine = 1;
+        double maximumAccelerationPerEngine = 1;
+        qsizetype accelerationCount = 1;
+
+        qsizetype engineCounts() const { return maximumEngines - minimumEngines + 1; }
+        qsizetype size() const { return engineCounts() * accelerationCount; }
+
+        short engineCount(qsizetype cell) const { return short(minimumEngines + cell / accelerationCount); }
+        double accelerationPerEngine(qsizetype cell) const {
+            if (accelerationCount < 2) return minimumAccelerationPerEngine;
+            return minimumAccelerationPerEngine
+                   + (cell % accelerationCount) * (maximumAccelerationPerEngine - minimumAccelerationPerEngine) / (accelerationCount - 1);
+        }
+    };
+
+    /**
+     * Travel data (see `TransferResults`) of one transfer for every rocket
+     * configuration of a sweep, one column per field. Cell `i * accelerationCount + j`
+     * holds the `i`-th engine count with the `j`-th per-engine acceleration
+     * (see `RocketSweepSpec::engineCount` and `RocketSweepSpec::accelerationPerEngine`).
+     */
+    struct RocketSweep {
+        RocketSweepSpec spec;
+
+        /**
+         * Distance (in metres) between the planets' surfaces, and cruising
+         * velocity (in metres per second), the same for every configuration.
+         */
+        double distance = NAN;
+        double cruisingVelocity = NAN;
+
+        AlignedVector<double> accelerationTimes;
+        AlignedVector<double> accelerationDistances;
+        AlignedVector<double> cruisingTimes;
+        AlignedVector<double> decelerationTimes;
+        AlignedVector<double> decelerationDistances;
+        AlignedVector<double> totalTravelTimes;
+
+        /**
+         * Pareto front of engine count against total travel time: the cells
+         * of the configurations that are faster than every configuration
+         * with fewer engines (the fastest per-engine acceleration for their
+         * engine count, the lowest one on ties), by increasing engine count.
+         */
+        QList<qsizetype> paretoFront;
+    };
+
+    /**
+     * Computes a transfer (see `computeSimpleTransfer`, without realistic
+     * gravity) between two planets for every rocket configuration of the
+     * sweep, in one pass over the grid, spread across the global thread pool
+     * by engine count.
+     *
+     * Only the acceleration and deceleration phases depend on the rocket,
+     * in closed form, so the planet-dependent parts (positions, distance,
+     * escape velocities) are computed once for the whole grid, and each cell
+     * only evaluates those phases (see `computeTransfers`). Results match
+     * `computeSimpleTransfer` exactly.
+     */
+    RocketSweep rocketSweep(
+        const Planet& from,
+        const Planet& to,
+        const RocketSweepSpec& spec,
+        double fromAngularPosition = NAN,
+        double toAngularPosition = NAN,
+        Days daysElapsed = Days(0)
         );
 
     /**
@@ -261,7 +958,7 @@ namespace OrbitalMath {
          * Equivalent to the soonest moment after the timeframe start
          * when the source and destination planets align.
          */
-        double theoreticalBestStartTime;
+        Years theoreticalBestStartTime;
 
         /**
          * Whether the theoretical best transfer time produces a valid
@@ -291,7 +988,14 @@ namespace OrbitalMath {
          * closely aligned as possible within the timeframe, preferring
          * earlier times where possible
          */
-        double practicalBestStartTime;
+        Years practicalBestStartTime;
+
+        /**
+         * Whether the practical best time avoids collisions with other
+         * planets. Only false if no collision-free launch time exists in
+         * the timeframe at all (case 2 above).
+         */
+        bool isPracticalBestCollisionFree;
     };
 
     /**
@@ -311,20 +1015,30 @@ namespace OrbitalMath {
      * If the `systemStatic` flag is enabled, the solar system will be considered
      * static during the rocket's travel. Otherwise, the computation will
      * assume that planets (including the source and the destination) continue
-     * their movement during the rocket's travel.
+     * their movement during the rocket's travel: the rocket heads for where the
+     * destination will be on arrival (see `solveIntercept`), and other planets
+     * are checked for collisions at the moment the rocket crosses their orbit.
+     *
+     * Candidate launch times are the alignments of the two planets within the
+     * timeframe (one per synodic period); they are checked for collisions in
+     * parallel on the global thread pool. If none is collision-free, launch
+     * times around the first alignment in the timeframe are searched instead.
      *
-     * All times should be specified in years from the starting situation.
-     * The computation assumes that at time 0, all planets are aligned (at
-     * angular position 0°). A more generic solution may be implemented in a
-     * later version.
+     * All times count from the starting situation. Planets start where
+     * their orbital elements put them at time 0. For elliptical orbits,
+     * alignments are those of the planets' mean angular positions (see
+     * `daysUntilAligned`), which the collision checks then evaluate at the
+     * planets' actual positions. The same goes for planets placed by the
+     * solar system's position source, whose collision checks are timed by
+     * their Keplerian orbits but look at where the source puts them.
      */
     TransferPlanning planTransfer(
         const Planet& from,
         const Planet& to,
         const Rocket& rocket,
-        const QList<Planet>& solarSystem,
-        double timeframeStart,
-        double timeframeEnd,
+        const SolarSystem& solarSystem,
+        Years timeframeStart,
+        Years timeframeEnd,
         bool systemStatic = false
         );
 }
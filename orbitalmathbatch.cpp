@@ -0,0 +1,565 @@
+// Batched (span-based) versions of OrbitalMath functions, with
+// vectorized kernels selected at runtime (see simddispatch.h).
+//
+// Each kernel must perform exactly the same IEEE operations, in the same
+// order, as the corresponding scalar function in orbitalmath.cpp, so
+// that batched and scalar results are interchangeable. This file is
+// compiled with floating-point contraction disabled (see CMakeLists.txt)
+// so that the compiler does not fuse multiply-adds in the kernels only.
+
+#include "orbitalmath.h"
+#include "measurementunits.h"
+#include "simddispatch.h"
+
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <tuple>
+
+namespace {
+    // Scalar kernels, also used for the tails of the vectorized kernels
+
+    void escapeVelocitiesScalar(const double* mass, const double* radius, double* out, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            out[i] = std::sqrt(2 * OrbitalMath::GRAVITATIONAL_CONSTANT * mass[i] / radius[i]);
+        }
+    }
+
+    void accelerationValuesScalar(
+        const double* targetVelocities, double* times, double* distances, std::size_t count,
+        double rocketAcceleration, double initialVelocity, double ambientAcceleration
+        ) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const double velocityDelta = targetVelocities[i] - initialVelocity;
+            const double overallAcceleration = (velocityDelta > 0 ? rocketAcceleration : -rocketAcceleration)
+                                               + ambientAcceleration;
+            const double accelerationTime = velocityDelta / overallAcceleration;
+
+            times[i] = accelerationTime;
+            distances[i] = initialVelocity * accelerationTime
+                           + overallAcceleration * accelerationTime * accelerationTime / 2;
+        }
+    }
+
+    // Angular position kernels: out[j] = (angularVelocity * days[j]) reduced to [0°, 360°)
+
+    void angularPositionsScalar(double angularVelocity, const double* days, double* out, std::size_t count) {
+        for (std::size_t j = 0; j < count; ++j) {
+            const double angle = angularVelocity * days[j];
+            double reducedAngle = angle - 360.0 * std::floor(angle / 360.0);
+            if (reducedAngle < 0) reducedAngle += 360.0; // Can happen by rounding of angle / 360
+            out[j] = reducedAngle;
+        }
+    }
+
+#if SIMD_DISPATCH_X86
+    SIMD_TARGET_AVX2
+    void escapeVelocitiesAvx2(const double* mass, const double* radius, double* out, std::size_t count) {
+        const __m256d twoG = _mm256_set1_pd(2 * OrbitalMath::GRAVITATIONAL_CONSTANT);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m256d m = _mm256_loadu_pd(mass + i);
+            const __m256d r = _mm256_loadu_pd(radius + i);
+            _mm256_storeu_pd(out + i, _mm256_sqrt_pd(_mm256_div_pd(_mm256_mul_pd(twoG, m), r)));
+        }
+        escapeVelocitiesScalar(mass + i, radius + i, out + i, count - i);
+    }
+
+    SIMD_TARGET_AVX512
+    void escapeVelocitiesAvx512(const double* mass, const double* radius, double* out, std::size_t count) {
+        const __m512d twoG = _mm512_set1_pd(2 * OrbitalMath::GRAVITATIONAL_CONSTANT);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m512d m = _mm512_loadu_pd(mass + i);
+            const __m512d r = _mm512_loadu_pd(radius + i);
+            _mm512_storeu_pd(out + i, _mm512_sqrt_pd(_mm512_div_pd(_mm512_mul_pd(twoG, m), r)));
+        }
+        escapeVelocitiesScalar(mass + i, radius + i, out + i, count - i);
+    }
+
+    SIMD_TARGET_AVX2
+    void accelerationValuesAvx2(
+        const double* targetVelocities, double* times, double* distances, std::size_t count,
+        double rocketAcceleration, double initialVelocity, double ambientAcceleration
+        ) {
+        const __m256d zero = _mm256_setzero_pd();
+        const __m256d half = _mm256_set1_pd(0.5);
+        const __m256d positiveAcceleration = _mm256_set1_pd(rocketAcceleration);
+        const __m256d negativeAcceleration = _mm256_set1_pd(-rocketAcceleration);
+        const __m256d initial = _mm256_set1_pd(initialVelocity);
+        const __m256d ambient = _mm256_set1_pd(ambientAcceleration);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m256d velocityDelta = _mm256_sub_pd(_mm256_loadu_pd(targetVelocities + i), initial);
+            const __m256d accelerating = _mm256_cmp_pd(velocityDelta, zero, _CMP_GT_OQ);
+            const __m256d overallAcceleration = _mm256_add_pd(
+                _mm256_blendv_pd(negativeAcceleration, positiveAcceleration, accelerating), ambient);
+            const __m256d time = _mm256_div_pd(velocityDelta, overallAcceleration);
+
+            // Halving is exact, so multiplying by 0.5 matches the scalar "/ 2"
+            const __m256d distance = _mm256_add_pd(
+                _mm256_mul_pd(initial, time),
+                _mm256_mul_pd(_mm256_mul_pd(_mm256_mul_pd(overallAcceleration, time), time), half));
+
+            _mm256_storeu_pd(times + i, time);
+            _mm256_storeu_pd(distances + i, distance);
+        }
+        accelerationValuesScalar(targetVelocities + i, times + i, distances + i, count - i,
+                                 rocketAcceleration, initialVelocity, ambientAcceleration);
+    }
+
+    SIMD_TARGET_AVX512
+    void accelerationValuesAvx512(
+        const double* targetVelocities, double* times, double* distances, std::size_t count,
+        double rocketAcceleration, double initialVelocity, double ambientAcceleration
+        ) {
+        const __m512d zero = _mm512_setzero_pd();
+        const __m512d half = _mm512_set1_pd(0.5);
+        const __m512d positiveAcceleration = _mm512_set1_pd(rocketAcceleration);
+        const __m512d negativeAcceleration = _mm512_set1_pd(-rocketAcceleration);
+        const __m512d initial = _mm512_set1_pd(initialVelocity);
+        const __m512d ambient = _mm512_set1_pd(ambientAcceleration);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m512d velocityDelta = _mm512_sub_pd(_mm512_loadu_pd(targetVelocities + i), initial);
+            const __mmask8 accelerating = _mm512_cmp_pd_mask(velocityDelta, zero, _CMP_GT_OQ);
+            const __m512d overallAcceleration = _mm512_add_pd(
+                _mm512_mask_blend_pd(accelerating, negativeAcceleration, positiveAcceleration), ambient);
+            const __m512d time = _mm512_div_pd(velocityDelta, overallAcceleration);
+
+            const __m512d distance = _mm512_add_pd(
+                _mm512_mul_pd(initial, time),
+                _mm512_mul_pd(_mm512_mul_pd(_mm512_mul_pd(overallAcceleration, time), time), half));
+
+            _mm512_storeu_pd(times + i, time);
+            _mm512_storeu_pd(distances + i, distance);
+        }
+        accelerationValuesScalar(targetVelocities + i, times + i, distances + i, count - i,
+                                 rocketAcceleration, initialVelocity, ambientAcceleration);
+    }
+
+    SIMD_TARGET_AVX2
+    void angularPositionsAvx2(double angularVelocity, const double* days, double* out, std::size_t count) {
+        const __m256d velocity = _mm256_set1_pd(angularVelocity);
+        const __m256d fullTurn = _mm256_set1_pd(360.0);
+        const __m256d zero = _mm256_setzero_pd();
+
+        std::size_t j = 0;
+        for (; j + 4 <= count; j += 4) {
+            const __m256d angle = _mm256_mul_pd(velocity, _mm256_loadu_pd(days + j));
+            const __m256d turns = _mm256_floor_pd(_mm256_div_pd(angle, fullTurn));
+            const __m256d reducedAngle = _mm256_sub_pd(angle, _mm256_mul_pd(fullTurn, turns));
+            const __m256d negative = _mm256_cmp_pd(reducedAngle, zero, _CMP_LT_OQ);
+            _mm256_storeu_pd(out + j, _mm256_add_pd(reducedAngle, _mm256_and_pd(negative, fullTurn)));
+        }
+        angularPositionsScalar(angularVelocity, days + j, out + j, count - j);
+    }
+
+    SIMD_TARGET_AVX512
+    void angularPositionsAvx512(double angularVelocity, const double* days, double* out, std::size_t count) {
+        const __m512d velocity = _mm512_set1_pd(angularVelocity);
+        const __m512d fullTurn = _mm512_set1_pd(360.0);
+        const __m512d zero = _mm512_setzero_pd();
+
+        std::size_t j = 0;
+        for (; j + 8 <= count; j += 8) {
+            const __m512d angle = _mm512_mul_pd(velocity, _mm512_loadu_pd(days + j));
+            const __m512d turns = _mm512_roundscale_pd(_mm512_div_pd(angle, fullTurn), _MM_FROUND_TO_NEG_INF);
+            const __m512d reducedAngle = _mm512_sub_pd(angle, _mm512_mul_pd(fullTurn, turns));
+            const __mmask8 negative = _mm512_cmp_pd_mask(reducedAngle, zero, _CMP_LT_OQ);
+            _mm512_storeu_pd(out + j, _mm512_mask_add_pd(reducedAngle, negative, reducedAngle, fullTurn));
+        }
+        angularPositionsScalar(angularVelocity, days + j, out + j, count - j);
+    }
+#endif
+
+    using AngularPositionsKernel = void (*)(double, const double*, double*, std::size_t);
+
+    AngularPositionsKernel angularPositionsKernel() {
+        switch (SimdDispatch::detectedLevel()) {
+#if SIMD_DISPATCH_X86
+        case SimdDispatch::Level::Avx512: return angularPositionsAvx512;
+        case SimdDispatch::Level::Avx2: return angularPositionsAvx2;
+#endif
+        default: return angularPositionsScalar;
+        }
+    }
+
+    // Number of time steps processed together when filling an ephemeris grid.
+    // The step block (and the output rows being written) stay in L1 while
+    // we sweep all planets over it.
+    constexpr qsizetype EPHEMERIS_STEP_BLOCK = 512;
+}
+
+void OrbitalMath::escapeVelocities(std::span<const double> mass, std::span<const double> radius, std::span<double> out) {
+    const std::size_t count = mass.size();
+
+    switch (SimdDispatch::detectedLevel()) {
+#if SIMD_DISPATCH_X86
+    case SimdDispatch::Level::Avx512:
+        escapeVelocitiesAvx512(mass.data(), radius.data(), out.data(), count);
+        break;
+    case SimdDispatch::Level::Avx2:
+        escapeVelocitiesAvx2(mass.data(), radius.data(), out.data(), count);
+        break;
+#endif
+    default:
+        escapeVelocitiesScalar(mass.data(), radius.data(), out.data(), count);
+    }
+}
+
+void OrbitalMath::computeAccelerationValues(
+    const Rocket& rocket,
+    std::span<const double> targetVelocities,
+    std::span<double> accelerationTimes,
+    std::span<double> accelerationDistances,
+    double initialVelocity,
+    double ambientAcceleration
+    ) {
+    const std::size_t count = targetVelocities.size();
+    const double rocketAcceleration = totalAcceleration(rocket);
+
+    switch (SimdDispatch::detectedLevel()) {
+#if SIMD_DISPATCH_X86
+    case SimdDispatch::Level::Avx512:
+        accelerationValuesAvx512(targetVelocities.data(), accelerationTimes.data(), accelerationDistances.data(),
+                                 count, rocketAcceleration, initialVelocity, ambientAcceleration);
+        break;
+    case SimdDispatch::Level::Avx2:
+        accelerationValuesAvx2(targetVelocities.data(), accelerationTimes.data(), accelerationDistances.data(),
+                               count, rocketAcceleration, initialVelocity, ambientAcceleration);
+        break;
+#endif
+    default:
+        accelerationValuesScalar(targetVelocities.data(), accelerationTimes.data(), accelerationDistances.data(),
+                                 count, rocketAcceleration, initialVelocity, ambientAcceleration);
+    }
+}
+
+void OrbitalMath::computeTransfers(
+    std::span<const double> fromEscapeVelocities,
+    std::span<const double> toEscapeVelocities,
+    std::span<const double> rocketAccelerations,
+    double totalDistance,
+    TransferBatch& out
+    ) {
+    const std::size_t count = fromEscapeVelocities.size();
+    for (AlignedVector<double>* field : {
+             &out.cruisingVelocities, &out.accelerationTimes, &out.accelerationDistances, &out.cruisingTimes,
+             &out.decelerationTimes, &out.decelerationDistances, &out.totalTravelTimes
+         }) {
+        field->resize(count);
+    }
+
+    // Each variation has its own rocket acceleration, so the kernels of
+    // computeAccelerationValues don't apply; this loop is simple enough
+    // for the compiler to vectorize instead
+    for (std::size_t i = 0; i < count; ++i) {
+        const double cruisingVelocity = std::max(fromEscapeVelocities[i], toEscapeVelocities[i]);
+
+        // Launch (from rest) and landing (down to rest), as in
+        // computeAccelerationValues without ambient acceleration
+        const double launchVelocityDelta = cruisingVelocity - 0.0;
+        const double launchAcceleration = (launchVelocityDelta > 0 ? rocketAccelerations[i] : -rocketAccelerations[i]) + 0.0;
+        const double launchTime = launchVelocityDelta / launchAcceleration;
+        const double launchDistance = 0.0 * launchTime + launchAcceleration * launchTime * launchTime / 2;
+
+        const double landingVelocityDelta = 0.0 - cruisingVelocity;
+        const double landingAcceleration = (landingVelocityDelta > 0 ? rocketAccelerations[i] : -rocketAccelerations[i]) + 0.0;
+        const double landingTime = landingVelocityDelta / landingAcceleration;
+        const double landingDistance = cruisingVelocity * landingTime + landingAcceleration * landingTime * landingTime / 2;
+
+        const double cruisingTime = (totalDistance - launchDistance - landingDistance) / cruisingVelocity;
+
+        out.cruisingVelocities[i] = cruisingVelocity;
+        out.accelerationTimes[i] = launchTime;
+        out.accelerationDistances[i] = launchDistance;
+        out.cruisingTimes[i] = cruisingTime;
+        out.decelerationTimes[i] = landingTime;
+        out.decelerationDistances[i] = landingDistance;
+        out.totalTravelTimes[i] = cruisingTime + launchTime + landingTime;
+    }
+}
+
+OrbitalMath::EphemerisGrid
+OrbitalMath::ephemerisGrid(
+    const SolarSystem& planets, double startDay, double stepInDays, qsizetype steps,
+    bool computeCartesianCoordinates
+    ) {
+
+    EphemerisGrid grid;
+    grid.planetCount = planets.size();
+    grid.stepCount = steps;
+    grid.startDay = startDay;
+    grid.stepInDays = stepInDays;
+    grid.angularPositions.resize(grid.planetCount * steps);
+    if (computeCartesianCoordinates) {
+        grid.x.resize(grid.planetCount * steps);
+        grid.y.resize(grid.planetCount * steps);
+    }
+
+    // Precompute angular velocities (°/day) once for all planets
+    const std::span<const double> orbitalPeriods = planets.orbitalPeriodsInDays();
+    const std::span<const double> orbitalRadii = planets.orbitalRadiiInAU();
+    AlignedVector<double> angularVelocities(grid.planetCount);
+    for (qsizetype i = 0; i < grid.planetCount; ++i) {
+        angularVelocities[i] = 360.0 / orbitalPeriods[i]; // NaN if no orbital data
+    }
+
+    // Planets on circular orbits starting at 0° take the fast path below;
+    // all others need their orbital elements (and Kepler's equation)
+    const std::span<const double> eccentricities = planets.eccentricities();
+    const std::span<const double> argumentsOfPeriapsis = planets.argumentsOfPeriapsisInDegrees();
+    const std::span<const double> epochs = planets.epochsInDays();
+    const EphemerisCache* ephemerisCache = planets.getEphemerisCache();
+    const PositionSource* positionSource = planets.getPositionSource();
+
+    const AngularPositionsKernel kernel = angularPositionsKernel();
+    alignas(64) double days[EPHEMERIS_STEP_BLOCK];
+
+    for (qsizetype blockStart = 0; blockStart < steps; blockStart += EPHEMERIS_STEP_BLOCK) {
+        const qsizetype blockSize = std::min(EPHEMERIS_STEP_BLOCK, steps - blockStart);
+        for (qsizetype j = 0; j < blockSize; ++j) days[j] = startDay + (blockStart + j) * stepInDays;
+
+        for (qsizetype i = 0; i < grid.planetCount; ++i) {
+            const qsizetype rowOffset = i * steps + blockStart;
+            double* angles = grid.angularPositions.data() + rowOffset;
+
+            if (!planets.hasOrbitalData(i)) {
+                std::fill_n(angles, blockSize, NAN);
+                if (computeCartesianCoordinates) {
+                    std::fill_n(grid.x.data() + rowOffset, blockSize, NAN);
+                    std::fill_n(grid.y.data() + rowOffset, blockSize, NAN);
+                }
+                continue;
+            }
+
+            // Where the position source puts the planet, if it covers the block
+            if (nullptr != positionSource && positionSource->covers(i, Days(days[0]), Days(days[blockSize - 1]))) {
+                for (qsizetype j = 0; j < blockSize; ++j) {
+                    const auto [x, y] = positionSource->position(i, Days(days[j])).value();
+                    const double angle = AngleUnit::convert(std::atan2(y, x), AngleUnit::RADIANS, AngleUnit::DEGREES);
+                    angles[j] = angle < 0 ? angle + 360.0 : angle;
+                    if (computeCartesianCoordinates) {
+                        grid.x[rowOffset + j] = x;
+                        grid.y[rowOffset + j] = y;
+                    }
+                }
+                continue;
+            }
+
+            if (0 != eccentricities[i] || 0 != argumentsOfPeriapsis[i] || 0 != epochs[i]) {
+                const Planet planet = planets.at(i);
+
+                if (nullptr != ephemerisCache && ephemerisCache->covers(planet, days[0], days[blockSize - 1])) {
+                    for (qsizetype j = 0; j < blockSize; ++j) {
+                        angles[j] = ephemerisCache->angularPosition(planet, days[j]).value();
+                        if (computeCartesianCoordinates) {
+                            std::tie(grid.x[rowOffset + j], grid.y[rowOffset + j]) = ephemerisCache->position(planet, days[j]).value();
+                        }
+                    }
+                    continue;
+                }
+
+                orbitalPositionsAfterDays(
+                    planet,
+                    std::span<const double>(days, blockSize),
+                    std::span<double>(angles, blockSize),
+                    computeCartesianCoordinates ? std::span<double>(grid.x.data() + rowOffset, blockSize) : std::span<double>(),
+                    computeCartesianCoordinates ? std::span<double>(grid.y.data() + rowOffset, blockSize) : std::span<double>()
+                    );
+                continue;
+            }
+
+            kernel(angularVelocities[i], days, angles, blockSize);
+
+            if (computeCartesianCoordinates) {
+                // Same maths as polarToCartesianCoordinates, while the angles are still in cache
+                for (qsizetype j = 0; j < blockSize; ++j) {
+                    const double angleInRadians = AngleUnit::convert(angles[j], AngleUnit::DEGREES, AngleUnit::RADIANS);
+                    grid.x[rowOffset + j] = orbitalRadii[i] * std::cos(angleInRadians);
+                    grid.y[rowOffset + j] = orbitalRadii[i] * std::sin(angleInRadians);
+                }
+            }
+        }
+    }
+
+    return grid;
+}
+
+OrbitalMath::TransferMatrix
+OrbitalMath::transferMatrix(const SolarSystem& planets, const Rocket& rocket, Days day) {
+    const qsizetype planetCount = planets.size();
+    const qsizetype cellCount = planetCount * planetCount;
+
+    TransferMatrix matrix;
+    matrix.planetCount = planetCount;
+    matrix.day = day;
+    for (AlignedVector<double>* field : {
+             &matrix.distances, &matrix.cruisingVelocities, &matrix.accelerationTimes, &matrix.accelerationDistances,
+             &matrix.cruisingTimes, &matrix.decelerationTimes, &matrix.decelerationDistances, &matrix.totalTravelTimes
+         }) {
+        field->resize(cellCount);
+    }
+
+    // Per-planet values, once for all pairs: escape velocities, the phases of
+    // a transfer cruising at them, and positions (NaN if no orbital data)
+    AlignedVector<double> planetEscapeVelocities(planetCount);
+    escapeVelocities(planets.massesInKilograms(), planets.radiiInMetres(), planetEscapeVelocities);
+
+    AlignedVector<double> planetAccelerationTimes(planetCount);
+    AlignedVector<double> planetAccelerationDistances(planetCount);
+    computeAccelerationValues(rocket, planetEscapeVelocities, planetAccelerationTimes, planetAccelerationDistances);
+
+    AlignedVector<double> planetDecelerationTimes(planetCount);
+    AlignedVector<double> planetDecelerationDistances(planetCount);
+    AlignedVector<double> planetX(planetCount, NAN);
+    AlignedVector<double> planetY(planetCount, NAN);
+    for (qsizetype i = 0; i < planetCount; ++i) {
+        const AccelerationResult deceleration = computeAccelerationValues(rocket, 0.0, planetEscapeVelocities[i]);
+        planetDecelerationTimes[i] = deceleration.accelerationTime;
+        planetDecelerationDistances[i] = deceleration.accelerationDistance;
+
+        if (planets.hasOrbitalData(i)) std::tie(planetX[i], planetY[i]) = cartesianCoordinatesAfterDays(planets.at(i), day);
+    }
+    const std::span<const double> planetRadii = planets.radiiInMetres();
+
+    // Fill the matrix one block (of start planets × destination planets) per task
+    const qsizetype blocksPerSide = (planetCount + TRANSFER_MATRIX_BLOCK - 1) / TRANSFER_MATRIX_BLOCK;
+    std::vector<qsizetype> blocks(blocksPerSide * blocksPerSide);
+    std::iota(blocks.begin(), blocks.end(), 0);
+
+    QtConcurrent::blockingMap(blocks, [&](qsizetype block) {
+        const qsizetype firstFrom = (block / blocksPerSide) * TRANSFER_MATRIX_BLOCK;
+        const qsizetype firstTo = (block % blocksPerSide) * TRANSFER_MATRIX_BLOCK;
+        const qsizetype lastFrom = std::min(firstFrom + TRANSFER_MATRIX_BLOCK, planetCount);
+        const qsizetype lastTo = std::min(firstTo + TRANSFER_MATRIX_BLOCK, planetCount);
+
+        for (qsizetype from = firstFrom; from < lastFrom; ++from) {
+            for (qsizetype to = firstTo; to < lastTo; ++to) {
+                const qsizetype cell = from * planetCount + to;
+
+                if (from == to || std::isnan(planetX[from]) || std::isnan(planetX[to])) {
+                    matrix.distances[cell] = NAN;
+                    matrix.cruisingVelocities[cell] = NAN;
+                    matrix.accelerationTimes[cell] = NAN;
+                    matrix.accelerationDistances[cell] = NAN;
+                    matrix.cruisingTimes[cell] = NAN;
+                    matrix.decelerationTimes[cell] = NAN;
+                    matrix.decelerationDistances[cell] = NAN;
+                    matrix.totalTravelTimes[cell] = NAN;
+                    continue;
+                }
+
+                // Same maths as computeSimpleTransfer and computeTransfer
+                const double deltaX = planetX[to] - planetX[from];
+                const double deltaY = planetY[to] - planetY[from];
+                const double distanceBetweenSurfaces = DistanceUnit::convert(
+                                                           std::sqrt( deltaX * deltaX  +  deltaY * deltaY ),
+                                                           DistanceUnit::AU,
+                                                           DistanceUnit::METRES
+                                                           )
+                                                       - planetRadii[from]
+                                                       - planetRadii[to];
+
+                // Cruising velocity is the larger escape velocity (the start planet's on ties, like std::max)
+                const qsizetype faster = planetEscapeVelocities[from] < planetEscapeVelocities[to] ? to : from;
+                const double cruisingVelocity = planetEscapeVelocities[faster];
+                const double cruisingDistance = distanceBetweenSurfaces
+                                                - planetAccelerationDistances[faster]
+                                                - planetDecelerationDistances[faster];
+                const double cruisingTime = cruisingDistance / cruisingVelocity;
+
+                matrix.distances[cell] = distanceBetweenSurfaces;
+                matrix.cruisingVelocities[cell] = cruisingVelocity;
+                matrix.accelerationTimes[cell] = planetAccelerationTimes[faster];
+                matrix.accelerationDistances[cell] = planetAccelerationDistances[faster];
+                matrix.cruisingTimes[cell] = cruisingTime;
+                matrix.decelerationTimes[cell] = planetDecelerationTimes[faster];
+                matrix.decelerationDistances[cell] = planetDecelerationDistances[faster];
+                matrix.totalTravelTimes[cell] = cruisingTime
+                                                + planetAccelerationTimes[faster]
+                                                + planetDecelerationTimes[faster];
+            }
+        }
+    });
+
+    return matrix;
+}
+
+OrbitalMath::RocketSweep
+OrbitalMath::rocketSweep(
+    const Planet& from, const Planet& to, const RocketSweepSpec& spec,
+    double fromAngularPosition, double toAngularPosition, Days daysElapsed
+    ) {
+    const qsizetype cellCount = spec.size();
+
+    RocketSweep sweep;
+    sweep.spec = spec;
+    for (AlignedVector<double>* field : {
+             &sweep.accelerationTimes, &sweep.accelerationDistances, &sweep.cruisingTimes,
+             &sweep.decelerationTimes, &sweep.decelerationDistances, &sweep.totalTravelTimes
+         }) {
+        field->resize(cellCount);
+    }
+    if (0 == cellCount) return sweep;
+
+    // Everything that doesn't depend on the rocket, once for the whole grid
+    sweep.distance = surfaceDistance(from, to, fromAngularPosition, toAngularPosition, daysElapsed).value();
+    const double fromEscapeVelocity = escapeVelocity(from);
+    const double toEscapeVelocity = escapeVelocity(to);
+    sweep.cruisingVelocity = std::max(fromEscapeVelocity, toEscapeVelocity);
+
+    const AlignedVector<double> fromEscapeVelocities(spec.accelerationCount, fromEscapeVelocity);
+    const AlignedVector<double> toEscapeVelocities(spec.accelerationCount, toEscapeVelocity);
+    AlignedVector<double> accelerationsPerEngine(spec.accelerationCount);
+    for (qsizetype j = 0; j < spec.accelerationCount; ++j) accelerationsPerEngine[j] = spec.accelerationPerEngine(j);
+
+    // One row (engine count) per task
+    std::vector<qsizetype> rows(spec.engineCounts());
+    std::iota(rows.begin(), rows.end(), 0);
+
+    QtConcurrent::blockingMap(rows, [&](qsizetype row) {
+        const short engines = spec.engineCount(row * spec.accelerationCount);
+
+        // As totalAcceleration would compute it for each rocket
+        AlignedVector<double> rocketAccelerations(spec.accelerationCount);
+        for (qsizetype j = 0; j < spec.accelerationCount; ++j) rocketAccelerations[j] = engines * accelerationsPerEngine[j];
+
+        TransferBatch transfers;
+        computeTransfers(fromEscapeVelocities, toEscapeVelocities, rocketAccelerations, sweep.distance, transfers);
+
+        const qsizetype firstCell = row * spec.accelerationCount;
+        std::copy(transfers.accelerationTimes.begin(), transfers.accelerationTimes.end(), sweep.accelerationTimes.begin() + firstCell);
+        std::copy(transfers.accelerationDistances.begin(), transfers.accelerationDistances.end(), sweep.accelerationDistances.begin() + firstCell);
+        std::copy(transfers.cruisingTimes.begin(), transfers.cruisingTimes.end(), sweep.cruisingTimes.begin() + firstCell);
+        std::copy(transfers.decelerationTimes.begin(), transfers.decelerationTimes.end(), sweep.decelerationTimes.begin() + firstCell);
+        std::copy(transfers.decelerationDistances.begin(), transfers.decelerationDistances.end(), sweep.decelerationDistances.begin() + firstCell);
+        std::copy(transfers.totalTravelTimes.begin(), transfers.totalTravelTimes.end(), sweep.totalTravelTimes.begin() + firstCell);
+    });
+
+    // Pareto front: walk the engine counts upwards, keeping the fastest
+    // configuration of each one if it beats all those with fewer engines
+    double bestTravelTime = INFINITY;
+    for (qsizetype row = 0; row < spec.engineCounts(); ++row) {
+        qsizetype fastestCell = -1;
+        for (qsizetype cell = row * spec.accelerationCount; cell < (row + 1) * spec.accelerationCount; ++cell) {
+            if (sweep.totalTravelTimes[cell] < bestTravelTime
+                && (fastestCell < 0 || sweep.totalTravelTimes[cell] < sweep.totalTravelTimes[fastestCell])) {
+                fastestCell = cell;
+            }
+        }
+        if (fastestCell < 0) continue;
+
+        sweep.paretoFront.append(fastestCell);
+        bestTravelTime = sweep.totalTravelTimes[fastestCell];
+    }
+
+    return sweep;
+}
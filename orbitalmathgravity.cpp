@@ -0,0 +1,376 @@
+// Realistic gravity for the launch and landing phases of a transfer
+// (see OrbitalMath::integrateLaunch and OrbitalMath::computeTransfer).
+//
+// The rocket flies straight up (or down), so the motion is one-dimensional:
+// the state is the distance r from the planet's centre and the velocity v,
+// with dr/dt = v and dv/dt = a - GM/r², a being the rocket's acceleration.
+//
+// That motion has an energy integral, v²/2 = a (r - R) + GM (1/r - 1/R) from
+// the surface at R, so the phase can be solved without stepping through it:
+// the distance at which v reaches the target is the root of a quadratic, and
+// the time is t = ∫ dr / v. With r = R + s² (which removes the 1/√(r - R)
+// singularity at lift-off) and c² = R - GM/(aR),
+//   t = √(2/a) ∫₀^S √((s² + R) / (s² + c²)) ds,
+// an incomplete elliptic integral, which Carlson's symmetric forms R_F and
+// R_D give to any precision in a handful of duplication steps.
+
+#include "orbitalmath.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    struct State {
+        double distance; // From the planet's centre, in metres
+        double velocity; // In metres per second
+    };
+
+    struct Derivative {
+        double velocity;
+        double acceleration;
+    };
+
+    // Dormand–Prince 5(4) coefficients
+    constexpr double C2 = 1.0 / 5, C3 = 3.0 / 10, C4 = 4.0 / 5, C5 = 8.0 / 9;
+    constexpr double A21 = 1.0 / 5;
+    constexpr double A31 = 3.0 / 40, A32 = 9.0 / 40;
+    constexpr double A41 = 44.0 / 45, A42 = -56.0 / 15, A43 = 32.0 / 9;
+    constexpr double A51 = 19372.0 / 6561, A52 = -25360.0 / 2187, A53 = 64448.0 / 6561, A54 = -212.0 / 729;
+    constexpr double A61 = 9017.0 / 3168, A62 = -355.0 / 33, A63 = 46732.0 / 5247, A64 = 49.0 / 176, A65 = -5103.0 / 18656;
+    constexpr double A71 = 35.0 / 384, A73 = 500.0 / 1113, A74 = 125.0 / 192, A75 = -2187.0 / 6784, A76 = 11.0 / 84;
+    // Error coefficients: 5th order weights (A7x) minus 4th order ones
+    constexpr double E1 = 71.0 / 57600, E3 = -71.0 / 16695, E4 = 71.0 / 1920, E5 = -17253.0 / 339200, E6 = 22.0 / 525, E7 = -1.0 / 40;
+
+    // Step size control
+    constexpr double SAFETY_FACTOR = 0.9;
+    constexpr double MINIMUM_STEP_GROWTH = 0.2;
+    constexpr double MAXIMUM_STEP_GROWTH = 5.0;
+
+    // Attempts at landing the last step exactly on the target velocity
+    constexpr int MAXIMUM_FINAL_STEP_REFINEMENTS = 8;
+
+    class LaunchIntegrator {
+    public:
+        LaunchIntegrator(double rocketAcceleration, double gravitationalParameter,
+                         const OrbitalMath::GravityIntegrationSettings& settings)
+            : rocketAcceleration(rocketAcceleration)
+            , gravitationalParameter(gravitationalParameter)
+            , settings(settings)
+        {}
+
+        Derivative derivative(const State& state) const {
+            return { state.velocity, rocketAcceleration - gravitationalParameter / (state.distance * state.distance) };
+        }
+
+        /**
+         * Takes one Dormand–Prince step of size `step` from `state` (whose
+         * derivative is `k1`), returning the 5th order result and storing
+         * the derivative at the end in `k7` (to be reused as the next step's
+         * `k1`) and the error norm in `errorNorm` (at most 1 if within tolerance).
+         */
+        State step(const State& state, const Derivative& k1, double step, Derivative& k7, double& errorNorm) const {
+            const auto advance = [&state, step](double velocityIncrement, double accelerationIncrement) {
+                return State { state.distance + step * velocityIncrement, state.velocity + step * accelerationIncrement };
+            };
+
+            const Derivative k2 = derivative(advance(A21 * k1.velocity, A21 * k1.acceleration));
+            const Derivative k3 = derivative(advance(A31 * k1.velocity + A32 * k2.velocity,
+                                                     A31 * k1.acceleration + A32 * k2.acceleration));
+            const Derivative k4 = derivative(advance(A41 * k1.velocity + A42 * k2.velocity + A43 * k3.velocity,
+                                                     A41 * k1.acceleration + A42 * k2.acceleration + A43 * k3.acceleration));
+            const Derivative k5 = derivative(advance(A51 * k1.velocity + A52 * k2.velocity + A53 * k3.velocity + A54 * k4.velocity,
+                                                     A51 * k1.acceleration + A52 * k2.acceleration + A53 * k3.acceleration + A54 * k4.acceleration));
+            const Derivative k6 = derivative(advance(A61 * k1.velocity + A62 * k2.velocity + A63 * k3.velocity + A64 * k4.velocity + A65 * k5.velocity,
+                                                     A61 * k1.acceleration + A62 * k2.acceleration + A63 * k3.acceleration + A64 * k4.acceleration + A65 * k5.acceleration));
+            const State next = advance(A71 * k1.velocity + A73 * k3.velocity + A74 * k4.velocity + A75 * k5.velocity + A76 * k6.velocity,
+                                       A71 * k1.acceleration + A73 * k3.acceleration + A74 * k4.acceleration + A75 * k5.acceleration + A76 * k6.acceleration);
+            k7 = derivative(next);
+
+            const double distanceError = step * (E1 * k1.velocity + E3 * k3.velocity + E4 * k4.velocity
+                                                 + E5 * k5.velocity + E6 * k6.velocity + E7 * k7.velocity);
+            const double velocityError = step * (E1 * k1.acceleration + E3 * k3.acceleration + E4 * k4.acceleration
+                                                 + E5 * k5.acceleration + E6 * k6.acceleration + E7 * k7.acceleration);
+
+            const double distanceScale = settings.absoluteTolerance
+                                         + settings.relativeTolerance * std::max(std::abs(state.distance), std::abs(next.distance));
+            const double velocityScale = settings.absoluteTolerance
+                                         + settings.relativeTolerance * std::max(std::abs(state.velocity), std::abs(next.velocity));
+            errorNorm = std::max(std::abs(distanceError) / distanceScale, std::abs(velocityError) / velocityScale);
+
+            return next;
+        }
+
+        bool inFarField(const State& state) const {
+            return gravitationalParameter / (state.distance * state.distance) <= settings.farFieldGravityRatio * rocketAcceleration;
+        }
+
+    private:
+        double rocketAcceleration;
+        double gravitationalParameter;
+        const OrbitalMath::GravityIntegrationSettings& settings;
+    };
+
+    OrbitalMath::GravityPhaseResult integrate(
+        double rocketAcceleration, double gravitationalParameter, double planetRadius,
+        double targetVelocity, const OrbitalMath::GravityIntegrationSettings& settings
+        ) {
+
+        OrbitalMath::GravityPhaseResult result { 0, 0, 0, 0, false, false };
+        if (targetVelocity <= 0) return result;
+
+        // Too weak to lift off: we'll never get anywhere
+        const double surfaceGravity = gravitationalParameter / (planetRadius * planetRadius);
+        if (rocketAcceleration <= surfaceGravity) {
+            result.accelerationTime = INFINITY;
+            result.accelerationDistance = INFINITY;
+            return result;
+        }
+
+        const LaunchIntegrator integrator(rocketAcceleration, gravitationalParameter, settings);
+
+        State state { planetRadius, 0 };
+        Derivative stateDerivative = integrator.derivative(state);
+        double time = 0;
+
+        // Start with a twentieth of the time it would take at surface gravity; step size
+        // control shrinks it if need be, which is cheaper than growing it from a tiny step
+        double stepSize = 5e-2 * targetVelocity / (rocketAcceleration - surfaceGravity);
+
+        while (!integrator.inFarField(state)) {
+            if (result.steps >= settings.maximumSteps) {
+                result.accelerationTime = NAN;
+                result.accelerationDistance = NAN;
+                return result;
+            }
+            ++result.steps;
+
+            Derivative nextDerivative;
+            double errorNorm;
+            State next = integrator.step(state, stateDerivative, stepSize, nextDerivative, errorNorm);
+
+            if (errorNorm > 1) {
+                ++result.rejectedSteps;
+                stepSize *= std::max(MINIMUM_STEP_GROWTH, SAFETY_FACTOR * std::pow(errorNorm, -1.0 / 5));
+                continue;
+            }
+
+            if (next.velocity >= targetVelocity) {
+                // Overshot: shrink the last step until it ends right at the target velocity
+                // (velocity grows monotonically, so secant steps on the step size converge quickly)
+                double shortStep = 0, shortVelocity = state.velocity;
+                double longStep = stepSize, longVelocity = next.velocity;
+                double finalStep = stepSize;
+                for (int i = 0; i < MAXIMUM_FINAL_STEP_REFINEMENTS; ++i) {
+                    finalStep = shortStep + (longStep - shortStep) * (targetVelocity - shortVelocity) / (longVelocity - shortVelocity);
+                    next = integrator.step(state, stateDerivative, finalStep, nextDerivative, errorNorm);
+                    ++result.steps;
+
+                    if (std::abs(next.velocity - targetVelocity) <= settings.absoluteTolerance + settings.relativeTolerance * targetVelocity) break;
+                    if (next.velocity < targetVelocity) { shortStep = finalStep; shortVelocity = next.velocity; }
+                    else { longStep = finalStep; longVelocity = next.velocity; }
+                }
+
+                result.accelerationTime = time + finalStep;
+                result.accelerationDistance = next.distance - planetRadius;
+                return result;
+            }
+
+            time += stepSize;
+            state = next;
+            stateDerivative = nextDerivative;
+            stepSize *= std::min(MAXIMUM_STEP_GROWTH, SAFETY_FACTOR * std::pow(std::max(errorNorm, 1e-10), -1.0 / 5));
+        }
+
+        // Far field: gravity is negligible from here on. The energy integral gives the
+        // exact distance at which we reach the target velocity:
+        //   v²/2 - v₀²/2 = a (r - r₀) + GM (1/r - 1/r₀)
+        // solved with Newton's method from the constant-acceleration guess.
+        result.reachedFarField = true;
+        const auto energyMismatch = [&](double distance) {
+            return (targetVelocity * targetVelocity - state.velocity * state.velocity) / 2
+                   - rocketAcceleration * (distance - state.distance)
+                   - gravitationalParameter * (1 / distance - 1 / state.distance);
+        };
+        double distance = state.distance + (targetVelocity * targetVelocity - state.velocity * state.velocity) / (2 * rocketAcceleration);
+        for (int i = 0; i < 3; ++i) {
+            const double slope = -rocketAcceleration + gravitationalParameter / (distance * distance);
+            distance -= energyMismatch(distance) / slope;
+        }
+
+        // Time as if acceleration were constant over the remaining distance (it is, to within the far-field ratio)
+        result.accelerationTime = time + 2 * (distance - state.distance) / (state.velocity + targetVelocity);
+        result.accelerationDistance = distance - planetRadius;
+        return result;
+    }
+
+    // Carlson's symmetric elliptic integrals, by duplication until the arguments
+    // are within `tolerance` of their mean, then a 5th order series; the relative
+    // error is then below tolerance⁶/4 for R_F and 3 tolerance⁶ for R_D
+    // (B. C. Carlson, Numerical computation of real or complex elliptic integrals, 1995)
+    double carlsonRF(double x, double y, double z, double tolerance, int& steps) {
+        double mean, dx, dy, dz;
+        while (true) {
+            ++steps;
+            const double sx = std::sqrt(x), sy = std::sqrt(y), sz = std::sqrt(z);
+            const double lambda = sx * (sy + sz) + sy * sz;
+            x = 0.25 * (x + lambda);
+            y = 0.25 * (y + lambda);
+            z = 0.25 * (z + lambda);
+            mean = (x + y + z) / 3;
+            dx = (mean - x) / mean;
+            dy = (mean - y) / mean;
+            dz = (mean - z) / mean;
+            if (std::max({std::abs(dx), std::abs(dy), std::abs(dz)}) <= tolerance) break;
+        }
+
+        const double e2 = dx * dy - dz * dz;
+        const double e3 = dx * dy * dz;
+        return (1 + (e2 / 24 - 0.1 - 3 * e3 / 44) * e2 + e3 / 14) / std::sqrt(mean);
+    }
+
+    double carlsonRD(double x, double y, double z, double tolerance, int& steps) {
+        double sum = 0, factor = 1;
+        double mean, dx, dy, dz;
+        while (true) {
+            ++steps;
+            const double sx = std::sqrt(x), sy = std::sqrt(y), sz = std::sqrt(z);
+            const double lambda = sx * (sy + sz) + sy * sz;
+            sum += factor / (sz * (z + lambda));
+            factor *= 0.25;
+            x = 0.25 * (x + lambda);
+            y = 0.25 * (y + lambda);
+            z = 0.25 * (z + lambda);
+            mean = (x + y + 3 * z) / 5;
+            dx = (mean - x) / mean;
+            dy = (mean - y) / mean;
+            dz = (mean - z) / mean;
+            if (std::max({std::abs(dx), std::abs(dy), std::abs(dz)}) <= tolerance) break;
+        }
+
+        const double ea = dx * dy, eb = dz * dz;
+        const double ec = ea - eb, ed = ea - 6 * eb, ee = ed + 2 * ec;
+        const double series = 1 + ed * (-3.0 / 14 + 9.0 / 88 * ed - 9.0 / 52 * dz * ee)
+                              + dz * (ee / 6 + dz * (-9.0 / 22 * ec + dz * 3.0 / 26 * ea));
+        return 3 * sum + factor * series / (mean * std::sqrt(mean));
+    }
+
+    // Duplication tolerances giving a relative error below t are these times t^(1/6),
+    // i.e. (4t)^(1/6) and (t/3)^(1/6); beyond the maximum, the series is no longer
+    // accurate to the bounds above
+    constexpr double RF_TOLERANCE_FACTOR = 1.2599210498948732; // 4^(1/6)
+    constexpr double RD_TOLERANCE_FACTOR = 0.8326831776556043; // 3^(-1/6)
+    constexpr double MAXIMUM_DUPLICATION_TOLERANCE = 0.1;
+
+    OrbitalMath::GravityPhaseResult solve(
+        double rocketAcceleration, double gravitationalParameter, double planetRadius,
+        double targetVelocity, const OrbitalMath::GravityIntegrationSettings& settings
+        ) {
+
+        OrbitalMath::GravityPhaseResult result { 0, 0, 0, 0, false, false };
+        if (targetVelocity <= 0) return result;
+
+        // Too weak to lift off: we'll never get anywhere
+        const double surfaceGravity = gravitationalParameter / (planetRadius * planetRadius);
+        if (rocketAcceleration <= surfaceGravity) {
+            result.accelerationTime = INFINITY;
+            result.accelerationDistance = INFINITY;
+            return result;
+        }
+
+        // Distance x = r - R from the energy integral, which multiplied by r reads
+        //   a x² + ((a - g) R - v²/2) x - v² R / 2 = 0
+        // (g being surface gravity); the positive root, without cancellation
+        const double squaredVelocity = targetVelocity * targetVelocity;
+        const double linearCoefficient = (rocketAcceleration - surfaceGravity) * planetRadius - squaredVelocity / 2;
+        const double root = std::sqrt(linearCoefficient * linearCoefficient + 2 * rocketAcceleration * squaredVelocity * planetRadius);
+        const double distance = linearCoefficient >= 0
+                                    ? squaredVelocity * planetRadius / (linearCoefficient + root)
+                                    : (root - linearCoefficient) / (2 * rocketAcceleration);
+
+        // Time: with b² = R, ∫₀^S √((s² + b²) / (s² + c²)) ds = b² J₀ + J₂, where
+        //   J₀ = ∫₀^S ds / √((s² + b²)(s² + c²)) = R_F(X, Y, Z) / (bc)
+        //   J₂ = ∫₀^S s² ds / √((s² + b²)(s² + c²)) = R_D(Y, Z, X) / (3bc)
+        // with X = 1/S², Y = X + 1/b², Z = X + 1/c²
+        const double squaredB = planetRadius;
+        const double squaredC = planetRadius * (1 - surfaceGravity / rocketAcceleration);
+        const double x = 1 / distance;
+        const double y = x + 1 / squaredB;
+        const double z = x + 1 / squaredC;
+        const double toleranceRoot = std::sqrt(std::cbrt(settings.relativeTolerance)); // Sixth root
+        const double rfTolerance = std::min(MAXIMUM_DUPLICATION_TOLERANCE, RF_TOLERANCE_FACTOR * toleranceRoot);
+        const double rdTolerance = std::min(MAXIMUM_DUPLICATION_TOLERANCE, RD_TOLERANCE_FACTOR * toleranceRoot);
+        const double integral = (squaredB * carlsonRF(x, y, z, rfTolerance, result.steps)
+                                 + carlsonRD(y, z, x, rdTolerance, result.steps) / 3)
+                                / std::sqrt(squaredB * squaredC);
+
+        result.accelerationTime = std::sqrt(2 / rocketAcceleration) * integral;
+        result.accelerationDistance = distance;
+        return result;
+    }
+
+    // Recently computed phases, per thread. A phase only depends on the rocket, the
+    // planet and the target velocity, not on the rest of the transfer, so batched
+    // computations (e.g. porkchop plots, intercepts) keep asking for the same few.
+    struct CachedPhase {
+        double rocketAcceleration;
+        double gravitationalParameter;
+        double planetRadius;
+        double targetVelocity;
+        OrbitalMath::GravityIntegrationSettings settings;
+        OrbitalMath::GravityPhaseResult result;
+
+        bool matches(double otherRocketAcceleration, double otherGravitationalParameter, double otherPlanetRadius,
+                     double otherTargetVelocity, const OrbitalMath::GravityIntegrationSettings& otherSettings) const {
+            return rocketAcceleration == otherRocketAcceleration
+                   && gravitationalParameter == otherGravitationalParameter
+                   && planetRadius == otherPlanetRadius
+                   && targetVelocity == otherTargetVelocity
+                   && settings.relativeTolerance == otherSettings.relativeTolerance
+                   && settings.absoluteTolerance == otherSettings.absoluteTolerance
+                   && settings.farFieldGravityRatio == otherSettings.farFieldGravityRatio
+                   && settings.maximumSteps == otherSettings.maximumSteps
+                   && settings.integrateNumerically == otherSettings.integrateNumerically;
+        }
+    };
+
+    constexpr int PHASE_CACHE_SIZE = 8;
+
+    struct PhaseCache {
+        std::array<CachedPhase, PHASE_CACHE_SIZE> entries;
+        int used = 0;
+        int next = 0; // Oldest entry, replaced first
+    };
+
+    thread_local PhaseCache phaseCache;
+}
+
+OrbitalMath::GravityPhaseResult
+OrbitalMath::integrateLaunch(const Rocket& rocket, const Planet& planet, double targetVelocity, const GravityIntegrationSettings& settings) {
+    const double rocketAcceleration = OrbitalMath::totalAcceleration(rocket);
+    const double gravitationalParameter = GRAVITATIONAL_CONSTANT * planet.getMassInKilograms(); // GM, in m³/s²
+    const double planetRadius = planet.getRadiusInMetres();
+
+    if (settings.reuseRecentPhases) {
+        for (int i = 0; i < phaseCache.used; ++i) {
+            const CachedPhase& entry = phaseCache.entries[i];
+            if (entry.matches(rocketAcceleration, gravitationalParameter, planetRadius, targetVelocity, settings)) {
+                GravityPhaseResult result = entry.result;
+                result.steps = 0;
+                result.rejectedSteps = 0;
+                result.reused = true;
+                return result;
+            }
+        }
+    }
+
+    const GravityPhaseResult result = settings.integrateNumerically
+                                          ? integrate(rocketAcceleration, gravitationalParameter, planetRadius, targetVelocity, settings)
+                                          : solve(rocketAcceleration, gravitationalParameter, planetRadius, targetVelocity, settings);
+
+    phaseCache.entries[phaseCache.next] = { rocketAcceleration, gravitationalParameter, planetRadius, targetVelocity, settings, result };
+    phaseCache.next = (phaseCache.next + 1) % PHASE_CACHE_SIZE;
+    phaseCache.used = std::max(phaseCache.used, phaseCache.next == 0 ? PHASE_CACHE_SIZE : phaseCache.next);
+
+    return result;
+}
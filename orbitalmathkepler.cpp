@@ -0,0 +1,369 @@
+// Kepler's equation solver for elliptical orbits, scalar and batched, with
+// vectorized kernels selected at runtime (see simddispatch.h).
+//
+// Like in orbitalmathbatch.cpp, every kernel performs exactly the same IEEE
+// operations in the same order, so all paths give bit-identical results.
+// That includes sine and cosine, which are computed with our own polynomial
+// (the C library's can't be vectorized), and the stopping rule: a vector
+// lane stops updating at the very iteration the scalar loop would stop.
+// This file is compiled with floating-point contraction disabled as well.
+
+#include "orbitalmath.h"
+#include "measurementunits.h"
+#include "simddispatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+    constexpr double TWO_PI = 2 * std::numbers::pi;
+    constexpr double INVERSE_TWO_PI = 1 / TWO_PI;
+    constexpr double TWO_OVER_PI = 2 / std::numbers::pi;
+
+    // π/2 split in two (Cody–Waite), so that x - k*π/2 stays accurate
+    constexpr double HALF_PI_HIGH = 1.57079632673412561417e+00;
+    constexpr double HALF_PI_LOW = 6.07710050650619224932e-11;
+
+    // Minimax polynomials for sine and cosine on [-π/4, π/4] (from fdlibm)
+    constexpr double S1 = -1.66666666666666324348e-01;
+    constexpr double S2 = 8.33333333332248946124e-03;
+    constexpr double S3 = -1.98412698298579493134e-04;
+    constexpr double S4 = 2.75573137070700676789e-06;
+    constexpr double S5 = -2.50507602534068634195e-08;
+    constexpr double S6 = 1.58969099521155010221e-10;
+    constexpr double C1 = 4.16666666666666019037e-02;
+    constexpr double C2 = -1.38888888888741095749e-03;
+    constexpr double C3 = 2.48015872894767294178e-05;
+    constexpr double C4 = -2.75573143513906633035e-07;
+    constexpr double C5 = 2.08757232129817482790e-09;
+    constexpr double C6 = -1.13596475577881948265e-11;
+
+    // Starting guess E = M + STARTER * e (with the sign of M), from Danby.
+    // Halley's method converges from it for any eccentricity in [0, 1):
+    // usually in 3 iterations, 6 at most for eccentricities up to 0.999.
+    constexpr double KEPLER_STARTER = 0.85;
+    constexpr double KEPLER_TOLERANCE = 1e-15;
+    constexpr int KEPLER_MAXIMUM_ITERATIONS = 12;
+
+    // Number of elements processed together when computing positions,
+    // so that the intermediate arrays stay in L1
+    constexpr qsizetype KEPLER_BLOCK = 512;
+
+    // Scalar kernels, also used for the tails of the vectorized kernels
+
+    struct SinCos {
+        double sine;
+        double cosine;
+    };
+
+    SinCos sinCosScalar(double x) {
+        const double quadrant = std::nearbyint(x * TWO_OVER_PI);
+        const double r = (x - quadrant * HALF_PI_HIGH) - quadrant * HALF_PI_LOW;
+        const double r2 = r * r;
+
+        const double sine = r + r * r2 * (S1 + r2 * (S2 + r2 * (S3 + r2 * (S4 + r2 * (S5 + r2 * S6)))));
+        const double cosine = 1.0 - 0.5 * r2 + r2 * r2 * (C1 + r2 * (C2 + r2 * (C3 + r2 * (C4 + r2 * (C5 + r2 * C6)))));
+
+        // Rotate back by the quadrant
+        const double quadrantModulo4 = quadrant - 4.0 * std::floor(quadrant * 0.25);
+        const bool swap = 1.0 == quadrantModulo4 || 3.0 == quadrantModulo4;
+        const bool negateSine = quadrantModulo4 >= 2.0;
+        const bool negateCosine = 1.0 == quadrantModulo4 || 2.0 == quadrantModulo4;
+
+        SinCos result { swap ? cosine : sine, swap ? sine : cosine };
+        if (negateSine) result.sine = -result.sine;
+        if (negateCosine) result.cosine = -result.cosine;
+        return result;
+    }
+
+    void keplerScalar(
+        const double* meanAnomalies, const double* eccentricities,
+        double* eccentricAnomalies, double* sines, double* cosines, std::size_t count
+        ) {
+        for (std::size_t i = 0; i < count; ++i) {
+            const double e = eccentricities[i];
+            const double meanAnomaly = meanAnomalies[i] - TWO_PI * std::nearbyint(meanAnomalies[i] * INVERSE_TWO_PI);
+
+            double eccentricAnomaly = meanAnomaly + std::copysign(KEPLER_STARTER * e, meanAnomaly);
+            SinCos sinCos = sinCosScalar(eccentricAnomaly);
+
+            // Halley's method on f(E) = E - e*sin(E) - M
+            for (int iteration = 0; iteration < KEPLER_MAXIMUM_ITERATIONS; ++iteration) {
+                const double f = eccentricAnomaly - e * sinCos.sine - meanAnomaly;
+                const double derivative = 1.0 - e * sinCos.cosine;
+                const double secondDerivative = e * sinCos.sine;
+                const double step = f * derivative / (derivative * derivative - f * secondDerivative * 0.5);
+
+                eccentricAnomaly = eccentricAnomaly - step;
+                sinCos = sinCosScalar(eccentricAnomaly);
+                if (std::abs(step) <= KEPLER_TOLERANCE) break;
+            }
+
+            eccentricAnomalies[i] = eccentricAnomaly;
+            if (nullptr != sines) sines[i] = sinCos.sine;
+            if (nullptr != cosines) cosines[i] = sinCos.cosine;
+        }
+    }
+
+#if SIMD_DISPATCH_X86
+    SIMD_TARGET_AVX2
+    inline __m256d polynomialAvx2(__m256d r2, double c1, double c2, double c3, double c4, double c5, double c6) {
+        __m256d p = _mm256_add_pd(_mm256_set1_pd(c5), _mm256_mul_pd(r2, _mm256_set1_pd(c6)));
+        p = _mm256_add_pd(_mm256_set1_pd(c4), _mm256_mul_pd(r2, p));
+        p = _mm256_add_pd(_mm256_set1_pd(c3), _mm256_mul_pd(r2, p));
+        p = _mm256_add_pd(_mm256_set1_pd(c2), _mm256_mul_pd(r2, p));
+        return _mm256_add_pd(_mm256_set1_pd(c1), _mm256_mul_pd(r2, p));
+    }
+
+    SIMD_TARGET_AVX2
+    inline void sinCosAvx2(__m256d x, __m256d& sine, __m256d& cosine) {
+        const __m256d signBit = _mm256_set1_pd(-0.0);
+
+        const __m256d quadrant = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(TWO_OVER_PI)),
+                                                 _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        const __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(quadrant, _mm256_set1_pd(HALF_PI_HIGH))),
+                                        _mm256_mul_pd(quadrant, _mm256_set1_pd(HALF_PI_LOW)));
+        const __m256d r2 = _mm256_mul_pd(r, r);
+
+        const __m256d s = _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(r, r2), polynomialAvx2(r2, S1, S2, S3, S4, S5, S6)));
+        const __m256d c = _mm256_add_pd(_mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(_mm256_set1_pd(0.5), r2)),
+                                        _mm256_mul_pd(_mm256_mul_pd(r2, r2), polynomialAvx2(r2, C1, C2, C3, C4, C5, C6)));
+
+        const __m256d quadrantModulo4 = _mm256_sub_pd(
+            quadrant, _mm256_mul_pd(_mm256_set1_pd(4.0), _mm256_floor_pd(_mm256_mul_pd(quadrant, _mm256_set1_pd(0.25)))));
+        const __m256d isOne = _mm256_cmp_pd(quadrantModulo4, _mm256_set1_pd(1.0), _CMP_EQ_OQ);
+        const __m256d isTwo = _mm256_cmp_pd(quadrantModulo4, _mm256_set1_pd(2.0), _CMP_EQ_OQ);
+        const __m256d isThree = _mm256_cmp_pd(quadrantModulo4, _mm256_set1_pd(3.0), _CMP_EQ_OQ);
+        const __m256d swap = _mm256_or_pd(isOne, isThree);
+        const __m256d negateSine = _mm256_cmp_pd(quadrantModulo4, _mm256_set1_pd(2.0), _CMP_GE_OQ);
+        const __m256d negateCosine = _mm256_or_pd(isOne, isTwo);
+
+        sine = _mm256_xor_pd(_mm256_blendv_pd(s, c, swap), _mm256_and_pd(negateSine, signBit));
+        cosine = _mm256_xor_pd(_mm256_blendv_pd(c, s, swap), _mm256_and_pd(negateCosine, signBit));
+    }
+
+    SIMD_TARGET_AVX2
+    void keplerAvx2(
+        const double* meanAnomalies, const double* eccentricities,
+        double* eccentricAnomalies, double* sines, double* cosines, std::size_t count
+        ) {
+        const __m256d signBit = _mm256_set1_pd(-0.0);
+        const __m256d twoPi = _mm256_set1_pd(TWO_PI);
+        const __m256d tolerance = _mm256_set1_pd(KEPLER_TOLERANCE);
+
+        std::size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const __m256d e = _mm256_loadu_pd(eccentricities + i);
+            const __m256d rawMeanAnomaly = _mm256_loadu_pd(meanAnomalies + i);
+            const __m256d turns = _mm256_round_pd(_mm256_mul_pd(rawMeanAnomaly, _mm256_set1_pd(INVERSE_TWO_PI)),
+                                                  _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            const __m256d meanAnomaly = _mm256_sub_pd(rawMeanAnomaly, _mm256_mul_pd(twoPi, turns));
+
+            const __m256d starter = _mm256_or_pd(_mm256_andnot_pd(signBit, _mm256_mul_pd(_mm256_set1_pd(KEPLER_STARTER), e)),
+                                                 _mm256_and_pd(signBit, meanAnomaly));
+            __m256d eccentricAnomaly = _mm256_add_pd(meanAnomaly, starter);
+            __m256d sine, cosine;
+            sinCosAvx2(eccentricAnomaly, sine, cosine);
+
+            __m256d active = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+            for (int iteration = 0; iteration < KEPLER_MAXIMUM_ITERATIONS && !_mm256_testz_pd(active, active); ++iteration) {
+                const __m256d f = _mm256_sub_pd(_mm256_sub_pd(eccentricAnomaly, _mm256_mul_pd(e, sine)), meanAnomaly);
+                const __m256d derivative = _mm256_sub_pd(_mm256_set1_pd(1.0), _mm256_mul_pd(e, cosine));
+                const __m256d secondDerivative = _mm256_mul_pd(e, sine);
+                const __m256d step = _mm256_div_pd(
+                    _mm256_mul_pd(f, derivative),
+                    _mm256_sub_pd(_mm256_mul_pd(derivative, derivative),
+                                  _mm256_mul_pd(_mm256_mul_pd(f, secondDerivative), _mm256_set1_pd(0.5))));
+
+                eccentricAnomaly = _mm256_blendv_pd(eccentricAnomaly, _mm256_sub_pd(eccentricAnomaly, step), active);
+                sinCosAvx2(eccentricAnomaly, sine, cosine);
+                active = _mm256_and_pd(active, _mm256_cmp_pd(_mm256_andnot_pd(signBit, step), tolerance, _CMP_NLE_UQ));
+            }
+
+            _mm256_storeu_pd(eccentricAnomalies + i, eccentricAnomaly);
+            if (nullptr != sines) _mm256_storeu_pd(sines + i, sine);
+            if (nullptr != cosines) _mm256_storeu_pd(cosines + i, cosine);
+        }
+        keplerScalar(meanAnomalies + i, eccentricities + i, eccentricAnomalies + i,
+                     nullptr != sines ? sines + i : nullptr, nullptr != cosines ? cosines + i : nullptr, count - i);
+    }
+
+    SIMD_TARGET_AVX512
+    inline __m512d polynomialAvx512(__m512d r2, double c1, double c2, double c3, double c4, double c5, double c6) {
+        __m512d p = _mm512_add_pd(_mm512_set1_pd(c5), _mm512_mul_pd(r2, _mm512_set1_pd(c6)));
+        p = _mm512_add_pd(_mm512_set1_pd(c4), _mm512_mul_pd(r2, p));
+        p = _mm512_add_pd(_mm512_set1_pd(c3), _mm512_mul_pd(r2, p));
+        p = _mm512_add_pd(_mm512_set1_pd(c2), _mm512_mul_pd(r2, p));
+        return _mm512_add_pd(_mm512_set1_pd(c1), _mm512_mul_pd(r2, p));
+    }
+
+    // AVX-512F only has bitwise operations on integers
+    SIMD_TARGET_AVX512
+    inline __m512d negateWhere(__mmask8 mask, __m512d x) {
+        return _mm512_castsi512_pd(_mm512_mask_xor_epi64(
+            _mm512_castpd_si512(x), mask, _mm512_castpd_si512(x), _mm512_set1_epi64(qint64(1) << 63)));
+    }
+
+    SIMD_TARGET_AVX512
+    inline void sinCosAvx512(__m512d x, __m512d& sine, __m512d& cosine) {
+        const __m512d quadrant = _mm512_roundscale_pd(_mm512_mul_pd(x, _mm512_set1_pd(TWO_OVER_PI)),
+                                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+        const __m512d r = _mm512_sub_pd(_mm512_sub_pd(x, _mm512_mul_pd(quadrant, _mm512_set1_pd(HALF_PI_HIGH))),
+                                        _mm512_mul_pd(quadrant, _mm512_set1_pd(HALF_PI_LOW)));
+        const __m512d r2 = _mm512_mul_pd(r, r);
+
+        const __m512d s = _mm512_add_pd(r, _mm512_mul_pd(_mm512_mul_pd(r, r2), polynomialAvx512(r2, S1, S2, S3, S4, S5, S6)));
+        const __m512d c = _mm512_add_pd(_mm512_sub_pd(_mm512_set1_pd(1.0), _mm512_mul_pd(_mm512_set1_pd(0.5), r2)),
+                                        _mm512_mul_pd(_mm512_mul_pd(r2, r2), polynomialAvx512(r2, C1, C2, C3, C4, C5, C6)));
+
+        const __m512d quadrantModulo4 = _mm512_sub_pd(
+            quadrant, _mm512_mul_pd(_mm512_set1_pd(4.0),
+                                    _mm512_roundscale_pd(_mm512_mul_pd(quadrant, _mm512_set1_pd(0.25)), _MM_FROUND_TO_NEG_INF)));
+        const __mmask8 isOne = _mm512_cmp_pd_mask(quadrantModulo4, _mm512_set1_pd(1.0), _CMP_EQ_OQ);
+        const __mmask8 isTwo = _mm512_cmp_pd_mask(quadrantModulo4, _mm512_set1_pd(2.0), _CMP_EQ_OQ);
+        const __mmask8 isThree = _mm512_cmp_pd_mask(quadrantModulo4, _mm512_set1_pd(3.0), _CMP_EQ_OQ);
+        const __mmask8 swap = isOne | isThree;
+        const __mmask8 negateSine = _mm512_cmp_pd_mask(quadrantModulo4, _mm512_set1_pd(2.0), _CMP_GE_OQ);
+        const __mmask8 negateCosine = isOne | isTwo;
+
+        sine = negateWhere(negateSine, _mm512_mask_blend_pd(swap, s, c));
+        cosine = negateWhere(negateCosine, _mm512_mask_blend_pd(swap, c, s));
+    }
+
+    SIMD_TARGET_AVX512
+    void keplerAvx512(
+        const double* meanAnomalies, const double* eccentricities,
+        double* eccentricAnomalies, double* sines, double* cosines, std::size_t count
+        ) {
+        const __m512i signBit = _mm512_set1_epi64(qint64(1) << 63);
+        const __m512d twoPi = _mm512_set1_pd(TWO_PI);
+        const __m512d tolerance = _mm512_set1_pd(KEPLER_TOLERANCE);
+
+        std::size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m512d e = _mm512_loadu_pd(eccentricities + i);
+            const __m512d rawMeanAnomaly = _mm512_loadu_pd(meanAnomalies + i);
+            const __m512d turns = _mm512_roundscale_pd(_mm512_mul_pd(rawMeanAnomaly, _mm512_set1_pd(INVERSE_TWO_PI)),
+                                                       _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+            const __m512d meanAnomaly = _mm512_sub_pd(rawMeanAnomaly, _mm512_mul_pd(twoPi, turns));
+
+            const __m512d starter = _mm512_castsi512_pd(_mm512_or_si512(
+                _mm512_andnot_si512(signBit, _mm512_castpd_si512(_mm512_mul_pd(_mm512_set1_pd(KEPLER_STARTER), e))),
+                _mm512_and_si512(signBit, _mm512_castpd_si512(meanAnomaly))));
+            __m512d eccentricAnomaly = _mm512_add_pd(meanAnomaly, starter);
+            __m512d sine, cosine;
+            sinCosAvx512(eccentricAnomaly, sine, cosine);
+
+            __mmask8 active = 0xFF;
+            for (int iteration = 0; iteration < KEPLER_MAXIMUM_ITERATIONS && 0 != active; ++iteration) {
+                const __m512d f = _mm512_sub_pd(_mm512_sub_pd(eccentricAnomaly, _mm512_mul_pd(e, sine)), meanAnomaly);
+                const __m512d derivative = _mm512_sub_pd(_mm512_set1_pd(1.0), _mm512_mul_pd(e, cosine));
+                const __m512d secondDerivative = _mm512_mul_pd(e, sine);
+                const __m512d step = _mm512_div_pd(
+                    _mm512_mul_pd(f, derivative),
+                    _mm512_sub_pd(_mm512_mul_pd(derivative, derivative),
+                                  _mm512_mul_pd(_mm512_mul_pd(f, secondDerivative), _mm512_set1_pd(0.5))));
+
+                eccentricAnomaly = _mm512_mask_sub_pd(eccentricAnomaly, active, eccentricAnomaly, step);
+                sinCosAvx512(eccentricAnomaly, sine, cosine);
+                active &= _mm512_cmp_pd_mask(_mm512_abs_pd(step), tolerance, _CMP_NLE_UQ);
+            }
+
+            _mm512_storeu_pd(eccentricAnomalies + i, eccentricAnomaly);
+            if (nullptr != sines) _mm512_storeu_pd(sines + i, sine);
+            if (nullptr != cosines) _mm512_storeu_pd(cosines + i, cosine);
+        }
+        keplerScalar(meanAnomalies + i, eccentricities + i, eccentricAnomalies + i,
+                     nullptr != sines ? sines + i : nullptr, nullptr != cosines ? cosines + i : nullptr, count - i);
+    }
+#endif
+
+    using KeplerKernel = void (*)(const double*, const double*, double*, double*, double*, std::size_t);
+
+    KeplerKernel keplerKernel() {
+        switch (SimdDispatch::detectedLevel()) {
+#if SIMD_DISPATCH_X86
+        case SimdDispatch::Level::Avx512: return keplerAvx512;
+        case SimdDispatch::Level::Avx2: return keplerAvx2;
+#endif
+        default: return keplerScalar;
+        }
+    }
+}
+
+double OrbitalMath::eccentricAnomaly(double meanAnomaly, double eccentricity) {
+    double result;
+    keplerScalar(&meanAnomaly, &eccentricity, &result, nullptr, nullptr, 1);
+    return result;
+}
+
+void OrbitalMath::eccentricAnomalies(
+    std::span<const double> meanAnomalies, std::span<const double> eccentricities, std::span<double> out
+    ) {
+    keplerKernel()(meanAnomalies.data(), eccentricities.data(), out.data(), nullptr, nullptr, meanAnomalies.size());
+}
+
+void OrbitalMath::orbitalPositionsAfterDays(
+    const Planet& planet, std::span<const double> days,
+    std::span<double> angularPositions, std::span<double> x, std::span<double> y
+    ) {
+    // Planets without an orbit have no position (like in `NBodySimulation`)
+    if (!planet.hasOrbitalData()) {
+        if (!angularPositions.empty()) std::fill_n(angularPositions.begin(), days.size(), NAN);
+        if (!x.empty()) {
+            std::fill_n(x.begin(), days.size(), NAN);
+            std::fill_n(y.begin(), days.size(), NAN);
+        }
+        return;
+    }
+
+    const double orbitalPeriod = planet.getOrbitalPeriodInDays().value();
+    const double semiMajorAxis = planet.getOrbitalRadiusInAU().value();
+    const double eccentricity = planet.getEccentricity().value();
+    const double argumentOfPeriapsis = planet.getArgumentOfPeriapsisInDegrees().value();
+    const double epoch = planet.getEpochInDays().value();
+
+    const double semiMinorAxisRatio = std::sqrt(1 - eccentricity * eccentricity);
+    const double argumentOfPeriapsisInRadians = AngleUnit::convert(argumentOfPeriapsis, AngleUnit::DEGREES, AngleUnit::RADIANS);
+    const double periapsisCos = std::cos(argumentOfPeriapsisInRadians);
+    const double periapsisSin = std::sin(argumentOfPeriapsisInRadians);
+
+    const KeplerKernel kernel = keplerKernel();
+    alignas(64) double meanAnomalies[KEPLER_BLOCK];
+    alignas(64) double eccentricities[KEPLER_BLOCK];
+    alignas(64) double eccentricAnomalies[KEPLER_BLOCK];
+    alignas(64) double sines[KEPLER_BLOCK];
+    alignas(64) double cosines[KEPLER_BLOCK];
+    std::fill_n(eccentricities, KEPLER_BLOCK, eccentricity);
+
+    const qsizetype count = days.size();
+    for (qsizetype blockStart = 0; blockStart < count; blockStart += KEPLER_BLOCK) {
+        const qsizetype blockSize = std::min(KEPLER_BLOCK, count - blockStart);
+
+        // Mean anomalies, reduced in whole orbits first so that far-off days keep their precision
+        for (qsizetype j = 0; j < blockSize; ++j) {
+            const double orbits = (days[blockStart + j] - epoch) / orbitalPeriod;
+            meanAnomalies[j] = TWO_PI * (orbits - std::nearbyint(orbits));
+        }
+
+        kernel(meanAnomalies, eccentricities, eccentricAnomalies, sines, cosines, blockSize);
+
+        for (qsizetype j = 0; j < blockSize; ++j) {
+            // Position in the orbit's own frame (periapsis along the X axis), in units of the semi-major axis
+            const double orbitX = cosines[j] - eccentricity;
+            const double orbitY = semiMinorAxisRatio * sines[j];
+
+            if (!angularPositions.empty()) {
+                const double trueAnomaly = AngleUnit::convert(std::atan2(orbitY, orbitX), AngleUnit::RADIANS, AngleUnit::DEGREES);
+                double angle = std::fmod(argumentOfPeriapsis + trueAnomaly, 360.0);
+                if (angle < 0) angle += 360.0;
+                angularPositions[blockStart + j] = angle;
+            }
+            if (!x.empty()) {
+                x[blockStart + j] = semiMajorAxis * (orbitX * periapsisCos - orbitY * periapsisSin);
+                y[blockStart + j] = semiMajorAxis * (orbitX * periapsisSin + orbitY * periapsisCos);
+            }
+        }
+    }
+}
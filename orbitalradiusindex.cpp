@@ -0,0 +1,51 @@
+#include "orbitalradiusindex.h"
+#include "measurementunits.h"
+#include "solarsystem.h"
+
+#include <algorithm>
+
+OrbitalRadiusIndex::OrbitalRadiusIndex(const SolarSystem& solarSystem) {
+    // Sort planets with orbital data by orbital radius
+    for (qsizetype i = 0; i < solarSystem.size(); ++i) {
+        if (solarSystem.hasOrbitalData(i)) planetIndices.push_back(i);
+    }
+
+    const std::span<const double> orbitalRadii = solarSystem.orbitalRadiiInAU();
+    const std::span<const double> eccentricities = solarSystem.eccentricities();
+    std::sort(planetIndices.begin(), planetIndices.end(), [&orbitalRadii](qsizetype first, qsizetype second) {
+        return orbitalRadii[first] < orbitalRadii[second];
+    });
+
+    // Lay out the sorted columns
+    orbitalRadiiInAU.reserve(planetIndices.size());
+    bandHalfWidthsInAU.reserve(planetIndices.size());
+    for (const qsizetype planetIndex : planetIndices) {
+        const double radiusInAU = DistanceUnit::convert(solarSystem.getRadiusInMetres(planetIndex),
+                                                        DistanceUnit::METRES, DistanceUnit::AU);
+        // Periapsis and apoapsis are a(1 - e) and a(1 + e)
+        const double bandHalfWidthInAU = orbitalRadii[planetIndex] * eccentricities[planetIndex] + radiusInAU;
+        orbitalRadiiInAU.push_back(orbitalRadii[planetIndex]);
+        bandHalfWidthsInAU.push_back(bandHalfWidthInAU);
+        widestBandHalfWidthInAU = std::max(widestBandHalfWidthInAU, bandHalfWidthInAU);
+    }
+}
+
+void OrbitalRadiusIndex::findPlanetsInAnnulus(double innerRadius, double outerRadius, QList<qsizetype>& planetsFound) const {
+    // No band is wider than the widest one, so all candidates have their
+    // orbital radius within the annulus widened by that much on each side
+    const auto first = std::lower_bound(orbitalRadiiInAU.begin(), orbitalRadiiInAU.end(), innerRadius - widestBandHalfWidthInAU);
+    const auto last = std::upper_bound(first, orbitalRadiiInAU.end(), outerRadius + widestBandHalfWidthInAU);
+
+    // Then check each candidate's own band exactly
+    for (auto it = first; it != last; ++it) {
+        const qsizetype i = it - orbitalRadiiInAU.begin();
+        if (orbitalRadiiInAU[i] + bandHalfWidthsInAU[i] < innerRadius) continue;
+        if (orbitalRadiiInAU[i] - bandHalfWidthsInAU[i] > outerRadius) continue;
+
+        planetsFound.append(planetIndices[i]);
+    }
+}
+
+qsizetype OrbitalRadiusIndex::size() const {
+    return planetIndices.size();
+}
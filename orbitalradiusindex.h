@@ -0,0 +1,52 @@
+#ifndef ORBITALRADIUSINDEX_H
+#define ORBITALRADIUSINDEX_H
+
+#include "alignedvector.h"
+
+#include <QList>
+
+class SolarSystem;
+
+/**
+ * Index over the planets of a solar system, sorted by orbital radius,
+ * used to quickly find which planets can get in the way of a trip
+ * between two orbits.
+ *
+ * Each planet occupies the band of orbital radii between its periapsis
+ * minus its own radius and its apoapsis plus its own radius (for circular
+ * orbits, its orbital radius minus and plus its own radius). Queries find
+ * the planets whose band overlaps a given annulus with a binary search,
+ * so their cost grows with the number of planets in the annulus rather
+ * than with the size of the whole solar system. Very eccentric orbits
+ * widen every search, though.
+ *
+ * Planets lacking orbital data are not indexed.
+ */
+class OrbitalRadiusIndex
+{
+public:
+    OrbitalRadiusIndex() = default;
+    explicit OrbitalRadiusIndex(const SolarSystem& solarSystem);
+
+    /**
+     * Appends to `planetsFound` the indices (in the solar system) of all
+     * planets whose band overlaps the annulus between `innerRadius` and
+     * `outerRadius` (both in AU), in order of increasing orbital radius.
+     */
+    void findPlanetsInAnnulus(double innerRadius, double outerRadius, QList<qsizetype>& planetsFound) const;
+
+    /**
+     * Number of indexed planets.
+     */
+    qsizetype size() const;
+
+private:
+    // All sorted by orbital radius
+    AlignedVector<double> orbitalRadiiInAU;
+    AlignedVector<double> bandHalfWidthsInAU; // Own radius, plus the orbit's own spread if elliptical
+    std::vector<qsizetype> planetIndices;
+
+    double widestBandHalfWidthInAU = 0;
+};
+
+#endif // ORBITALRADIUSINDEX_H
@@ -1,35 +1,50 @@
 #include "planet.h"
+#include "solarsystem.h"
 
-Planet::Planet(const QString& name, double massInKilograms, double radiusInMetres)
-    : name(name)
-    , massInKilograms(massInKilograms)
-    , radiusInMetres(radiusInMetres) {}
+Planet::Planet(const SolarSystem& solarSystem, qsizetype index)
+    : solarSystem(&solarSystem)
+    , index(index) {}
 
-void Planet::setOrbitalCharacteristics(double orbitalPeriodInDays, double orbitalRadiusInAU) {
-    this->orbitalPeriodInDays = orbitalPeriodInDays;
-    this->orbitalRadiusInAU = orbitalRadiusInAU;
+const SolarSystem& Planet::getSolarSystem() const {
+    return *solarSystem;
+}
+
+qsizetype Planet::getIndex() const {
+    return index;
 }
 
 QString Planet::getName() const {
-    return name;
+    return solarSystem->getName(index);
 }
 
 double Planet::getMassInKilograms() const {
-    return massInKilograms;
+    return solarSystem->getMassInKilograms(index);
 }
 
 double Planet::getRadiusInMetres() const {
-    return radiusInMetres;
+    return solarSystem->getRadiusInMetres(index);
 }
 
 std::optional<double> Planet::getOrbitalPeriodInDays() const {
-    return orbitalPeriodInDays;
+    return solarSystem->getOrbitalPeriodInDays(index);
 }
 
 std::optional<double> Planet::getOrbitalRadiusInAU() const {
-    return orbitalRadiusInAU;
+    return solarSystem->getOrbitalRadiusInAU(index);
+}
+
+std::optional<double> Planet::getEccentricity() const {
+    return solarSystem->getEccentricity(index);
+}
+
+std::optional<double> Planet::getArgumentOfPeriapsisInDegrees() const {
+    return solarSystem->getArgumentOfPeriapsisInDegrees(index);
+}
+
+std::optional<double> Planet::getEpochInDays() const {
+    return solarSystem->getEpochInDays(index);
 }
 
 bool Planet::hasOrbitalData() const {
-    return orbitalPeriodInDays.has_value() && orbitalRadiusInAU.has_value();
+    return solarSystem->hasOrbitalData(index);
 }
@@ -3,24 +3,34 @@
 
 #include <QString>
 
+#include <optional>
+
+class SolarSystem;
+
+/**
+ * Lightweight view of a single planet stored in a `SolarSystem`.
+ * Does not own any data, so it must not outlive the solar system
+ * it refers to.
+ */
 class Planet
 {
 public:
-    Planet(const QString& name, double massInKilograms, double radiusInMetres);
-    void setOrbitalCharacteristics(double orbitalPeriodInDays, double orbitalRadiusInAU);
+    Planet(const SolarSystem& solarSystem, qsizetype index);
+    const SolarSystem& getSolarSystem() const;
+    qsizetype getIndex() const;
     QString getName() const;
     double getMassInKilograms() const;
     double getRadiusInMetres() const;
     std::optional<double> getOrbitalPeriodInDays() const;
     std::optional<double> getOrbitalRadiusInAU() const;
+    std::optional<double> getEccentricity() const;
+    std::optional<double> getArgumentOfPeriapsisInDegrees() const;
+    std::optional<double> getEpochInDays() const;
     bool hasOrbitalData() const;
 
 private:
-    QString name;
-    double massInKilograms;
-    double radiusInMetres;
-    std::optional<double> orbitalPeriodInDays;
-    std::optional<double> orbitalRadiusInAU;
+    const SolarSystem* solarSystem;
+    qsizetype index;
 };
 
 #endif // PLANET_H
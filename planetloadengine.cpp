@@ -0,0 +1,75 @@
+#include "planetloadengine.h"
+
+#include <QtConcurrent>
+
+#include <memory>
+#include <numeric>
+
+using PlanetChunkResult = CatalogLoader::ChunkResult<CatalogParser::PlanetData>;
+
+PlanetLoadEngine::PlanetLoadEngine(QObject *parent)
+    : QObject(parent)
+{
+    // Chunks may be done out of order; only hand back those whose predecessors all are
+    connect(&watcher, &QFutureWatcher<PlanetChunkResult>::resultReadyAt, this, [this](int) {
+        publishReadyChunks();
+    });
+    connect(&watcher, &QFutureWatcher<PlanetChunkResult>::finished, this, [this]() {
+        if (watcher.isCanceled()) return;
+
+        publishReadyChunks();
+        if (cache) cache->finishLoad();
+        // Let go of the parsed chunks (and of the file), which were only kept for handing back
+        watcher.setFuture(QFuture<PlanetChunkResult>());
+        emit finished();
+    });
+}
+
+PlanetLoadEngine::~PlanetLoadEngine()
+{
+    cancel();
+}
+
+bool PlanetLoadEngine::start(const QString& fileName, std::shared_ptr<CatalogLoader::ChunkCache<CatalogParser::PlanetData>> cache) {
+    cancel();
+    this->cache = cache;
+
+    // Owned by the load itself, so that the file stays mapped until all chunks are parsed
+    auto file = std::make_shared<CatalogLoader::CatalogFile>();
+    if (!file->open(fileName)) return false;
+
+    chunkCount = file->chunkCount();
+    chunksLoaded = 0;
+
+    QList<qsizetype> chunkIndices(chunkCount);
+    std::iota(chunkIndices.begin(), chunkIndices.end(), 0);
+
+    if (cache) cache->startLoad();
+    watcher.setFuture(QtConcurrent::mapped(std::move(chunkIndices), [file, cache](qsizetype chunkIndex) {
+        if (cache) return cache->parseChunk(*file, chunkIndex);
+        return file->parseChunk<CatalogParser::PlanetData>(chunkIndex, CatalogParser::parsePlanetLine);
+    }));
+
+    emit progressChanged(chunksLoaded, chunkCount);
+    return true;
+}
+
+void PlanetLoadEngine::cancel() {
+    watcher.cancel();
+    watcher.waitForFinished();
+}
+
+bool PlanetLoadEngine::isRunning() const {
+    return watcher.isRunning();
+}
+
+void PlanetLoadEngine::publishReadyChunks() {
+    const QFuture<PlanetChunkResult> future = watcher.future();
+    while (chunksLoaded < chunkCount && !watcher.isCanceled() && future.isResultReadyAt(int(chunksLoaded))) {
+        const PlanetChunkResult chunkResult = future.resultAt(int(chunksLoaded));
+        ++chunksLoaded;
+
+        emit batchLoaded(chunkResult.entries, chunkResult.errors);
+        emit progressChanged(chunksLoaded, chunkCount);
+    }
+}
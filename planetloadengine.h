@@ -0,0 +1,61 @@
+#ifndef PLANETLOADENGINE_H
+#define PLANETLOADENGINE_H
+
+#include "catalogloader.h"
+
+#include <QFutureWatcher>
+#include <QObject>
+
+#include <memory>
+
+/**
+ * Loads planet data files (see `CatalogLoader`) in the background: the
+ * file's chunks are parsed on the global thread pool, and handed back (on
+ * the engine's thread) in file order as soon as they and all the chunks
+ * before them are done, so that planets can be shown while the rest of the
+ * file is still being parsed.
+ */
+class PlanetLoadEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PlanetLoadEngine(QObject *parent = nullptr);
+    ~PlanetLoadEngine();
+
+    /**
+     * Starts loading the given planet data file, cancelling any load still
+     * in progress. Returns false (and emits nothing) if the file could not
+     * be opened. If a cache is given, chunks are parsed through it (so that
+     * they can be reused when the file is loaded again).
+     */
+    bool start(const QString& fileName, std::shared_ptr<CatalogLoader::ChunkCache<CatalogParser::PlanetData>> cache = nullptr);
+
+    /**
+     * Cancels the load in progress (if any) and waits for chunks already
+     * being parsed to be done. No more signals are emitted for a cancelled
+     * load.
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+signals:
+    /**
+     * The planets parsed from the next chunk of the file, and the problems
+     * found in it.
+     */
+    void batchLoaded(const QList<CatalogParser::PlanetData>& planetDataList, const QList<QString>& errors);
+    void progressChanged(qsizetype chunksLoaded, qsizetype chunkCount);
+    void finished();
+
+private:
+    QFutureWatcher<CatalogLoader::ChunkResult<CatalogParser::PlanetData>> watcher;
+    std::shared_ptr<CatalogLoader::ChunkCache<CatalogParser::PlanetData>> cache;
+    qsizetype chunkCount = 0;
+    qsizetype chunksLoaded = 0; // Chunks handed back so far, i.e. index of the next one to hand back
+
+    void publishReadyChunks();
+};
+
+#endif // PLANETLOADENGINE_H
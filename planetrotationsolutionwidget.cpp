@@ -14,6 +14,20 @@ PlanetRotationSolutionWidget::PlanetRotationSolutionWidget(QWidget *parent)
     planetRotationTableModel->setHorizontalHeaderLabels({"Name", "Angular Position"});
     ui->planetRotationTable->setModel(planetRotationTableModel);
     ui->planetRotationTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    // Show simulated positions once the simulation got to the day asked for
+    ui->simulationProgressBar->setVisible(false);
+    connect(&nBodyEngine, &NBodyEngine::progressChanged, this, [this](qsizetype batchesDone, qsizetype batchCount) {
+        ui->simulationProgressBar->setMaximum(int(batchCount));
+        ui->simulationProgressBar->setValue(int(batchesDone));
+    });
+    connect(&nBodyEngine, &NBodyEngine::finished, this, [this]() {
+        ui->simulationProgressBar->setVisible(false);
+
+        std::vector<double> planetAngles(planets->size());
+        for (qsizetype i = 0; i < planets->size(); ++i) planetAngles[i] = nBodySimulation->angularPosition(i);
+        fillPlanetRotationTable(planetAngles);
+    });
 }
 
 PlanetRotationSolutionWidget::~PlanetRotationSolutionWidget()
@@ -22,10 +36,14 @@ PlanetRotationSolutionWidget::~PlanetRotationSolutionWidget()
     delete ui;
 }
 
-void PlanetRotationSolutionWidget::setPlanets(const QList<Planet>& newPlanets) {
+void PlanetRotationSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
     // Store reference to planets
     planets = &newPlanets;
 
+    // Any simulation was of the old planets
+    nBodyEngine.cancel();
+    nBodySimulation.reset();
+
     if (!planets->empty()) {
         // Update and display table
         updatePlanetRotationTable();
@@ -39,32 +57,57 @@ void PlanetRotationSolutionWidget::on_daysElapsedSpinBox_valueChanged(int newDay
     updatePlanetRotationTable();
 }
 
+void PlanetRotationSolutionWidget::on_nBodySimulationCheckBox_toggled(bool checked)
+{
+    updatePlanetRotationTable();
+}
+
 void PlanetRotationSolutionWidget::updatePlanetRotationTable() {
-    if (nullptr != planets && !planets->empty()) {
-        // Clear table of old data and re-set-up
-        planetRotationTableModel->clear(); // Also clears header row
-        planetRotationTableModel->setHorizontalHeaderLabels({"Name", "Angular Position"});
-        planetRotationTableModel->setRowCount(planets->length());
-
-        // Fetch days elapsed since time 0 (when all planets were at angle 0°)
-        const int daysElapsed = ui->daysElapsedSpinBox->value();
-
-        // Insert planets into table
-        for (int i = 0; i < planets->length(); ++i) {
-            const Planet& planet = planets->at(i);
-
-            // Insert planet name
-            planetRotationTableModel->setData(planetRotationTableModel->index(i, 0), planet.getName());
-
-            if (planet.getOrbitalPeriodInDays().has_value()) {
-                // If planet has orbital data, compute angle and insert
-                const double planetAngle = OrbitalMath::angularPositionAfterDays(planet, daysElapsed);
-                planetRotationTableModel->setData(planetRotationTableModel->index(i, 1), QString("%1°").arg(planetAngle));
-            }
-            else {
-                // If planet does not have orbital data, say as such
-                planetRotationTableModel->setData(planetRotationTableModel->index(i, 1), "No orbital data");
-            }
+    if (nullptr == planets || planets->empty()) return;
+
+    // Any simulation still running was heading for another day
+    nBodyEngine.cancel();
+    ui->simulationProgressBar->setVisible(false);
+
+    // Fetch days elapsed since time 0 (when all planets were at angle 0°)
+    const int daysElapsed = ui->daysElapsedSpinBox->value();
+
+    if (ui->nBodySimulationCheckBox->isChecked()) {
+        // Simulating can take a while, so it is done in the background and
+        // the table filled in once it is done (see constructor)
+        if (!nBodySimulation) nBodySimulation.emplace(*planets);
+        ui->simulationProgressBar->setValue(0);
+        ui->simulationProgressBar->setVisible(true);
+        nBodyEngine.start(*nBodySimulation, daysElapsed);
+    }
+    else {
+        // Compute all angles at once with the Keplerian model, or the planets' position source
+        // if they have one (as a single-column ephemeris grid)
+        const OrbitalMath::EphemerisGrid planetAngleGrid = OrbitalMath::ephemerisGrid(*planets, daysElapsed, 0, 1);
+        std::vector<double> planetAngles(planets->size());
+        for (qsizetype i = 0; i < planets->size(); ++i) planetAngles[i] = planetAngleGrid.angularPosition(i, 0);
+        fillPlanetRotationTable(planetAngles);
+    }
+}
+
+void PlanetRotationSolutionWidget::fillPlanetRotationTable(const std::vector<double>& planetAngles) {
+    // Clear table of old data and re-set-up
+    planetRotationTableModel->clear(); // Also clears header row
+    planetRotationTableModel->setHorizontalHeaderLabels({"Name", "Angular Position"});
+    planetRotationTableModel->setRowCount(planets->size());
+
+    // Insert planets into table
+    for (qsizetype i = 0; i < planets->size(); ++i) {
+        // Insert planet name
+        planetRotationTableModel->setData(planetRotationTableModel->index(i, 0), planets->getName(i));
+
+        if (planets->hasOrbitalData(i)) {
+            // If planet has orbital data, insert angle
+            planetRotationTableModel->setData(planetRotationTableModel->index(i, 1), QString("%1°").arg(planetAngles[i]));
+        }
+        else {
+            // If planet does not have orbital data, say as such
+            planetRotationTableModel->setData(planetRotationTableModel->index(i, 1), "No orbital data");
         }
     }
 }
@@ -4,7 +4,12 @@
 #include <QWidget>
 #include <QStandardItemModel>
 
-#include "planet.h"
+#include "nbodyengine.h"
+#include "nbodysimulation.h"
+#include "solarsystem.h"
+
+#include <optional>
+#include <vector>
 
 namespace Ui {
 class PlanetRotationSolutionWidget;
@@ -19,17 +24,23 @@ public:
     ~PlanetRotationSolutionWidget();
 
 public slots:
-    void setPlanets(const QList<Planet>& newPlanets);
+    void setPlanets(const SolarSystem& newPlanets);
 
 private slots:
     void on_daysElapsedSpinBox_valueChanged(int newDaysElapsed);
+    void on_nBodySimulationCheckBox_toggled(bool checked);
 
 private:
     Ui::PlanetRotationSolutionWidget *ui;
     QStandardItemModel* planetRotationTableModel;
-    const QList<Planet>* planets = nullptr;
+    const SolarSystem* planets = nullptr;
+
+    // Built on first use for the current planets, then advanced (in the background) as days elapse
+    std::optional<NBodySimulation> nBodySimulation;
+    NBodyEngine nBodyEngine; // Declared after the simulation, so that it stops using it before it goes
 
     void updatePlanetRotationTable();
+    void fillPlanetRotationTable(const std::vector<double>& planetAngles);
 };
 
 #endif // PLANETROTATIONSOLUTIONWIDGET_H
@@ -1,11 +1,19 @@
 #include "planetswidget.h"
 #include "ui_planetswidget.h"
+#include "catalogloader.h"
+#include "catalogsnapshot.h"
 #include "dialogutils.h"
 #include "measurementunits.h"
 
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QHash>
+#include <QSet>
 #include <QMessageBox>
 
+#include <utility>
+#include <vector>
+
 PlanetsWidget::PlanetsWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::PlanetsWidget)
@@ -20,350 +28,514 @@ PlanetsWidget::PlanetsWidget(QWidget *parent)
     planetTableModel->setHorizontalHeaderLabels({"Name", "Radius", "Mass"});
     ui->planetsTable->setModel(planetTableModel);
     ui->planetsTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+
+    // Planet data files are loaded in the background; the progress bar only shows meanwhile
+    ui->loadingWidget->setVisible(false);
+    connect(&loadEngine, &PlanetLoadEngine::batchLoaded, this, &PlanetsWidget::addPlanetBatch);
+    connect(&loadEngine, &PlanetLoadEngine::progressChanged, this, &PlanetsWidget::showLoadingProgress);
+    connect(&loadEngine, &PlanetLoadEngine::finished, this, [this]() {
+        finishLoadingPlanets(false);
+    });
+
+    // Reload once the watched files stop changing for a moment
+    reloadTimer.setSingleShot(true);
+    reloadTimer.setInterval(250);
+    connect(&reloadTimer, &QTimer::timeout, this, &PlanetsWidget::reloadChangedFiles);
+    connect(&fileWatcher, &QFileSystemWatcher::fileChanged, this, [this]() {
+        reloadTimer.start();
+    });
+    // Files replaced rather than written to (as editors often do on save) drop out of
+    // the watcher, so also watch their directories for them to come back
+    connect(&fileWatcher, &QFileSystemWatcher::directoryChanged, this, [this]() {
+        const QStringList watchedFiles = fileWatcher.files();
+        for (const QString& fileName : {planetDataFileName, orbitalDataFileName}) {
+            if (!fileName.isEmpty() && !watchedFiles.contains(fileName) && QFileInfo::exists(fileName)) reloadTimer.start();
+        }
+    });
+
+    // N-body positions are recorded in the background, and only replace the
+    // Keplerian ones once recorded in full, so the progress bar only shows meanwhile
+    ui->nBodyProgressBar->setVisible(false);
+    connect(&nBodyEngine, &NBodyEngine::progressChanged, this, [this](qsizetype batchesDone, qsizetype batchCount) {
+        ui->nBodyProgressBar->setMaximum(int(batchCount));
+        ui->nBodyProgressBar->setValue(int(batchesDone));
+    });
+    connect(&nBodyEngine, &NBodyEngine::finished, this, [this]() {
+        ui->nBodyProgressBar->setVisible(false);
+        planets.setPositionSource(std::move(nBodyEphemeris));
+        nBodySimulation.reset();
+
+        // Every planet moved
+        emit planetsChanged(planets);
+    });
 }
 
 PlanetsWidget::~PlanetsWidget()
 {
+    loadEngine.cancel();
+    nBodyEngine.cancel();
     delete planetTableModel;
     delete ui;
 }
 
-struct PlanetData {
-    QString name;
-    double diameter;
-    DistanceUnit diameterUnit = DistanceUnit::INVALID;
-    double mass;
-    MassUnit massUnit = MassUnit::INVALID;
-};
-
-QList<PlanetData> readPlanetData(const QString& planetFileName) { // TODO: warn caller if invalid data (hence no reading)
-    QList<PlanetData> planetDataList;
+using CatalogParser::PlanetData;
+using CatalogParser::PlanetOrbitalData;
 
-    QFile planetFile(planetFileName);
-    if (planetFile.open(QIODeviceBase::ReadOnly)) {
-        QTextStream in(&planetFile);
-        QList<QString> errors;
-
-        while(!in.atEnd()) {
-            // Read lines one by one and parse
-            QString line = in.readLine();
-            if (line.trimmed().isEmpty()) continue; // Skip empty lines, including whitespace-only
+namespace {
+    void addLoadedPlanet(SolarSystem& planets, const PlanetData& planetData, double earthMass) {
+        double radiusInMetres, massInKilograms;
 
-            PlanetData planetData;
-            const auto errorsAtStart = errors.length(); // Hacky way to check if any new errors were added
+        // Compute radius
+        radiusInMetres = DistanceUnit::convert(planetData.diameter / 2.0, planetData.diameterUnit, DistanceUnit::METRES);
 
-            // Extract data from string
-            // Using multiple regexes is less efficient, but allows files to
-            // reorder, e.g., diameter and mass, and have the parsing still work
+        // Compute mass, handling Earth-relative masses separately
+        if (planetData.massUnit == MassUnit::EARTHS) massInKilograms = planetData.mass * earthMass;
+        else massInKilograms = MassUnit::convert(planetData.mass, planetData.massUnit, MassUnit::KILOGRAMS);
 
-            // Planet name
-            static QRegularExpression nameRegex("^([a-zA-Z _0-9]+):");
-            QRegularExpressionMatch nameMatch = nameRegex.match(line);
-            if (!nameMatch.hasMatch()) {
-                errors.append(QString("No planet name specified in line '%1'; use format '<Planet name>: [...]'").arg(line));
-            }
-            else planetData.name = nameRegex.match(line).captured(1);
+        planets.addPlanet(planetData.name, massInKilograms, radiusInMetres);
+    }
 
-            // Planet radius and unit
-            static QRegularExpression diameterRegex("diameter = ([0-9]+(?:.[0-9]+)?) ([a-z]+)");
-            QRegularExpressionMatch diameterMatch = diameterRegex.match(line);
-            if (!diameterMatch.hasMatch()) {
-                errors.append(QString("No diameter specified in line '%1'; use format 'diameter = <value> <m|km>'").arg(line));
-            }
-            else {
-                bool okConversion;
-                planetData.diameter = diameterMatch.captured(1).toDouble(&okConversion);
-                if (!okConversion) errors.append(QString("Invalid diameter value '%1'").arg(diameterMatch.captured(1)));
-
-                planetData.diameterUnit = DistanceUnit::parse(diameterMatch.captured(2));
-                if (DistanceUnit::INVALID == planetData.diameterUnit) {
-                    errors.append(QString("Invalid distance unit '%1' in line '%2'; expected 'km' or 'm'")
-                                      .arg(diameterMatch.captured(2), line));
+    /**
+     * Adds parsed planets to `planets`, in order. Many planets are stated
+     * relative to Earth's mass; those are held back in `planetsAwaitingEarth`
+     * until Earth comes in (in these planets or later ones).
+     */
+    void addLoadedPlanets(
+        SolarSystem& planets, const QList<PlanetData>& planetDataList,
+        std::optional<double>& earthMass, QList<PlanetData>& planetsAwaitingEarth
+        ) {
+        for (const PlanetData& planetData : planetDataList) {
+            if (!earthMass.has_value() && planetData.name == "Earth") {
+                earthMass = planetData.mass;
+                addLoadedPlanet(planets, planetData, earthMass.value());
+
+                for (const PlanetData& planetAwaitingEarth : std::as_const(planetsAwaitingEarth)) {
+                    addLoadedPlanet(planets, planetAwaitingEarth, earthMass.value());
                 }
+                planetsAwaitingEarth.clear();
             }
+            else if (!earthMass.has_value() && planetData.massUnit == MassUnit::EARTHS) planetsAwaitingEarth.append(planetData);
+            else addLoadedPlanet(planets, planetData, earthMass.value_or(0.0));
+        }
+    }
 
-            // Planet mass and unit
-            static QRegularExpression massRegex("mass = ([0-9]+(?:.[0-9]+)?)(?: \\* 10\\^([0-9]+))? ([a-zA-Z]+)");
-            QRegularExpressionMatch massMatch = massRegex.match(line);
-            // See something like https://www.debuggex.com/ for visualisation (watch for escaped backslash!)
-            // Basically, we accept mass in decimal + digits format w/ optional power-of-10 factor
-            if (!massMatch.hasMatch()) {
-                errors.append(QString("No mass specified in line '%1'; use format 'mass = <value> <kg|t|Earths>'").arg(line));
+    /**
+     * Checks what is left once all planets are in: planets stated relative to
+     * Earth when Earth never came in have an invalid mass, and a file without
+     * problems should still have planets.
+     */
+    void checkLoadedPlanets(const SolarSystem& planets, const QList<PlanetData>& planetsAwaitingEarth, QList<QString>& errors) {
+        for (const PlanetData& planetAwaitingEarth : planetsAwaitingEarth) {
+            errors.append(QString("Planet '%1' uses mass unit 'Earths' but Earth was not defined").arg(planetAwaitingEarth.name));
+        }
+
+        // If no other issues encountered but still no planet data, notify user
+        if (planets.empty() && errors.empty()) errors.append("File contains no planet data");
+    }
+
+    /**
+     * Resolves the units of parsed orbital data entries, giving the orbits in
+     * the units solar systems hold them in.
+     */
+    OrbitalDataColumns resolveOrbitalData(const QList<PlanetOrbitalData>& planetDataList) {
+        OrbitalDataColumns orbits;
+        orbits.reserve(planetDataList.size());
+        for (const PlanetOrbitalData& planetData : planetDataList) {
+            orbits.append(
+                planetData.name,
+                TimeUnit::convert(planetData.period, planetData.periodUnit, TimeUnit::DAYS),
+                DistanceUnit::convert(planetData.orbitalRadius, planetData.orbitalRadiusUnit, DistanceUnit::AU),
+                planetData.eccentricity,
+                AngleUnit::convert(planetData.argumentOfPeriapsis, planetData.argumentOfPeriapsisUnit, AngleUnit::DEGREES),
+                TimeUnit::convert(planetData.epoch, planetData.epochUnit, TimeUnit::DAYS)
+                );
+        }
+        return orbits;
+    }
+
+    /**
+     * Sets the orbital characteristics of `planets` from orbits matched by
+     * name, noting planets and orbits left unmatched in `errors`.
+     */
+    void attachOrbitalData(SolarSystem& planets, const OrbitalDataColumns& orbits, QList<QString>& errors) {
+        // Index orbits by name. Orbits sharing a name are chained in file
+        // order, so each planet takes the first orbit with its name that an
+        // earlier planet of the same name has not already taken
+        QHash<QString, qsizetype> firstUnmatchedEntry;
+        firstUnmatchedEntry.reserve(orbits.size());
+        std::vector<qsizetype> nextEntryWithSameName(orbits.size(), -1);
+        for (qsizetype j = orbits.size() - 1; j >= 0; --j) {
+            const auto existingEntry = firstUnmatchedEntry.constFind(orbits.names[j]);
+            if (existingEntry != firstUnmatchedEntry.constEnd()) nextEntryWithSameName[j] = existingEntry.value();
+            firstUnmatchedEntry.insert(orbits.names[j], j);
+        }
+
+        // Find the planet of each orbit
+        std::vector<qsizetype> planetIndices(orbits.size(), -1);
+        for (qsizetype i = 0; i < planets.size(); ++i) {
+            const QString& planetName = planets.getName(i);
+
+            const auto matchingEntry = firstUnmatchedEntry.find(planetName);
+            if (matchingEntry != firstUnmatchedEntry.end() && -1 != matchingEntry.value()) {
+                // Mark as used, and leave any later orbit of the same name to the next planet of that name
+                const qsizetype indexFound = matchingEntry.value();
+                planetIndices[indexFound] = i;
+                matchingEntry.value() = nextEntryWithSameName[indexFound];
             }
             else {
-                // FIXME: currently, mass regex fails on exponent-only mass, like "10^26 kg"
-                // TODO: maybe switch to capturing mass in two steps?
-                // e.g. catch "6 * 10 ^ 24" wholesale first, then break that down into "6" base and "24" exponent
-                bool okConversion;
-                if(!massMatch.captured(2).isEmpty()) {
-                    // Apply exponent, if it exists. Use 6e24 notation since that's what toDouble() reads.
-                    planetData.mass = (massMatch.captured(1) + "e" + massMatch.captured(2)).toDouble(&okConversion);
-                    if (!okConversion) {
-                        errors.append(QString("Invalid mass value '%1 * 10 ^ %2' in line '%3'")
-                                          .arg(massMatch.captured(1), massMatch.captured(2), line));
-                    }
-                }
-                else {
-                    planetData.mass = massMatch.captured(1).toDouble(&okConversion);
-                    if (!okConversion) errors.append(QString("Invalid mass value '%1' in line '%2'")
-                                          .arg(massMatch.captured(1), line));
-                }
-
-                planetData.massUnit = MassUnit::parse(massMatch.captured(3));
-                if (MassUnit::INVALID == planetData.massUnit) {
-                    errors.append(QString("Invalid mass unit '%1' in line '%2'; expected 'kg' or 't' or 'Earths'")
-                                      .arg(massMatch.captured(3), line));
-                }
+                errors.append(QString("No orbital data specified for planet %1").arg(planetName));
             }
+        }
+
+        // Add data to planets, all at once
+        planets.setOrbitalCharacteristics(orbits, planetIndices);
 
-            // If no new errors were encountered (i.e. this line is fine), add to dataset
-            if (errors.length() == errorsAtStart) planetDataList.append(planetData);
+        // Check any unhandled data and warn user
+        for (qsizetype j = 0; j < orbits.size(); ++j) {
+            if (-1 == planetIndices[j]) errors.append(QString("Orbital data given for unknown planet %1").arg(orbits.names[j]));
         }
-        // If no other issues encountered but still no planet data, notify user
-        if (planetDataList.empty() && errors.empty()) errors.append("File contains no planet data");
+    }
+}
 
-        if (!errors.empty()) DialogUtils::showError(errors.join('\n'));
+void PlanetsWidget::on_readPlanetsButton_clicked()
+{
+    // Open a file-picker dialog to fetch planet data from a file
+    QString planetFileName = QFileDialog::getOpenFileName(this, tr("Select a planet data file"));
 
-    } else {
+    loadingFileName = planetFileName;
+    loadingPlanets.clear();
+    loadingErrors.clear();
+    reportedErrors.clear();
+    earthMass.reset();
+    planetsAwaitingEarth.clear();
+
+    // Use the file's snapshot if it is up to date
+    if (CatalogSnapshot::readPlanets(planetFileName, loadingPlanets)) {
+        updatePlanetsTable(loadingPlanets);
+        adoptLoadedPlanets();
+    }
+    // Otherwise parse it in the background, filling the table as planets come in
+    else if (loadEngine.start(planetFileName, planetChunkCache)) {
+        isLoading = true;
+        updatePlanetsTable(loadingPlanets);
+        ui->loadingWidget->setVisible(true);
+        ui->readPlanetsButton->setEnabled(false);
+        ui->readOrbitalDataButton->setVisible(false);
+    }
+    else {
         if (planetFileName.isEmpty()) DialogUtils::showError("No file selected");
         else DialogUtils::showError(QString("Could not open file %1").arg(planetFileName));
+        loadingFileName.clear();
+        adoptLoadedPlanets();
     }
+}
 
-    return planetDataList;
+void PlanetsWidget::on_cancelLoadingButton_clicked()
+{
+    // Keep the planets loaded so far
+    loadEngine.cancel();
+    finishLoadingPlanets(true);
 }
 
-QList<Planet> processPlanetData(const QList<PlanetData>& planetDataList) {
-    QList<Planet> planets;
-
-    // Find Earth mass, since many planets are stated relative to that
-    double earthMass = 0.0;
-    bool earthFound = false;
-    for (const PlanetData& planetDataEntry : planetDataList) {
-        if (planetDataEntry.name == "Earth") {
-            earthFound = true;
-            earthMass = planetDataEntry.mass;
-            break;
-        }
-    }
+void PlanetsWidget::addPlanetBatch(const QList<PlanetData>& planetDataList, const QList<QString>& errors) {
+    loadingErrors.append(errors);
 
-    // Process everyone else
-    for (const PlanetData& planetDataEntry : planetDataList) {
-        double radiusInMetres, massInKilograms;
+    const qsizetype firstNewPlanet = loadingPlanets.size();
+    addLoadedPlanets(loadingPlanets, planetDataList, earthMass, planetsAwaitingEarth);
 
-        // Compute radius
-        radiusInMetres = DistanceUnit::convert(planetDataEntry.diameter / 2.0, planetDataEntry.diameterUnit, DistanceUnit::METRES);
+    appendToPlanetsTable(loadingPlanets, firstNewPlanet);
 
-        // Compute mass
-        if (planetDataEntry.massUnit == MassUnit::EARTHS) {
-            // Handle Earth separately
+    // Only update everyone else as planets come in if asked to
+    if (ui->updateWhileLoadingCheckBox->isChecked()) emit planetsChanged(loadingPlanets);
+}
 
-            if (!earthFound) {
-                DialogUtils::showError(
-                    QString("Planet '%1' uses mass unit 'Earths' but Earth was not defined").arg(planetDataEntry.name)
-                );
-                continue; // Skip entry since it has invalid mass
-            }
-            else massInKilograms = planetDataEntry.mass * earthMass;
-        }
-        else {
-            massInKilograms = MassUnit::convert(planetDataEntry.mass, planetDataEntry.massUnit, MassUnit::KILOGRAMS);
-        }
+void PlanetsWidget::showLoadingProgress(qsizetype chunksLoaded, qsizetype chunkCount) {
+    ui->loadingProgressBar->setMaximum(int(chunkCount));
+    ui->loadingProgressBar->setValue(int(chunksLoaded));
+}
 
-        planets.append(Planet(planetDataEntry.name, massInKilograms, radiusInMetres));
-    }
+void PlanetsWidget::finishLoadingPlanets(bool cancelled) {
+    if (!isLoading) return;
+    isLoading = false;
 
-    return planets;
-}
+    if (!cancelled) {
+        checkLoadedPlanets(loadingPlanets, planetsAwaitingEarth, loadingErrors);
 
-void PlanetsWidget::on_readPlanetsButton_clicked()
-{
-    // Open a file-picker dialog to fetch planet data from a file
-    QString planetFileName = QFileDialog::getOpenFileName(this, tr("Select a planet data file"));
+        // Snapshot the file for next time if it had no problems
+        if (loadingErrors.empty()) CatalogSnapshot::writePlanets(loadingFileName, loadingPlanets);
+        else DialogUtils::showError(loadingErrors.join('\n'));
+        reportedErrors = loadingErrors;
+    }
+    planetsAwaitingEarth.clear();
 
-    QList<PlanetData> parsedPlanetData = readPlanetData(planetFileName);
+    ui->loadingWidget->setVisible(false);
+    ui->readPlanetsButton->setEnabled(true);
 
-    QList<Planet> parsedPlanets = processPlanetData(parsedPlanetData);
+    adoptLoadedPlanets();
+}
 
-    // Update table and data model
-    planets = parsedPlanets;
-    updatePlanetsTable(planets);
+void PlanetsWidget::adoptLoadedPlanets() {
+    // Update data model; the table already shows the new planets
+    planets = std::move(loadingPlanets);
+    loadingPlanets.clear();
+    if (planets.empty()) updatePlanetsTable(planets);
 
     // Make "read orbital data" button visible if we have planets
     ui->readOrbitalDataButton->setVisible(!planets.empty());
 
+    // Watch the new file instead, if watching
+    planetDataFileName = loadingFileName;
+    orbitalDataFileName.clear();
+    updateWatchedFiles();
+
     // Emit signal
     emit planetsChanged(planets);
-}
 
-struct PlanetOrbitalData {
-    QString name;
-    double period;
-    TimeUnit periodUnit = TimeUnit::INVALID;
-    double orbitalRadius;
-    DistanceUnit orbitalRadiusUnit = DistanceUnit::INVALID;
-};
+    // New planets have no orbits yet, so drop any N-body positions being recorded
+    updateNBodyPositions();
+}
 
 void PlanetsWidget::on_readOrbitalDataButton_clicked()
 {
     QList<PlanetOrbitalData> planetDataList;
+    OrbitalDataColumns orbits;
     QList<QString> errors;
 
     // Open, parse, and process orbital data file
     QString planetFileName = QFileDialog::getOpenFileName(this, tr("Select a planet data file"));
 
-    QFile planetFile(planetFileName);
-    if (planetFile.open(QIODeviceBase::ReadOnly)) {
-        QTextStream in(&planetFile);
-
-        while(!in.atEnd()) {
-            // Read lines one by one and parse
-            QString line = in.readLine();
-            if (line.trimmed().isEmpty()) continue; // Skip empty lines, including whitespace-only
-
-            PlanetOrbitalData planetData;
-            const auto errorsAtStart = errors.length(); // Hacky way to check if any new errors were added
-
-            // Extract data from string
-            // Using multiple regexes is less efficient, but allows files to
-            // reorder, e.g., diameter and mass, and have the parsing still work
+    if (CatalogSnapshot::readOrbitalData(planetFileName, orbits)) {
+        // Up-to-date snapshot, which is only taken of files without problems
+        orbitalDataFileName = planetFileName;
 
-            // Planet name
-            static QRegularExpression nameRegex("^([a-zA-Z _0-9]+):");
-            QRegularExpressionMatch nameMatch = nameRegex.match(line);
-            if (!nameMatch.hasMatch()) {
-                errors.append(QString("No planet name specified in line '%1'; use format '<Planet name>: [...]'").arg(line));
-            }
-            else planetData.name = nameRegex.match(line).captured(1);
-
-            // Planet period and unit
-            static QRegularExpression periodRegex("period = ([0-9]+(?:.[0-9]+)?) ([a-z]+)");
-            QRegularExpressionMatch periodMatch = periodRegex.match(line);
-            if (!periodMatch.hasMatch()) {
-                errors.append(QString("No period specified in line '%1'; use format 'period = <value> <s|h|days>'").arg(line));
-            }
-            else {
-                bool okConversion;
-                planetData.period = periodMatch.captured(1).toDouble(&okConversion);
-                if (!okConversion) errors.append(QString("Invalid period value '%1'").arg(periodMatch.captured(1)));
-
-                planetData.periodUnit = TimeUnit::parse(periodMatch.captured(2));
-                if (TimeUnit::INVALID == planetData.periodUnit) {
-                    errors.append(QString("Invalid time unit '%1' in line '%2'; expected 's' or 'h' or 'days'")
-                                      .arg(periodMatch.captured(2), line));
-                }
-            }
-
-            // Planet orbital radius
-            static QRegularExpression orbitalRadiusRegex("orbital radius = ([0-9]+(?:.[0-9]+)?) ([a-zA-Z]+)");
-            QRegularExpressionMatch orbitalRadiusMatch = orbitalRadiusRegex.match(line);
-            if (!orbitalRadiusMatch.hasMatch()) {
-                errors.append(QString("No orbital radius specified in line '%1'; use format 'orbital radius = <value> <m|km|AU>'").arg(line));
-            }
-            else {
-                bool okConversion;
-                planetData.orbitalRadius = orbitalRadiusMatch.captured(1).toDouble(&okConversion);
-                if (!okConversion) errors.append(QString("Invalid orbital radius value '%1'").arg(orbitalRadiusMatch.captured(1)));
-
-                planetData.orbitalRadiusUnit = DistanceUnit::parse(orbitalRadiusMatch.captured(2));
-                if (DistanceUnit::INVALID == planetData.orbitalRadiusUnit) {
-                    errors.append(QString("Invalid distance unit '%1' in line '%2'; expected 'm' or 'km' or 'AU'")
-                                      .arg(orbitalRadiusMatch.captured(2), line));
-                }
-            }
-
-            // If no new errors were encountered (i.e. this line is fine), add to dataset
-            if (errors.length() == errorsAtStart) planetDataList.append(planetData);
-        }
+    } else if (CatalogLoader::loadOrbitalData(planetFileName, planetDataList, errors, orbitalDataChunkCache.get())) {
         // If no other issues encountered but still no planet data, notify user
         if (planetDataList.empty() && errors.empty()) errors.append("File contains no planet data");
+        orbits = resolveOrbitalData(planetDataList);
+
+        // Snapshot the file for next time if it had no problems
+        if (errors.empty()) CatalogSnapshot::writeOrbitalData(planetFileName, orbits);
+        orbitalDataFileName = planetFileName;
 
     } else {
         if (planetFileName.isEmpty()) DialogUtils::showError("No file selected");
         else DialogUtils::showError(QString("Could not open file %1").arg(planetFileName));
     }
+    updateWatchedFiles();
 
-    // Add data to planets
-    for (int i = 0; i < planets.length(); ++i) {
-        Planet& planet = planets[i];
-
-        // Find matching planet orbital data and remove from list
-        // This is a bit inefficient if lists are wildly out-of-order
-        // so it might be an optimization target
-        PlanetOrbitalData matchingOrbitalData;
-        int indexFound = -1;
-        for (int j = 0; j < planetDataList.length(); ++j) {
-            const PlanetOrbitalData& orbitalData = planetDataList[j];
-
-            if (orbitalData.name == planet.getName()) {
-                matchingOrbitalData = orbitalData;
-                indexFound = j;
-                break;
-            }
-        }
-
-        if (-1 != indexFound) {
-            double periodInDays = TimeUnit::convert(matchingOrbitalData.period, matchingOrbitalData.periodUnit, TimeUnit::DAYS);
-            double orbitalRadiusInAU = DistanceUnit::convert(
-                matchingOrbitalData.orbitalRadius,
-                matchingOrbitalData.orbitalRadiusUnit,
-                DistanceUnit::AU
-            );
-            planet.setOrbitalCharacteristics(periodInDays, orbitalRadiusInAU);
-
-            // Remove from list
-            planetDataList.removeAt(indexFound);
-        }
-        else {
-            errors.append(QString("No orbital data specified for planet %1").arg(planet.getName()));
-        }
-    }
-
-    // Check any unhandled data and warn user
-    for (int i = 0; i < planetDataList.length(); ++i) {
-        errors.append(QString("Orbital data given for unknown planet %1").arg(planetDataList[i].name));
-    }
+    attachOrbitalData(planets, orbits, errors);
 
     // Display errors
     if (!errors.empty()) DialogUtils::showError(errors.join('\n'));
+    reportedErrors.append(errors);
+
+    // Index planets by orbital radius once, for all later transfer planning
+    planets.buildOrbitalRadiusIndex();
+
+    // Precompute when each pair of planets aligns, likewise
+    planets.updateAlignmentCache();
+
+    // Cache positions for the next century; planets get fitted as they are first needed
+    planets.buildEphemerisCache(0, EphemerisCache::DEFAULT_SPAN_IN_DAYS);
 
     // Update table, with orbital data flag
     updatePlanetsTable(planets, true);
 
     // Emit change signal
     emit planetsChanged(planets); // TODO: should we have a different signal for this?
+
+    // Then move the planets by N-body simulation instead, if asked to
+    updateNBodyPositions();
 }
 
-void PlanetsWidget::updatePlanetsTable(QList<Planet> newPlanets, bool haveOrbitalData) {
-    // If no planets, hide table
-    if (newPlanets.empty()) ui->stackedWidget->setCurrentIndex(0);
+void PlanetsWidget::on_watchFilesCheckBox_toggled(bool checked)
+{
+    // Files loaded from now on keep their parsed chunks around for reloading; reloading
+    // files loaded before (or from snapshots) parses them whole the first time
+    if (checked) {
+        planetChunkCache = std::make_shared<CatalogLoader::ChunkCache<PlanetData>>();
+        orbitalDataChunkCache = std::make_shared<CatalogLoader::ChunkCache<PlanetOrbitalData>>();
+    }
     else {
-        planetTableModel->clear(); // Also clears header labels
+        planetChunkCache.reset();
+        orbitalDataChunkCache.reset();
+        reloadTimer.stop();
+    }
+    updateWatchedFiles();
+}
 
-        if (haveOrbitalData) planetTableModel->setHorizontalHeaderLabels({"Name", "Radius", "Mass", "Orbital period", "Orbital radius"});
-        else planetTableModel->setHorizontalHeaderLabels({"Name", "Radius", "Mass"});
+void PlanetsWidget::on_nBodyPositionsCheckBox_toggled(bool checked)
+{
+    updateNBodyPositions();
+}
 
-        planetTableModel->setRowCount(planets.length());
-        for (int i = 0; i < planets.length(); ++i) {
-            const Planet& planet = planets[i];
+void PlanetsWidget::updateNBodyPositions() {
+    // Any recording in progress was of other planets, or is no longer wanted
+    nBodyEngine.cancel();
+    nBodyEphemeris.reset();
+    nBodySimulation.reset();
+    ui->nBodyProgressBar->setVisible(false);
+
+    if (!ui->nBodyPositionsCheckBox->isChecked()) {
+        // Back to the orbital elements
+        if (nullptr != planets.getPositionSource()) {
+            planets.setPositionSource(nullptr);
+            emit planetsChanged(planets);
+        }
+        return;
+    }
 
-            planetTableModel->setData(planetTableModel->index(i, 0), planet.getName());
-            planetTableModel->setData(planetTableModel->index(i, 1), QString("%1 km").arg(planet.getRadiusInMetres() / 1000.0));
-            planetTableModel->setData(planetTableModel->index(i, 2), QString("%1 kg").arg(planet.getMassInKilograms()));
+    // Nothing to simulate without orbits
+    bool haveOrbits = false;
+    for (qsizetype i = 0; i < planets.size() && !haveOrbits; ++i) haveOrbits = planets.hasOrbitalData(i);
+    if (!haveOrbits) return;
+
+    // Simulating can take a while, so it is done in the background, and the
+    // planets only take on their simulated positions once it is done (see constructor)
+    nBodySimulation.emplace(planets);
+    nBodyEphemeris = std::make_shared<NBodyEphemeris>(*nBodySimulation);
+    ui->nBodyProgressBar->setValue(0);
+    ui->nBodyProgressBar->setVisible(true);
+    nBodyEngine.record(*nBodySimulation, *nBodyEphemeris);
+}
 
-            if (haveOrbitalData) {
-                std::optional<double> orbitalPeriod = planet.getOrbitalPeriodInDays();
-                planetTableModel->setData(
-                    planetTableModel->index(i, 3),
-                    orbitalPeriod.has_value() ? QString("%1 days").arg(orbitalPeriod.value()) : "N/A");
+void PlanetsWidget::updateWatchedFiles() {
+    if (!fileWatcher.files().empty()) fileWatcher.removePaths(fileWatcher.files());
+    if (!fileWatcher.directories().empty()) fileWatcher.removePaths(fileWatcher.directories());
+    if (!ui->watchFilesCheckBox->isChecked()) return;
 
-                std::optional<double> orbitalRadius = planet.getOrbitalRadiusInAU();
-                planetTableModel->setData(
-                    planetTableModel->index(i, 4),
-                    orbitalRadius.has_value() ? QString("%1 AU").arg(orbitalRadius.value()) : "N/A");
-            }
-        }
+    for (const QString& fileName : {planetDataFileName, orbitalDataFileName}) {
+        if (fileName.isEmpty()) continue;
+        if (QFileInfo::exists(fileName)) fileWatcher.addPath(fileName);
+        fileWatcher.addPath(QFileInfo(fileName).absolutePath());
+    }
+}
+
+void PlanetsWidget::reloadChangedFiles() {
+    // Pick up files that were replaced (see constructor)
+    updateWatchedFiles();
+
+    // A file being loaded replaces the current planets anyway
+    if (isLoading || planetDataFileName.isEmpty() || !ui->watchFilesCheckBox->isChecked()) return;
+
+    // Load the files again from scratch, only parsing chunks that changed since last time.
+    // If either file cannot be opened (e.g. it is midway through being replaced), wait for the next change
+    QList<PlanetData> planetDataList;
+    QList<QString> errors;
+    if (!CatalogLoader::loadPlanetData(planetDataFileName, planetDataList, errors, planetChunkCache.get())) return;
+
+    SolarSystem reloadedPlanets;
+    std::optional<double> reloadedEarthMass;
+    QList<PlanetData> reloadedPlanetsAwaitingEarth;
+    addLoadedPlanets(reloadedPlanets, planetDataList, reloadedEarthMass, reloadedPlanetsAwaitingEarth);
+    checkLoadedPlanets(reloadedPlanets, reloadedPlanetsAwaitingEarth, errors);
+
+    const bool haveOrbitalData = !orbitalDataFileName.isEmpty();
+    if (haveOrbitalData) {
+        QList<PlanetOrbitalData> orbitalDataList;
+        if (!CatalogLoader::loadOrbitalData(orbitalDataFileName, orbitalDataList, errors, orbitalDataChunkCache.get())) return;
+        attachOrbitalData(reloadedPlanets, resolveOrbitalData(orbitalDataList), errors);
+    }
+
+    // Only touch what changed
+    const PlanetChangeSet changes = planets.merge(reloadedPlanets);
+
+    // Display errors, except those already reported, so that saving a file with
+    // known problems does not bring them all up again
+    const QSet<QString> previousErrors(reportedErrors.cbegin(), reportedErrors.cend());
+    QList<QString> newErrors;
+    for (const QString& error : std::as_const(errors)) {
+        if (!previousErrors.contains(error)) newErrors.append(error);
+    }
+    if (!newErrors.empty()) DialogUtils::showError(newErrors.join('\n'));
+    reportedErrors = std::move(errors);
+
+    if (changes.empty()) return;
+
+    if (haveOrbitalData) {
+        // Only the pairs involving modified planets are realigned, unless planets came or went
+        planets.buildOrbitalRadiusIndex();
+        planets.updateAlignmentCache();
+        planets.buildEphemerisCache(0, EphemerisCache::DEFAULT_SPAN_IN_DAYS);
+    }
+
+    updatePlanetsTableRows(changes);
+    ui->readOrbitalDataButton->setVisible(!planets.empty());
+
+    emit planetsUpdated(planets, changes);
+
+    // N-body positions were of the planets from before, so record them again
+    updateNBodyPositions();
+}
+
+void PlanetsWidget::updatePlanetsTable(const SolarSystem& newPlanets, bool haveOrbitalData) {
+    planetTableModel->clear(); // Also clears header labels
+
+    if (haveOrbitalData) {
+        planetTableModel->setHorizontalHeaderLabels({
+            "Name", "Radius", "Mass", "Orbital period", "Orbital radius",
+            "Eccentricity", "Argument of periapsis", "Epoch"
+        });
+    }
+    else planetTableModel->setHorizontalHeaderLabels({"Name", "Radius", "Mass"});
+
+    appendToPlanetsTable(newPlanets, 0, haveOrbitalData);
+}
+
+void PlanetsWidget::appendToPlanetsTable(const SolarSystem& newPlanets, qsizetype firstIndex, bool haveOrbitalData) {
+    planetTableModel->setRowCount(newPlanets.size());
+    for (qsizetype i = firstIndex; i < newPlanets.size(); ++i) setPlanetsTableRow(newPlanets, i, haveOrbitalData);
+
+    // Show table once there are planets, hide it otherwise
+    ui->stackedWidget->setCurrentIndex(newPlanets.empty() ? 0 : 1);
+}
+
+void PlanetsWidget::updatePlanetsTableRows(const PlanetChangeSet& changes) {
+    // Drop the rows of removed planets, last first so that the other indices still hold
+    for (auto removed = changes.removed.crbegin(); removed != changes.removed.crend(); ++removed) {
+        planetTableModel->removeRow(int(*removed));
+    }
+    planetTableModel->setRowCount(planets.size());
+
+    const bool haveOrbitalData = planetTableModel->columnCount() > 3;
+    for (qsizetype i : changes.modified) setPlanetsTableRow(planets, i, haveOrbitalData);
+    for (qsizetype i : changes.added) setPlanetsTableRow(planets, i, haveOrbitalData);
+
+    // Show table once there are planets, hide it otherwise
+    ui->stackedWidget->setCurrentIndex(planets.empty() ? 0 : 1);
+}
 
-        // Once done, show table
-        ui->stackedWidget->setCurrentIndex(1);
+void PlanetsWidget::setPlanetsTableRow(const SolarSystem& newPlanets, qsizetype i, bool haveOrbitalData) {
+    const Planet planet = newPlanets.at(i);
+
+    planetTableModel->setData(planetTableModel->index(i, 0), planet.getName());
+    planetTableModel->setData(planetTableModel->index(i, 1), QString("%1 km").arg(planet.getRadiusInMetres() / 1000.0));
+    planetTableModel->setData(planetTableModel->index(i, 2), QString("%1 kg").arg(planet.getMassInKilograms()));
+
+    if (haveOrbitalData) {
+        std::optional<double> orbitalPeriod = planet.getOrbitalPeriodInDays();
+        planetTableModel->setData(
+            planetTableModel->index(i, 3),
+            orbitalPeriod.has_value() ? QString("%1 days").arg(orbitalPeriod.value()) : "N/A");
+
+        std::optional<double> orbitalRadius = planet.getOrbitalRadiusInAU();
+        planetTableModel->setData(
+            planetTableModel->index(i, 4),
+            orbitalRadius.has_value() ? QString("%1 AU").arg(orbitalRadius.value()) : "N/A");
+
+        std::optional<double> eccentricity = planet.getEccentricity();
+        planetTableModel->setData(
+            planetTableModel->index(i, 5),
+            eccentricity.has_value() ? QString("%1").arg(eccentricity.value()) : "N/A");
+
+        std::optional<double> argumentOfPeriapsis = planet.getArgumentOfPeriapsisInDegrees();
+        planetTableModel->setData(
+            planetTableModel->index(i, 6),
+            argumentOfPeriapsis.has_value() ? QString("%1°").arg(argumentOfPeriapsis.value()) : "N/A");
+
+        std::optional<double> epoch = planet.getEpochInDays();
+        planetTableModel->setData(
+            planetTableModel->index(i, 7),
+            epoch.has_value() ? QString("%1 days").arg(epoch.value()) : "N/A");
     }
 }
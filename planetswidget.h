@@ -1,10 +1,19 @@
 #ifndef PLANETSWIDGET_H
 #define PLANETSWIDGET_H
 
-#include "planet.h"
+#include "nbodyengine.h"
+#include "nbodyephemeris.h"
+#include "nbodysimulation.h"
+#include "planetloadengine.h"
+#include "solarsystem.h"
 
+#include <QFileSystemWatcher>
 #include <QWidget>
 #include <QStandardItemModel>
+#include <QTimer>
+
+#include <memory>
+#include <optional>
 
 namespace Ui {
 class PlanetsWidget;
@@ -19,18 +28,63 @@ public:
     ~PlanetsWidget();
 
 signals:
-    void planetsChanged(const QList<Planet>& newPlanets);
+    void planetsChanged(const SolarSystem& newPlanets);
+
+    /**
+     * The planets were brought up to date with their files (see
+     * `SolarSystem::merge`), which changed as given.
+     */
+    void planetsUpdated(const SolarSystem& newPlanets, const PlanetChangeSet& changes);
 
 private slots:
     void on_readPlanetsButton_clicked();
     void on_readOrbitalDataButton_clicked();
+    void on_cancelLoadingButton_clicked();
+    void on_watchFilesCheckBox_toggled(bool checked);
+    void on_nBodyPositionsCheckBox_toggled(bool checked);
+
+    void addPlanetBatch(const QList<CatalogParser::PlanetData>& planetDataList, const QList<QString>& errors);
+    void showLoadingProgress(qsizetype chunksLoaded, qsizetype chunkCount);
 
 private:
     Ui::PlanetsWidget *ui;
-    QList<Planet> planets;
+    SolarSystem planets;
     QStandardItemModel* planetTableModel;
 
-    void updatePlanetsTable(QList<Planet> newPlanets, bool haveOrbitalData = false);
+    // State of the planet data file being loaded in the background, if any
+    PlanetLoadEngine loadEngine;
+    bool isLoading = false;
+    QString loadingFileName;
+    SolarSystem loadingPlanets; // Only replaces `planets` once loading is done (or cancelled)
+    QList<QString> loadingErrors;
+    std::optional<double> earthMass;
+    QList<CatalogParser::PlanetData> planetsAwaitingEarth; // Stated in Earth masses, before Earth itself was loaded
+
+    // Files the current planets come from, reloaded when they change if asked to
+    QString planetDataFileName;
+    QString orbitalDataFileName; // Empty if no orbital data was loaded for them
+    QFileSystemWatcher fileWatcher;
+    QTimer reloadTimer; // Waits for files to settle, as saving often takes several writes
+    QList<QString> reportedErrors; // Problems with the files already shown, not shown again on reload
+    // Only kept while watching files, so that reloading only parses what changed
+    std::shared_ptr<CatalogLoader::ChunkCache<CatalogParser::PlanetData>> planetChunkCache;
+    std::shared_ptr<CatalogLoader::ChunkCache<CatalogParser::PlanetOrbitalData>> orbitalDataChunkCache;
+
+    // N-body positions being recorded for the current planets, if asked for (see `NBodyEphemeris`);
+    // they only become the planets' position source once recorded in full
+    std::optional<NBodySimulation> nBodySimulation;
+    std::shared_ptr<NBodyEphemeris> nBodyEphemeris;
+    NBodyEngine nBodyEngine; // Declared after the simulation and ephemeris, so that it stops using them before they go
+
+    void finishLoadingPlanets(bool cancelled);
+    void adoptLoadedPlanets();
+    void updateWatchedFiles();
+    void reloadChangedFiles();
+    void updateNBodyPositions();
+    void updatePlanetsTable(const SolarSystem& newPlanets, bool haveOrbitalData = false);
+    void appendToPlanetsTable(const SolarSystem& newPlanets, qsizetype firstIndex, bool haveOrbitalData = false);
+    void updatePlanetsTableRows(const PlanetChangeSet& changes);
+    void setPlanetsTableRow(const SolarSystem& newPlanets, qsizetype index, bool haveOrbitalData);
 };
 
 #endif // PLANETSWIDGET_H
@@ -0,0 +1,87 @@
+#include "porkchopengine.h"
+
+#include <QtConcurrent>
+
+#include <memory>
+
+PorkchopEngine::PorkchopEngine(QObject *parent)
+    : QObject(parent)
+{
+    connect(&watcher, &QFutureWatcher<OrbitalMath::PorkchopTile>::resultReadyAt, this, [this](int index) {
+        emit tileFinished(watcher.resultAt(index));
+    });
+    connect(&watcher, &QFutureWatcher<OrbitalMath::PorkchopTile>::finished, this, [this]() {
+        if (!watcher.isCanceled()) emit finished();
+    });
+}
+
+PorkchopEngine::~PorkchopEngine()
+{
+    cancel();
+}
+
+namespace {
+    /**
+     * Everything the worker threads need, owned by the computation itself
+     * so that the caller's planets and rocket can change in the meantime.
+     */
+    struct PorkchopJob {
+        SolarSystem planets; // Copies of the start (index 0) and destination (index 1) planets
+        Rocket rocket;
+        OrbitalMath::PorkchopGridSpec spec;
+    };
+
+    void copyPlanet(const Planet& planet, SolarSystem& planets) {
+        const qsizetype index = planets.addPlanet(planet.getName(), planet.getMassInKilograms(), planet.getRadiusInMetres());
+        if (planet.hasOrbitalData()) {
+            planets.setOrbitalCharacteristics(
+                index,
+                planet.getOrbitalPeriodInDays().value(),
+                planet.getOrbitalRadiusInAU().value(),
+                planet.getEccentricity().value(),
+                planet.getArgumentOfPeriapsisInDegrees().value(),
+                planet.getEpochInDays().value()
+                );
+        }
+    }
+}
+
+qsizetype PorkchopEngine::start(const Planet& from, const Planet& to, const Rocket& rocket, const OrbitalMath::PorkchopGridSpec& spec) {
+    cancel();
+
+    auto job = std::make_shared<PorkchopJob>(PorkchopJob { SolarSystem(), rocket, spec });
+    copyPlanet(from, job->planets);
+    copyPlanet(to, job->planets);
+
+    // Split the grid into tiles; each one only needs its bounds filled in
+    QList<OrbitalMath::PorkchopTile> tiles;
+    for (qsizetype departure = 0; departure < spec.departureCount; departure += TILE_SIZE) {
+        for (qsizetype flightTime = 0; flightTime < spec.flightTimeCount; flightTime += TILE_SIZE) {
+            OrbitalMath::PorkchopTile tile;
+            tile.firstDeparture = departure;
+            tile.departureCount = std::min(TILE_SIZE, spec.departureCount - departure);
+            tile.firstFlightTime = flightTime;
+            tile.flightTimeCount = std::min(TILE_SIZE, spec.flightTimeCount - flightTime);
+            tiles.append(tile);
+        }
+    }
+    const qsizetype tileCount = tiles.size();
+
+    watcher.setFuture(QtConcurrent::mapped(std::move(tiles), [job](const OrbitalMath::PorkchopTile& bounds) {
+        return OrbitalMath::porkchopTile(
+            job->planets.at(0), job->planets.at(1), job->rocket, job->spec,
+            bounds.firstDeparture, bounds.departureCount, bounds.firstFlightTime, bounds.flightTimeCount
+            );
+    }));
+
+    return tileCount;
+}
+
+void PorkchopEngine::cancel() {
+    watcher.cancel();
+    watcher.waitForFinished();
+}
+
+bool PorkchopEngine::isRunning() const {
+    return watcher.isRunning();
+}
@@ -0,0 +1,54 @@
+#ifndef PORKCHOPENGINE_H
+#define PORKCHOPENGINE_H
+
+#include "orbitalmath.h"
+
+#include <QFutureWatcher>
+#include <QObject>
+
+/**
+ * Computes porkchop plots (see `OrbitalMath::porkchopTile`) in the
+ * background: the grid is split into tiles computed on the global
+ * thread pool, and each tile is handed back (on the engine's thread)
+ * as soon as it is done, so that the plot can be drawn progressively.
+ */
+class PorkchopEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    /**
+     * Size (in departures and in flight times) of the tiles.
+     */
+    static constexpr qsizetype TILE_SIZE = 128;
+
+    explicit PorkchopEngine(QObject *parent = nullptr);
+    ~PorkchopEngine();
+
+    /**
+     * Starts computing the porkchop plot for a transfer between the given
+     * planets, cancelling any computation still in progress. The planets
+     * and rocket are copied, so they don't need to outlive the computation.
+     *
+     * Returns the number of tiles that will be computed.
+     */
+    qsizetype start(const Planet& from, const Planet& to, const Rocket& rocket, const OrbitalMath::PorkchopGridSpec& spec);
+
+    /**
+     * Cancels the computation in progress (if any) and waits for
+     * tiles already being computed to be done. No signals are emitted
+     * for a cancelled computation.
+     */
+    void cancel();
+
+    bool isRunning() const;
+
+signals:
+    void tileFinished(const OrbitalMath::PorkchopTile& tile);
+    void finished();
+
+private:
+    QFutureWatcher<OrbitalMath::PorkchopTile> watcher;
+};
+
+#endif // PORKCHOPENGINE_H
@@ -0,0 +1,287 @@
+#include "porkchopsolutionwidget.h"
+#include "ui_porkchopsolutionwidget.h"
+
+#include "dialogutils.h"
+#include "measurementunits.h"
+
+#include <QColor>
+#include <QPixmap>
+
+#include <algorithm>
+#include <array>
+
+PorkchopSolutionWidget::PorkchopSolutionWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::PorkchopSolutionWidget)
+{
+    ui->setupUi(this);
+    captionTemplate = ui->heatmapCaptionLabel->text(); // Store template so we can put it back if needed
+
+    connect(&engine, &PorkchopEngine::tileFinished, this, &PorkchopSolutionWidget::drawTile);
+    connect(&engine, &PorkchopEngine::finished, this, &PorkchopSolutionWidget::refreshHeatmap);
+
+    heatmapRefreshTimer.setInterval(50);
+    connect(&heatmapRefreshTimer, &QTimer::timeout, this, &PorkchopSolutionWidget::refreshHeatmap);
+}
+
+PorkchopSolutionWidget::~PorkchopSolutionWidget()
+{
+    engine.cancel();
+    delete ui;
+}
+
+namespace {
+    const auto NO_PLANETS_SELECTED("No origin/destination planets selected.\nPlease select target planets to continue.");
+    const auto NO_ORBITAL_DATA("No orbital data loaded for %1.\nPlease load orbital data from the side panel to continue.");
+    const auto NO_ROCKET_DATA("No rocket data loaded.\nPlease load rocket data from the side panel to continue.");
+    const auto SAME_PLANET("Same planet selected as both origin and destination.\nPlease select two different planets to continue.");
+    const auto INVALID_PLANET("Invalid planet selected: %1.\nPlease select a valid planet from the options list to continue.");
+    const auto INVALID_TIMEFRAME("Departure window ends before it starts.\nPlease select a valid departure window to continue.");
+
+    // Colour scale: blue (low) to red (high), precomputed so drawing a tile doesn't go through QColor
+    const std::array<QRgb, 256> HEATMAP_PALETTE = []() {
+        std::array<QRgb, 256> palette;
+        for (int i = 0; i < 256; ++i) palette[i] = QColor::fromHsvF((255 - i) / 255.0 * 2 / 3, 1, 1).rgb();
+        return palette;
+    }();
+    const QRgb HEATMAP_PENDING = qRgb(211, 211, 211); // lightgrey, for cells not computed yet
+
+    enum ColourBy {
+        TRAVEL_TIME = 0,
+        DISTANCE = 1
+    };
+}
+
+void PorkchopSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
+    // The engine works on its own copies, but stop it anyway since the plot is outdated
+    engine.cancel();
+    planets = &newPlanets;
+
+    updateDisplayedPage();
+    updatePlanetSelectOptions();
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::setRocket(const Rocket* newRocket) {
+    engine.cancel();
+    rocket = newRocket;
+
+    updateDisplayedPage();
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::updateDisplayedPage() {
+    if (nullptr != rocket && nullptr != planets && !planets->empty()) {
+        // Show main processing section
+        ui->stackedWidget->setCurrentIndex(1);
+    }
+    else ui->stackedWidget->setCurrentIndex(0);
+}
+
+void PorkchopSolutionWidget::updatePlanetSelectOptions() {
+    // Try to keep current options if possible
+    const QString oldFromPlanet = ui->fromPlanetSelect->currentText();
+    const QString oldToPlanet = ui->toPlanetSelect->currentText();
+
+    // Clear options and load with new planets
+    // (Block signals meanwhile, so that we don't start a computation for every intermediate selection)
+    const QSignalBlocker fromBlocker(ui->fromPlanetSelect);
+    const QSignalBlocker toBlocker(ui->toPlanetSelect);
+    ui->fromPlanetSelect->clear();
+    ui->toPlanetSelect->clear();
+    ui->fromPlanetSelect->addItems(planets->names());
+    ui->toPlanetSelect->addItems(planets->names());
+
+    // Try to reinstate old options
+    // If not found, Qt will just ignore us since the QComboBox is not editable
+    ui->fromPlanetSelect->setCurrentText(oldFromPlanet);
+    ui->toPlanetSelect->setCurrentText(oldToPlanet);
+}
+
+void PorkchopSolutionWidget::updatePlot() {
+    engine.cancel();
+    heatmapRefreshTimer.stop();
+
+    // Get selected planet names and grid
+    const QString fromPlanetName = ui->fromPlanetSelect->currentText();
+    const QString toPlanetName = ui->toPlanetSelect->currentText();
+    const double departureStart = ui->departureStartSpinBox->value();
+    const double departureEnd = ui->departureEndSpinBox->value();
+    const double maximumFlightTime = ui->maximumFlightTimeSpinBox->value();
+    const int resolution = ui->resolutionSpinBox->value();
+
+    // First, check whether we can compute at all and warn user if not.
+    ui->resultsStackedWidget->setCurrentIndex(0); // Assume error, put back once we're sure all is good
+
+    if (nullptr == planets || fromPlanetName.isEmpty() || toPlanetName.isEmpty()) {
+        ui->resultsIssueLabel->setText(NO_PLANETS_SELECTED);
+        return;
+    }
+    if (fromPlanetName == toPlanetName) {
+        ui->resultsIssueLabel->setText(SAME_PLANET);
+        return;
+    }
+    if (nullptr == rocket) {
+        ui->resultsIssueLabel->setText(NO_ROCKET_DATA); // Should never be visible, but just in case
+        return;
+    }
+    if (departureEnd < departureStart) {
+        ui->resultsIssueLabel->setText(INVALID_TIMEFRAME);
+        return;
+    }
+
+    // Get selected planets
+    const std::optional<qsizetype> fromPlanetIndex = planets->indexOf(fromPlanetName);
+    const std::optional<qsizetype> toPlanetIndex = planets->indexOf(toPlanetName);
+
+    // Continue checks and warn user of issues
+    if (!fromPlanetIndex.has_value() || !toPlanetIndex.has_value()) {
+        // This should be impossible given how we populate the QComboBox
+        // But we'll check, just in case
+        QStringList invalidPlanets;
+        if (!fromPlanetIndex.has_value()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanetIndex.has_value()) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(INVALID_PLANET).arg(invalidPlanetNames));
+
+        return;
+    }
+    const Planet fromPlanet = planets->at(fromPlanetIndex.value());
+    const Planet toPlanet = planets->at(toPlanetIndex.value());
+    if (!fromPlanet.hasOrbitalData() || !toPlanet.hasOrbitalData()) {
+        QStringList invalidPlanets;
+        if (!fromPlanet.hasOrbitalData()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanet.hasOrbitalData()) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(NO_ORBITAL_DATA).arg(invalidPlanetNames));
+
+        return;
+    }
+
+    // If we got here, all is well and we can display the results page
+    ui->resultsStackedWidget->setCurrentIndex(1);
+
+    // Square grid, departures spanning the departure window and flight times from 0 to the maximum
+    OrbitalMath::PorkchopGridSpec spec;
+    spec.departureCount = resolution;
+    spec.firstDepartureDay = TimeUnit::convert(departureStart, TimeUnit::YEARS, TimeUnit::DAYS);
+    spec.departureStepInDays = TimeUnit::convert(departureEnd - departureStart, TimeUnit::YEARS, TimeUnit::DAYS) / (resolution - 1);
+    spec.flightTimeCount = resolution;
+    spec.firstFlightTimeInDays = 0;
+    spec.flightTimeStepInDays = TimeUnit::convert(maximumFlightTime, TimeUnit::YEARS, TimeUnit::DAYS) / (resolution - 1);
+
+    // Fix the colour scale up front, so that tiles can be drawn as they come:
+    // distances can only range between the planets being aligned and being in opposition,
+    // with each planet anywhere between its periapsis and apoapsis
+    const double fromOrbitalRadius = DistanceUnit::convert(fromPlanet.getOrbitalRadiusInAU().value(), DistanceUnit::AU, DistanceUnit::METRES);
+    const double toOrbitalRadius = DistanceUnit::convert(toPlanet.getOrbitalRadiusInAU().value(), DistanceUnit::AU, DistanceUnit::METRES);
+    const double fromPeriapsis = fromOrbitalRadius * (1 - fromPlanet.getEccentricity().value());
+    const double fromApoapsis = fromOrbitalRadius * (1 + fromPlanet.getEccentricity().value());
+    const double toPeriapsis = toOrbitalRadius * (1 - toPlanet.getEccentricity().value());
+    const double toApoapsis = toOrbitalRadius * (1 + toPlanet.getEccentricity().value());
+    const double planetRadii = fromPlanet.getRadiusInMetres() + toPlanet.getRadiusInMetres();
+    const double shortestDistance = std::max({ toPeriapsis - fromApoapsis, fromPeriapsis - toApoapsis, 0.0 }) - planetRadii;
+    const double longestDistance = toApoapsis + fromApoapsis - planetRadii;
+
+    QString minimumText, maximumText;
+    if (DISTANCE == ui->colourBySelect->currentIndex()) {
+        colourScaleMinimum = shortestDistance;
+        colourScaleMaximum = longestDistance;
+        minimumText = QString("%1 m").arg(colourScaleMinimum);
+        maximumText = QString("%1 m").arg(colourScaleMaximum);
+    }
+    else {
+        colourScaleMinimum = OrbitalMath::computeTransfer(fromPlanet, toPlanet, *rocket, Metres(shortestDistance)).totalTravelTime.value();
+        colourScaleMaximum = OrbitalMath::computeTransfer(fromPlanet, toPlanet, *rocket, Metres(longestDistance)).totalTravelTime.value();
+        minimumText = DialogUtils::formatTime(colourScaleMinimum);
+        maximumText = DialogUtils::formatTime(colourScaleMaximum);
+    }
+
+    QString newCaptionText = captionTemplate; // Make a copy
+    newCaptionText
+        .replace("{fromPlanet}", fromPlanetName)
+        .replace("{toPlanet}", toPlanetName)
+        .replace("{departureStart}", QString::number(departureStart))
+        .replace("{departureEnd}", QString::number(departureEnd))
+        .replace("{maximumFlightTime}", QString::number(maximumFlightTime))
+        .replace("{colourBy}", ui->colourBySelect->currentText().toLower())
+        .replace("{minimum}", minimumText)
+        .replace("{maximum}", maximumText);
+    ui->heatmapCaptionLabel->setText(newCaptionText);
+
+    // Start from a blank plot, then let the engine fill it in
+    heatmap = QImage(resolution, resolution, QImage::Format_RGB32);
+    heatmap.fill(HEATMAP_PENDING);
+    heatmapDirty = true;
+    tilesDone = 0;
+    tilesExpected = engine.start(fromPlanet, toPlanet, *rocket, spec);
+
+    refreshHeatmap();
+    heatmapRefreshTimer.start();
+}
+
+void PorkchopSolutionWidget::drawTile(const OrbitalMath::PorkchopTile& tile) {
+    const AlignedVector<double>& values = DISTANCE == ui->colourBySelect->currentIndex() ? tile.distances : tile.travelTimes;
+    const double scale = colourScaleMaximum > colourScaleMinimum ? 255 / (colourScaleMaximum - colourScaleMinimum) : 0;
+
+    for (qsizetype j = 0; j < tile.flightTimeCount; ++j) {
+        // Longest flight times at the top
+        QRgb* line = reinterpret_cast<QRgb*>(heatmap.scanLine(heatmap.height() - 1 - (tile.firstFlightTime + j)));
+        for (qsizetype i = 0; i < tile.departureCount; ++i) {
+            const double value = values[i * tile.flightTimeCount + j];
+            const int colourIndex = std::clamp(int((value - colourScaleMinimum) * scale), 0, 255);
+            line[tile.firstDeparture + i] = HEATMAP_PALETTE[colourIndex];
+        }
+    }
+
+    ++tilesDone;
+    heatmapDirty = true;
+}
+
+void PorkchopSolutionWidget::refreshHeatmap() {
+    if (heatmapDirty) {
+        ui->heatmapLabel->setPixmap(QPixmap::fromImage(heatmap));
+        heatmapDirty = false;
+    }
+    ui->progressLabel->setText(QString("%1 / %2 tiles computed").arg(tilesDone).arg(tilesExpected));
+
+    if (tilesDone == tilesExpected) heatmapRefreshTimer.stop();
+}
+
+void PorkchopSolutionWidget::on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName)
+{
+    // No need to do anything with the name, since updatePlot() reads it anyway
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName)
+{
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::on_departureStartSpinBox_valueChanged(double newDepartureStart)
+{
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::on_departureEndSpinBox_valueChanged(double newDepartureEnd)
+{
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::on_maximumFlightTimeSpinBox_valueChanged(double newMaximumFlightTime)
+{
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::on_resolutionSpinBox_valueChanged(int newResolution)
+{
+    updatePlot();
+}
+
+void PorkchopSolutionWidget::on_colourBySelect_currentIndexChanged(int newColourBy)
+{
+    updatePlot();
+}
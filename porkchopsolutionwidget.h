@@ -0,0 +1,60 @@
+#ifndef PORKCHOPSOLUTIONWIDGET_H
+#define PORKCHOPSOLUTIONWIDGET_H
+
+#include <QImage>
+#include <QTimer>
+#include <QWidget>
+
+#include "porkchopengine.h"
+#include "solarsystem.h"
+#include "rocket.h"
+
+namespace Ui {
+class PorkchopSolutionWidget;
+}
+
+class PorkchopSolutionWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PorkchopSolutionWidget(QWidget *parent = nullptr);
+    ~PorkchopSolutionWidget();
+
+public slots:
+    void setPlanets(const SolarSystem& newPlanets);
+    void setRocket(const Rocket* newRocket);
+
+private slots:
+    void on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName);
+    void on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName);
+    void on_departureStartSpinBox_valueChanged(double newDepartureStart);
+    void on_departureEndSpinBox_valueChanged(double newDepartureEnd);
+    void on_maximumFlightTimeSpinBox_valueChanged(double newMaximumFlightTime);
+    void on_resolutionSpinBox_valueChanged(int newResolution);
+    void on_colourBySelect_currentIndexChanged(int newColourBy);
+
+    void drawTile(const OrbitalMath::PorkchopTile& tile);
+    void refreshHeatmap();
+
+private:
+    Ui::PorkchopSolutionWidget *ui;
+    const SolarSystem* planets = nullptr;
+    const Rocket* rocket = nullptr;
+    QString captionTemplate;
+
+    PorkchopEngine engine;
+    QImage heatmap; // One pixel per grid cell, departures left to right, flight times bottom to top
+    QTimer heatmapRefreshTimer; // Redraws the heatmap at most once per tick while tiles come in
+    bool heatmapDirty = false;
+    qsizetype tilesExpected = 0;
+    qsizetype tilesDone = 0;
+    double colourScaleMinimum = 0;
+    double colourScaleMaximum = 0;
+
+    void updateDisplayedPage();
+    void updatePlanetSelectOptions();
+    void updatePlot();
+};
+
+#endif // PORKCHOPSOLUTIONWIDGET_H
@@ -0,0 +1,13 @@
+#include "positionsource.h"
+#include "measurementunits.h"
+
+#include <cmath>
+
+std::optional<double> PositionSource::angularPosition(qsizetype planetIndex, Days day) const {
+    const std::optional<std::pair<double, double>> coordinates = position(planetIndex, day);
+    if (!coordinates.has_value()) return std::nullopt;
+
+    const auto [x, y] = coordinates.value();
+    const double angle = AngleUnit::convert(std::atan2(y, x), AngleUnit::RADIANS, AngleUnit::DEGREES);
+    return angle < 0 ? angle + 360.0 : angle;
+}
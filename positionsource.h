@@ -0,0 +1,49 @@
+#ifndef POSITIONSOURCE_H
+#define POSITIONSOURCE_H
+
+#include "quantity.h"
+
+#include <QtGlobal>
+
+#include <optional>
+#include <utility>
+
+/**
+ * Where the planets of a solar system are at any given day, as an
+ * alternative to the Keplerian (two-body) model of their orbital elements
+ * (e.g. from an N-body simulation, see `NBodyEphemeris`).
+ *
+ * A solar system with a position source (see `SolarSystem::setPositionSource`)
+ * has `OrbitalMath` take positions from it wherever they are computed from the
+ * orbital elements, so that every stage follows it. Planets and days a source
+ * does not cover are left to the Keplerian model, and a solar system without
+ * one uses the Keplerian model throughout.
+ *
+ * Sources are read from any number of threads at once, and so must not
+ * change once given to a solar system.
+ */
+class PositionSource
+{
+public:
+    virtual ~PositionSource() = default;
+
+    /**
+     * Whether the source knows where the planet (by index in the solar
+     * system) is on all days from `firstDay` to `lastDay`.
+     */
+    virtual bool covers(qsizetype planetIndex, Days firstDay, Days lastDay) const = 0;
+
+    /**
+     * Cartesian coordinates (in AU, see `OrbitalMath::polarToCartesianCoordinates`)
+     * of the planet at the given day. Nothing if not covered.
+     */
+    virtual std::optional<std::pair<double, double>> position(qsizetype planetIndex, Days day) const = 0;
+
+    /**
+     * Angular position (in degrees, in [0°, 360°)) of the planet at the given
+     * day, i.e. the direction of `position`. Nothing if not covered.
+     */
+    std::optional<double> angularPosition(qsizetype planetIndex, Days day) const;
+};
+
+#endif // POSITIONSOURCE_H
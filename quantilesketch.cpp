@@ -0,0 +1,133 @@
+#include "quantilesketch.h"
+
+#include <algorithm>
+#include <cmath>
+
+QuantileSketch::QuantileSketch(double relativeAccuracy)
+    : relativeAccuracy(relativeAccuracy)
+    , logGamma(std::log((1 + relativeAccuracy) / (1 - relativeAccuracy)))
+{}
+
+void QuantileSketch::Store::add(qint64 bucket, qint64 count) {
+    if (counts.empty()) {
+        firstBucket = bucket;
+        counts.push_back(count);
+        return;
+    }
+
+    // Grow the range of buckets to include this one
+    if (bucket < firstBucket) {
+        counts.insert(counts.begin(), firstBucket - bucket, 0);
+        firstBucket = bucket;
+    }
+    else if (bucket >= firstBucket + qint64(counts.size())) {
+        counts.resize(bucket - firstBucket + 1, 0);
+    }
+
+    counts[bucket - firstBucket] += count;
+}
+
+qint64 QuantileSketch::bucketOf(double absoluteValue) const {
+    // Bucket i holds the values in (γ^(i-1), γ^i]; values beyond the range go to its ends
+    const double clampedValue = std::clamp(absoluteValue, MINIMUM_MAGNITUDE, MAXIMUM_MAGNITUDE);
+    return qint64(std::ceil(std::log(clampedValue) / logGamma));
+}
+
+double QuantileSketch::bucketValue(qint64 bucket) const {
+    // The point of the bucket within the relative accuracy of both its bounds
+    const double gamma = std::exp(logGamma);
+    return 2 * std::exp(bucket * logGamma) / (gamma + 1);
+}
+
+void QuantileSketch::add(double value) {
+    if (std::isnan(value)) return;
+
+    if (std::isinf(value)) ++(value > 0 ? positiveInfinityCount : negativeInfinityCount);
+    else if (value > 0) positiveValues.add(bucketOf(value), 1);
+    else if (value < 0) negativeValues.add(bucketOf(-value), 1);
+    else ++zeroCount;
+
+    if (0 == valueCount) {
+        minimumValue = value;
+        maximumValue = value;
+    }
+    else {
+        minimumValue = std::min(minimumValue, value);
+        maximumValue = std::max(maximumValue, value);
+    }
+    ++valueCount;
+    sum += value;
+}
+
+void QuantileSketch::merge(const QuantileSketch& other) {
+    if (0 == other.valueCount) return;
+
+    for (std::size_t i = 0; i < other.positiveValues.counts.size(); ++i) {
+        if (other.positiveValues.counts[i]) positiveValues.add(other.positiveValues.firstBucket + qint64(i), other.positiveValues.counts[i]);
+    }
+    for (std::size_t i = 0; i < other.negativeValues.counts.size(); ++i) {
+        if (other.negativeValues.counts[i]) negativeValues.add(other.negativeValues.firstBucket + qint64(i), other.negativeValues.counts[i]);
+    }
+    zeroCount += other.zeroCount;
+    negativeInfinityCount += other.negativeInfinityCount;
+    positiveInfinityCount += other.positiveInfinityCount;
+
+    if (0 == valueCount) {
+        minimumValue = other.minimumValue;
+        maximumValue = other.maximumValue;
+    }
+    else {
+        minimumValue = std::min(minimumValue, other.minimumValue);
+        maximumValue = std::max(maximumValue, other.maximumValue);
+    }
+    valueCount += other.valueCount;
+    sum += other.sum;
+}
+
+double QuantileSketch::quantile(double q) const {
+    if (0 == valueCount) return NAN;
+    if (q <= 0) return minimumValue;
+    if (q >= 1) return maximumValue;
+
+    // Walk the buckets in increasing order of value until reaching the rank
+    const double rank = q * (valueCount - 1);
+    qint64 seen = negativeInfinityCount;
+    if (seen > rank) return -INFINITY;
+
+    // Negative values first, largest absolute value first
+    for (qsizetype i = qsizetype(negativeValues.counts.size()) - 1; i >= 0; --i) {
+        seen += negativeValues.counts[i];
+        if (seen > rank) return std::clamp(-bucketValue(negativeValues.firstBucket + i), minimumValue, maximumValue);
+    }
+
+    seen += zeroCount;
+    if (seen > rank) return 0;
+
+    for (std::size_t i = 0; i < positiveValues.counts.size(); ++i) {
+        seen += positiveValues.counts[i];
+        if (seen > rank) return std::clamp(bucketValue(positiveValues.firstBucket + qint64(i)), minimumValue, maximumValue);
+    }
+
+    // Only positive infinities left (or the rank was rounded past the end)
+    return maximumValue;
+}
+
+qint64 QuantileSketch::count() const {
+    return valueCount;
+}
+
+double QuantileSketch::mean() const {
+    return 0 == valueCount ? NAN : sum / valueCount;
+}
+
+double QuantileSketch::minimum() const {
+    return 0 == valueCount ? NAN : minimumValue;
+}
+
+double QuantileSketch::maximum() const {
+    return 0 == valueCount ? NAN : maximumValue;
+}
+
+double QuantileSketch::getRelativeAccuracy() const {
+    return relativeAccuracy;
+}
@@ -0,0 +1,96 @@
+#ifndef QUANTILESKETCH_H
+#define QUANTILESKETCH_H
+
+#include <QtGlobal>
+
+#include <vector>
+
+/**
+ * Streaming summary of a distribution of values, answering quantile
+ * queries (e.g. the median, or the 95th percentile) to within a relative
+ * accuracy without storing the values themselves.
+ *
+ * Values are counted in buckets whose bounds grow geometrically (each
+ * bucket spans values within `relativeAccuracy` of its midpoint), one set
+ * for positive values and one for negative ones; memory thus grows with
+ * the logarithm of the range of values seen, not with their number.
+ * Magnitudes outside [`MINIMUM_MAGNITUDE`, `MAXIMUM_MAGNITUDE`] share the
+ * bucket at that end of the range (so that a stray huge or tiny value does
+ * not grow the buckets without bound), and infinities are counted apart.
+ *
+ * Sketches with the same accuracy can be merged. Merging only adds bucket
+ * counts, so quantiles come out the same whatever the order in which
+ * values were added and sketches merged. The sum (for the mean), though,
+ * is a floating-point sum and depends on that order.
+ */
+class QuantileSketch
+{
+public:
+    /**
+     * Default relative accuracy of quantiles (0.1%).
+     */
+    static constexpr double DEFAULT_RELATIVE_ACCURACY = 1e-3;
+
+    /**
+     * Range of magnitudes over which quantiles keep their relative accuracy.
+     */
+    static constexpr double MINIMUM_MAGNITUDE = 1e-9;
+    static constexpr double MAXIMUM_MAGNITUDE = 1e21;
+
+    explicit QuantileSketch(double relativeAccuracy = DEFAULT_RELATIVE_ACCURACY);
+
+    /**
+     * Adds a value. NaNs are ignored; infinities are kept as such.
+     */
+    void add(double value);
+
+    /**
+     * Adds all values counted by the other sketch, which must have
+     * the same relative accuracy.
+     */
+    void merge(const QuantileSketch& other);
+
+    /**
+     * Value at the given quantile (from 0 for the minimum to 1 for the
+     * maximum), within the relative accuracy of the actual value at that
+     * rank. NaN if no values were added.
+     */
+    double quantile(double q) const;
+
+    qint64 count() const;
+    double mean() const;
+    double minimum() const;
+    double maximum() const;
+    double getRelativeAccuracy() const;
+
+private:
+    /**
+     * Counts of the buckets between `firstBucket` and
+     * `firstBucket + counts.size()`, grown as needed.
+     */
+    struct Store {
+        qint64 firstBucket = 0;
+        std::vector<qint64> counts;
+
+        void add(qint64 bucket, qint64 count);
+    };
+
+    double relativeAccuracy;
+    double logGamma; // Log of the ratio between consecutive bucket bounds
+
+    Store positiveValues;
+    Store negativeValues; // By absolute value
+    qint64 zeroCount = 0;
+    qint64 negativeInfinityCount = 0;
+    qint64 positiveInfinityCount = 0;
+
+    qint64 valueCount = 0;
+    double sum = 0;
+    double minimumValue = 0;
+    double maximumValue = 0;
+
+    qint64 bucketOf(double absoluteValue) const;
+    double bucketValue(qint64 bucket) const;
+};
+
+#endif // QUANTILESKETCH_H
@@ -0,0 +1,112 @@
+#ifndef QUANTITY_H
+#define QUANTITY_H
+
+#include <compare>
+#include <ratio>
+
+/**
+ * Physical dimension of a quantity, as the exponents of length, mass,
+ * time and angle (e.g. `Dimension<1, 0, -1, 0>` for speeds).
+ */
+template <int Length, int Mass, int Time, int Angle>
+struct Dimension {};
+
+template <class FirstDimension, class SecondDimension>
+struct DimensionProduct;
+
+template <int L1, int M1, int T1, int A1, int L2, int M2, int T2, int A2>
+struct DimensionProduct<Dimension<L1, M1, T1, A1>, Dimension<L2, M2, T2, A2>> {
+    using type = Dimension<L1 + L2, M1 + M2, T1 + T2, A1 + A2>;
+};
+
+template <class FirstDimension, class SecondDimension>
+struct DimensionQuotient;
+
+template <int L1, int M1, int T1, int A1, int L2, int M2, int T2, int A2>
+struct DimensionQuotient<Dimension<L1, M1, T1, A1>, Dimension<L2, M2, T2, A2>> {
+    using type = Dimension<L1 - L2, M1 - M2, T1 - T2, A1 - A2>;
+};
+
+/**
+ * A value with its dimension and unit as part of its type, stored as a
+ * single double (so it costs nothing over a bare double). `Scale` is the
+ * unit's ratio to the SI unit (to degrees for angles), like the ratios of
+ * `UnitType`, so `Quantity<Time, std::ratio<86400>>` counts days.
+ *
+ * Quantities of the same dimension convert implicitly to one another, by
+ * a constant worked out at compile time; quantities of different
+ * dimensions do not convert at all, and bare doubles only convert
+ * explicitly (through the constructor), so mixing up units is a compile
+ * error rather than a wrong result.
+ */
+template <class Dim, class Scale = std::ratio<1>>
+class Quantity {
+    double _value;
+
+public:
+    using dimension = Dim;
+    using scale = Scale;
+
+    constexpr Quantity(): _value(0) {}
+    constexpr explicit Quantity(double value): _value(value) {}
+
+    template <class OtherScale>
+    constexpr Quantity(Quantity<Dim, OtherScale> other):
+        _value(other.value() * (double(std::ratio_divide<OtherScale, Scale>::num) / double(std::ratio_divide<OtherScale, Scale>::den)))
+    {}
+
+    /**
+     * The value, in the quantity's unit.
+     */
+    constexpr double value() const { return _value; }
+
+    constexpr Quantity operator+(Quantity other) const { return Quantity(_value + other._value); }
+    constexpr Quantity operator-(Quantity other) const { return Quantity(_value - other._value); }
+    constexpr Quantity operator-() const { return Quantity(-_value); }
+    constexpr Quantity operator*(double factor) const { return Quantity(_value * factor); }
+    constexpr Quantity operator/(double divisor) const { return Quantity(_value / divisor); }
+    constexpr Quantity& operator+=(Quantity other) { _value += other._value; return *this; }
+    constexpr Quantity& operator-=(Quantity other) { _value -= other._value; return *this; }
+
+    friend constexpr Quantity operator*(double factor, Quantity quantity) { return quantity * factor; }
+
+    constexpr bool operator==(const Quantity& other) const = default;
+    constexpr auto operator<=>(const Quantity& other) const = default;
+};
+
+template <class D1, class S1, class D2, class S2>
+constexpr Quantity<typename DimensionProduct<D1, D2>::type, std::ratio_multiply<S1, S2>>
+operator*(Quantity<D1, S1> first, Quantity<D2, S2> second) {
+    return Quantity<typename DimensionProduct<D1, D2>::type, std::ratio_multiply<S1, S2>>(first.value() * second.value());
+}
+
+template <class D1, class S1, class D2, class S2>
+constexpr Quantity<typename DimensionQuotient<D1, D2>::type, std::ratio_divide<S1, S2>>
+operator/(Quantity<D1, S1> dividend, Quantity<D2, S2> divisor) {
+    return Quantity<typename DimensionQuotient<D1, D2>::type, std::ratio_divide<S1, S2>>(dividend.value() / divisor.value());
+}
+
+namespace Dimensions {
+    using Scalar = Dimension<0, 0, 0, 0>;
+    using Length = Dimension<1, 0, 0, 0>;
+    using Mass = Dimension<0, 1, 0, 0>;
+    using Time = Dimension<0, 0, 1, 0>;
+    using Angle = Dimension<0, 0, 0, 1>;
+    using Speed = Dimension<1, 0, -1, 0>;
+    using Acceleration = Dimension<1, 0, -2, 0>;
+    using AngularVelocity = Dimension<0, 0, -1, 1>;
+}
+
+// Units, with the same ratios as in measurementunits.h
+using Metres = Quantity<Dimensions::Length>;
+using AstronomicalUnits = Quantity<Dimensions::Length, std::ratio<149597870700>>;
+using Kilograms = Quantity<Dimensions::Mass>;
+using Seconds = Quantity<Dimensions::Time>;
+using Days = Quantity<Dimensions::Time, std::ratio<86400>>;
+using Years = Quantity<Dimensions::Time, std::ratio<31556952>>; // 365.2425 days, like TimeUnit::YEARS
+using Degrees = Quantity<Dimensions::Angle>;
+using MetresPerSecond = Quantity<Dimensions::Speed>;
+using MetresPerSecondSquare = Quantity<Dimensions::Acceleration>;
+using DegreesPerDay = Quantity<Dimensions::AngularVelocity, std::ratio<1, 86400>>;
+
+#endif // QUANTITY_H
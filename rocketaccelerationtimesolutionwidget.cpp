@@ -4,6 +4,9 @@
 #include "measurementunits.h"
 #include "orbitalmath.h"
 
+#include <numeric>
+#include <vector>
+
 RocketAccelerationTimeSolutionWidget::RocketAccelerationTimeSolutionWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::RocketAccelerationTimeSolutionWidget)
@@ -25,7 +28,7 @@ RocketAccelerationTimeSolutionWidget::~RocketAccelerationTimeSolutionWidget()
     delete ui;
 }
 
-void RocketAccelerationTimeSolutionWidget::setPlanets(const QList<Planet>& newPlanets) {
+void RocketAccelerationTimeSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
     planets = &newPlanets;
     updateRocketAccelerationTimeTable();
 }
@@ -35,6 +38,26 @@ void RocketAccelerationTimeSolutionWidget::setRocket(const Rocket* newRocket) {
     updateRocketAccelerationTimeTable();
 }
 
+void RocketAccelerationTimeSolutionWidget::updatePlanets(const SolarSystem& newPlanets, const PlanetChangeSet& changes) {
+    planets = &newPlanets;
+
+    // Start over if the table does not show the planets from before the change
+    const qsizetype previousPlanetCount = newPlanets.size() - changes.added.size() + changes.removed.size();
+    if (nullptr == rocket || newPlanets.empty() || 0 == previousPlanetCount
+        || rocketAccelerationTimeTableModel->rowCount() != previousPlanetCount) {
+        updateRocketAccelerationTimeTable();
+        return;
+    }
+
+    // Drop the rows of removed planets, last first so that the other indices still hold
+    for (auto removed = changes.removed.crbegin(); removed != changes.removed.crend(); ++removed) {
+        rocketAccelerationTimeTableModel->removeRow(int(*removed));
+    }
+    rocketAccelerationTimeTableModel->setRowCount(planets->size());
+
+    updateRocketAccelerationTimeRows(changes.modified + changes.added);
+}
+
 void RocketAccelerationTimeSolutionWidget::updateRocketAccelerationTimeTable() {
     if (nullptr != rocket && nullptr != planets && !planets->empty()) {
         // Clear table, re-set-up header row
@@ -42,36 +65,11 @@ void RocketAccelerationTimeSolutionWidget::updateRocketAccelerationTimeTable() {
         rocketAccelerationTimeTableModel->setHorizontalHeaderLabels(
             {"Planet", "Escape velocity", "Time to escape velocity", "Distance travelled"}
             );
-        rocketAccelerationTimeTableModel->setRowCount(planets->length());
-
-        // Populate table
-        for (int i = 0; i < planets->length(); ++i) {
-            double planetEscapeVelocity = OrbitalMath::escapeVelocity( (*planets)[i] );
-
-            OrbitalMath::AccelerationResult rocketAccelerationStats
-                = OrbitalMath::computeAccelerationValues(*rocket, planetEscapeVelocity);
-
-            rocketAccelerationTimeTableModel->setData(
-                rocketAccelerationTimeTableModel->index(i, 0),
-                (*planets)[i].getName()
-                );
-            rocketAccelerationTimeTableModel->setData(
-                rocketAccelerationTimeTableModel->index(i, 1),
-                QString("%1 m/s").arg(planetEscapeVelocity)
-                );
-            rocketAccelerationTimeTableModel->setData(
-                rocketAccelerationTimeTableModel->index(i, 2),
-                QString("%1 s").arg(rocketAccelerationStats.accelerationTime)
-                );
-            rocketAccelerationTimeTableModel->setData(
-                rocketAccelerationTimeTableModel->index(i, 3),
-                QString("%1 km").arg(DistanceUnit::convert(
-                                         rocketAccelerationStats.accelerationDistance,
-                                         DistanceUnit::METRES,
-                                         DistanceUnit::KILOMETRES
-                                     ))
-                );
-        }
+        rocketAccelerationTimeTableModel->setRowCount(planets->size());
+
+        QList<qsizetype> rows(planets->size());
+        std::iota(rows.begin(), rows.end(), 0);
+        updateRocketAccelerationTimeRows(rows);
 
         // Show table
         ui->stackedWidget->setCurrentIndex(1);
@@ -81,3 +79,43 @@ void RocketAccelerationTimeSolutionWidget::updateRocketAccelerationTimeTable() {
         ui->stackedWidget->setCurrentIndex(0);
     }
 }
+
+void RocketAccelerationTimeSolutionWidget::updateRocketAccelerationTimeRows(const QList<qsizetype>& rows) {
+    // Gather the planets of these rows, and compute escape velocities and acceleration stats in batches
+    std::vector<double> masses(rows.size());
+    std::vector<double> radii(rows.size());
+    for (qsizetype k = 0; k < rows.size(); ++k) {
+        masses[k] = planets->getMassInKilograms(rows[k]);
+        radii[k] = planets->getRadiusInMetres(rows[k]);
+    }
+    std::vector<double> escapeVelocities(rows.size());
+    std::vector<double> accelerationTimes(rows.size());
+    std::vector<double> accelerationDistances(rows.size());
+    OrbitalMath::escapeVelocities(masses, radii, escapeVelocities);
+    OrbitalMath::computeAccelerationValues(*rocket, escapeVelocities, accelerationTimes, accelerationDistances);
+
+    // Populate table
+    for (qsizetype k = 0; k < rows.size(); ++k) {
+        const qsizetype i = rows[k];
+        rocketAccelerationTimeTableModel->setData(
+            rocketAccelerationTimeTableModel->index(i, 0),
+            planets->getName(i)
+            );
+        rocketAccelerationTimeTableModel->setData(
+            rocketAccelerationTimeTableModel->index(i, 1),
+            QString("%1 m/s").arg(escapeVelocities[k])
+            );
+        rocketAccelerationTimeTableModel->setData(
+            rocketAccelerationTimeTableModel->index(i, 2),
+            QString("%1 s").arg(accelerationTimes[k])
+            );
+        rocketAccelerationTimeTableModel->setData(
+            rocketAccelerationTimeTableModel->index(i, 3),
+            QString("%1 km").arg(DistanceUnit::convert(
+                                     accelerationDistances[k],
+                                     DistanceUnit::METRES,
+                                     DistanceUnit::KILOMETRES
+                                 ))
+            );
+    }
+}
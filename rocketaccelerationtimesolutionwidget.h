@@ -1,7 +1,7 @@
 #ifndef ROCKETACCELERATIONTIMESOLUTIONWIDGET_H
 #define ROCKETACCELERATIONTIMESOLUTIONWIDGET_H
 
-#include "planet.h"
+#include "solarsystem.h"
 #include "rocket.h"
 
 #include <QWidget>
@@ -20,16 +20,23 @@ public:
     ~RocketAccelerationTimeSolutionWidget();
 
 public slots:
-    void setPlanets(const QList<Planet>& newPlanets);
+    void setPlanets(const SolarSystem& newPlanets);
     void setRocket(const Rocket* newRocket);
 
+    /**
+     * Like `setPlanets`, but only recomputes the rows of the planets that
+     * changed since the last call.
+     */
+    void updatePlanets(const SolarSystem& newPlanets, const PlanetChangeSet& changes);
+
 private:
     Ui::RocketAccelerationTimeSolutionWidget *ui;
-    const QList<Planet>* planets = nullptr;
+    const SolarSystem* planets = nullptr;
     const Rocket* rocket = nullptr;
 
     QStandardItemModel* rocketAccelerationTimeTableModel;
     void updateRocketAccelerationTimeTable();
+    void updateRocketAccelerationTimeRows(const QList<qsizetype>& rows);
 };
 
 #endif // ROCKETACCELERATIONTIMESOLUTIONWIDGET_H
@@ -0,0 +1,234 @@
+#include "rocketsweepsolutionwidget.h"
+#include "ui_rocketsweepsolutionwidget.h"
+
+#include "dialogutils.h"
+#include "orbitalmath.h"
+
+#include <QElapsedTimer>
+
+RocketSweepSolutionWidget::RocketSweepSolutionWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::RocketSweepSolutionWidget)
+{
+    ui->setupUi(this);
+    captionTemplate = ui->rocketSweepCaptionLabel->text(); // Store template so we can put it back if needed
+
+    // Set up table model
+    paretoFrontTableModel = new QStandardItemModel(this);
+    paretoFrontTableModel->setHorizontalHeaderLabels(
+        {"Engines", "Acceleration per engine", "Total acceleration", "Total travel time"}
+        );
+    ui->paretoFrontTable->setModel(paretoFrontTableModel);
+    ui->paretoFrontTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+}
+
+RocketSweepSolutionWidget::~RocketSweepSolutionWidget()
+{
+    delete paretoFrontTableModel;
+    delete ui;
+}
+
+void RocketSweepSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
+    planets = &newPlanets;
+
+    updateDisplayedPage();
+    updatePlanetSelectOptions();
+    updateRocketSweep();
+}
+
+namespace {
+    const auto NO_PLANETS_SELECTED("No origin/destination planets selected.\nPlease select target planets to continue.");
+    const auto NO_ORBITAL_DATA("No orbital data loaded for %1.\nPlease load orbital data from the side panel to continue.");
+    const auto SAME_PLANET("Same planet selected as both origin and destination.\nPlease select two different planets to continue.");
+    const auto INVALID_PLANET("Invalid planet selected: %1.\nPlease select a valid planet from the options list to continue.");
+    const auto INVALID_RANGE("The minimum %1 is above the maximum.\nPlease pick a valid range to continue.");
+    const auto TOO_MANY_CONFIGURATIONS("Too many rocket configurations (%1) to sweep.\nPlease sweep at most %2 configurations to continue.");
+
+    // Beyond that, the sweep would take too much memory (48 bytes per configuration)
+    constexpr qsizetype MAXIMUM_CONFIGURATIONS = 1'000'000;
+}
+
+void RocketSweepSolutionWidget::updateDisplayedPage() {
+    if (nullptr != planets && !planets->empty()) {
+        // Show main processing section
+        ui->stackedWidget->setCurrentIndex(1);
+    }
+    else ui->stackedWidget->setCurrentIndex(0);
+}
+
+void RocketSweepSolutionWidget::updatePlanetSelectOptions() {
+    // Try to keep current options if possible
+    const QString oldFromPlanet = ui->fromPlanetSelect->currentText();
+    const QString oldToPlanet = ui->toPlanetSelect->currentText();
+
+    // Clear options and load with new planets
+    ui->fromPlanetSelect->clear();
+    ui->toPlanetSelect->clear();
+
+    ui->fromPlanetSelect->addItems(planets->names());
+    ui->toPlanetSelect->addItems(planets->names());
+
+    // Try to reinstate old options
+    // If not found, Qt will just ignore us since the QComboBox is not editable
+    ui->fromPlanetSelect->setCurrentText(oldFromPlanet);
+    ui->toPlanetSelect->setCurrentText(oldToPlanet);
+}
+
+void RocketSweepSolutionWidget::updateRocketSweep() {
+    // Get selected planet names
+    const QString fromPlanetName = ui->fromPlanetSelect->currentText();
+    const QString toPlanetName = ui->toPlanetSelect->currentText();
+
+    // First, check whether we can compute at all and warn user if not.
+    ui->resultsStackedWidget->setCurrentIndex(0); // Assume error, put back once we're sure all is good
+
+    if (nullptr == planets || planets->empty()) return; // "No data" page is showing
+    if (fromPlanetName.isEmpty() || toPlanetName.isEmpty()) {
+        ui->resultsIssueLabel->setText(NO_PLANETS_SELECTED);
+        return;
+    }
+    if (fromPlanetName == toPlanetName) {
+        ui->resultsIssueLabel->setText(SAME_PLANET);
+        return;
+    }
+
+    // Get selected planets
+    const std::optional<qsizetype> fromPlanetIndex = planets->indexOf(fromPlanetName);
+    const std::optional<qsizetype> toPlanetIndex = planets->indexOf(toPlanetName);
+
+    // Continue checks and warn user of issues
+    if (!fromPlanetIndex.has_value() || !toPlanetIndex.has_value()) {
+        // This should be impossible given how we populate the QComboBox
+        // But we'll check, just in case
+        QStringList invalidPlanets;
+        if (!fromPlanetIndex.has_value()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanetIndex.has_value()) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(INVALID_PLANET).arg(invalidPlanetNames));
+
+        return;
+    }
+    const Planet fromPlanet = planets->at(fromPlanetIndex.value());
+    const Planet toPlanet = planets->at(toPlanetIndex.value());
+    if (!fromPlanet.hasOrbitalData() || !toPlanet.hasOrbitalData()) {
+        QStringList invalidPlanets;
+        if (!fromPlanet.hasOrbitalData()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanet.hasOrbitalData()) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(NO_ORBITAL_DATA).arg(invalidPlanetNames));
+
+        return;
+    }
+
+    OrbitalMath::RocketSweepSpec spec;
+    spec.minimumEngines = short(ui->minimumEnginesSpinBox->value());
+    spec.maximumEngines = short(ui->maximumEnginesSpinBox->value());
+    spec.minimumAccelerationPerEngine = ui->minimumAccelerationSpinBox->value();
+    spec.maximumAccelerationPerEngine = ui->maximumAccelerationSpinBox->value();
+    spec.accelerationCount = ui->accelerationCountSpinBox->value();
+
+    if (spec.minimumEngines > spec.maximumEngines) {
+        ui->resultsIssueLabel->setText(QString(INVALID_RANGE).arg("engine count"));
+        return;
+    }
+    if (spec.minimumAccelerationPerEngine > spec.maximumAccelerationPerEngine) {
+        ui->resultsIssueLabel->setText(QString(INVALID_RANGE).arg("acceleration per engine"));
+        return;
+    }
+    if (spec.size() > MAXIMUM_CONFIGURATIONS) {
+        ui->resultsIssueLabel->setText(QString(TOO_MANY_CONFIGURATIONS).arg(spec.size()).arg(MAXIMUM_CONFIGURATIONS));
+        return;
+    }
+
+    // If we got here, all is well and we can display the results page
+    ui->resultsStackedWidget->setCurrentIndex(1);
+
+    const double departureDay = ui->departureDaySpinBox->value();
+
+    QElapsedTimer timer;
+    timer.start();
+    const OrbitalMath::RocketSweep sweep = OrbitalMath::rocketSweep(fromPlanet, toPlanet, spec, NAN, NAN, Days(departureDay));
+    const qint64 computationTime = timer.nsecsElapsed();
+
+    // Clear table, re-set-up header row, then list the Pareto front
+    paretoFrontTableModel->clear();
+    paretoFrontTableModel->setHorizontalHeaderLabels(
+        {"Engines", "Acceleration per engine", "Total acceleration", "Total travel time"}
+        );
+    paretoFrontTableModel->setRowCount(sweep.paretoFront.size());
+    for (qsizetype row = 0; row < sweep.paretoFront.size(); ++row) {
+        const qsizetype cell = sweep.paretoFront[row];
+        const short engines = spec.engineCount(cell);
+        const double accelerationPerEngine = spec.accelerationPerEngine(cell);
+        const double totalTravelTime = sweep.totalTravelTimes[cell];
+
+        paretoFrontTableModel->setData(paretoFrontTableModel->index(row, 0), engines);
+        paretoFrontTableModel->setData(
+            paretoFrontTableModel->index(row, 1),
+            QString("%1 m/s²").arg(accelerationPerEngine)
+            );
+        paretoFrontTableModel->setData(
+            paretoFrontTableModel->index(row, 2),
+            QString("%1 m/s²").arg(engines * accelerationPerEngine)
+            );
+        paretoFrontTableModel->setData(
+            paretoFrontTableModel->index(row, 3),
+            QString("%1 s (%2)").arg(totalTravelTime).arg(DialogUtils::formatTime(totalTravelTime))
+            );
+    }
+
+    QString newCaptionText = captionTemplate; // Make a copy
+    newCaptionText
+        .replace("{configurations}", QString::number(spec.size()))
+        .replace("{engineCounts}", QString::number(spec.engineCounts()))
+        .replace("{accelerationCounts}", QString::number(spec.accelerationCount))
+        .replace("{fromPlanet}", fromPlanetName)
+        .replace("{toPlanet}", toPlanetName)
+        .replace("{departureDay}", QString::number(departureDay))
+        .replace("{computationTime}", QString::number(computationTime / 1e6)) // ns to ms
+        .replace("{frontSize}", QString::number(sweep.paretoFront.size()));
+    ui->rocketSweepCaptionLabel->setText(newCaptionText);
+}
+
+void RocketSweepSolutionWidget::on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName)
+{
+    // No need to do anything with the values in these slots, since updateRocketSweep() reads them anyway
+    updateRocketSweep();
+}
+
+void RocketSweepSolutionWidget::on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName)
+{
+    updateRocketSweep();
+}
+
+void RocketSweepSolutionWidget::on_departureDaySpinBox_valueChanged(double newDepartureDay)
+{
+    updateRocketSweep();
+}
+
+void RocketSweepSolutionWidget::on_minimumEnginesSpinBox_valueChanged(int newMinimumEngines)
+{
+    updateRocketSweep();
+}
+
+void RocketSweepSolutionWidget::on_maximumEnginesSpinBox_valueChanged(int newMaximumEngines)
+{
+    updateRocketSweep();
+}
+
+void RocketSweepSolutionWidget::on_minimumAccelerationSpinBox_valueChanged(double newMinimumAcceleration)
+{
+    updateRocketSweep();
+}
+
+void RocketSweepSolutionWidget::on_maximumAccelerationSpinBox_valueChanged(double newMaximumAcceleration)
+{
+    updateRocketSweep();
+}
+
+void RocketSweepSolutionWidget::on_accelerationCountSpinBox_valueChanged(int newAccelerationCount)
+{
+    updateRocketSweep();
+}
@@ -0,0 +1,46 @@
+#ifndef ROCKETSWEEPSOLUTIONWIDGET_H
+#define ROCKETSWEEPSOLUTIONWIDGET_H
+
+#include <QStandardItemModel>
+#include <QWidget>
+
+#include "solarsystem.h"
+
+namespace Ui {
+class RocketSweepSolutionWidget;
+}
+
+class RocketSweepSolutionWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RocketSweepSolutionWidget(QWidget *parent = nullptr);
+    ~RocketSweepSolutionWidget();
+
+public slots:
+    void setPlanets(const SolarSystem& newPlanets);
+
+private slots:
+    void on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName);
+    void on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName);
+    void on_departureDaySpinBox_valueChanged(double newDepartureDay);
+    void on_minimumEnginesSpinBox_valueChanged(int newMinimumEngines);
+    void on_maximumEnginesSpinBox_valueChanged(int newMaximumEngines);
+    void on_minimumAccelerationSpinBox_valueChanged(double newMinimumAcceleration);
+    void on_maximumAccelerationSpinBox_valueChanged(double newMaximumAcceleration);
+    void on_accelerationCountSpinBox_valueChanged(int newAccelerationCount);
+
+private:
+    Ui::RocketSweepSolutionWidget *ui;
+    const SolarSystem* planets = nullptr;
+    QString captionTemplate;
+
+    QStandardItemModel* paretoFrontTableModel;
+
+    void updateDisplayedPage();
+    void updatePlanetSelectOptions();
+    void updateRocketSweep();
+};
+
+#endif // ROCKETSWEEPSOLUTIONWIDGET_H
@@ -0,0 +1,198 @@
+#include "routeplanner.h"
+#include "measurementunits.h"
+#include "orbitalmath.h"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
+
+RoutePlanner::RoutePlanner(const SolarSystem& planets, const Rocket& rocket, double bucketInDays)
+    : planets(planets)
+    , rocket(rocket)
+    , bucketInDays(bucketInDays)
+{
+    // Extremes over the planets that can be part of a route
+    double slowestEscapeVelocity = INFINITY;
+    double fastestEscapeVelocity = 0;
+    double largestRadius = 0;
+    double widestOrbitalBand = 0; // Apoapsis - periapsis, in AU
+    for (qsizetype i = 0; i < planets.size(); ++i) {
+        if (!planets.hasOrbitalData(i)) continue;
+
+        const Planet planet = planets.at(i);
+        const double escapeVelocity = OrbitalMath::escapeVelocity(planet);
+        slowestEscapeVelocity = std::min(slowestEscapeVelocity, escapeVelocity);
+        fastestEscapeVelocity = std::max(fastestEscapeVelocity, escapeVelocity);
+        largestRadius = std::max(largestRadius, planet.getRadiusInMetres());
+        widestOrbitalBand = std::max(widestOrbitalBand, 2 * planet.getOrbitalRadiusInAU().value() * planet.getEccentricity().value());
+    }
+    if (0 == fastestEscapeVelocity) return; // No planets to route between
+
+    // A leg covering a distance D (between surfaces) at cruising velocity v takes
+    // D/v + v/a (see computeTransfer: accelerating to v and back takes 2v/a, during
+    // which the rocket covers v²/a), so any leg takes at least v_min/a, and
+    // at least D/v_max more
+    const double minimumLegTimeInSeconds = slowestEscapeVelocity / OrbitalMath::totalAcceleration(rocket);
+    minimumLegTimeInDays = TimeUnit::convert(minimumLegTimeInSeconds, TimeUnit::SECONDS, TimeUnit::DAYS);
+
+    // Each stopover can shorten the distance left by up to its planet's
+    // diameter (legs go from surface to surface) plus the width of its
+    // orbital band (by waiting for the planet to move), but costs another leg.
+    // If that leg takes longer than covering the distance saved, stopovers
+    // never help, and the remaining distance can be taken at v_max; otherwise,
+    // distance is at best traded for legs at the rate of one leg per stopover.
+    const double stopoverSavingInMetres = 2 * largestRadius
+                                          + DistanceUnit::convert(widestOrbitalBand, DistanceUnit::AU, DistanceUnit::METRES);
+    double minimumSecondsPerMetre = 1 / fastestEscapeVelocity;
+    if (stopoverSavingInMetres > 0) minimumSecondsPerMetre = std::min(minimumSecondsPerMetre, minimumLegTimeInSeconds / stopoverSavingInMetres);
+    minimumDaysPerMetre = TimeUnit::convert(minimumSecondsPerMetre, TimeUnit::SECONDS, TimeUnit::DAYS);
+}
+
+double RoutePlanner::lowerBoundInDays(qsizetype from, qsizetype to) const {
+    if (from == to) return 0;
+
+    const Planet fromPlanet = planets.at(from);
+    const Planet toPlanet = planets.at(to);
+
+    // Distance (in AU) between the surfaces that no route can avoid covering
+    double gap;
+    if (0 == fromPlanet.getEccentricity().value() && 0 == toPlanet.getEccentricity().value()) {
+        gap = OrbitalMath::shortestDistance(fromPlanet, toPlanet);
+    }
+    else {
+        // The planets are not always at the same angle when the rocket leaves and
+        // arrives, so use the gap between their orbital bands instead
+        const double fromPeriapsis = fromPlanet.getOrbitalRadiusInAU().value() * (1 - fromPlanet.getEccentricity().value());
+        const double fromApoapsis = fromPlanet.getOrbitalRadiusInAU().value() * (1 + fromPlanet.getEccentricity().value());
+        const double toPeriapsis = toPlanet.getOrbitalRadiusInAU().value() * (1 - toPlanet.getEccentricity().value());
+        const double toApoapsis = toPlanet.getOrbitalRadiusInAU().value() * (1 + toPlanet.getEccentricity().value());
+        gap = std::max({0.0, fromPeriapsis - toApoapsis, toPeriapsis - fromApoapsis})
+              - DistanceUnit::convert(fromPlanet.getRadiusInMetres() + toPlanet.getRadiusInMetres(), DistanceUnit::METRES, DistanceUnit::AU);
+    }
+
+    const double gapInMetres = DistanceUnit::convert(std::max(0.0, gap), DistanceUnit::AU, DistanceUnit::METRES);
+    return minimumLegTimeInDays + gapInMetres * minimumDaysPerMetre;
+}
+
+double RoutePlanner::legTravelTime(qsizetype from, qsizetype to, qint64 departureBucket, qsizetype& computedLegs) {
+    const std::pair<qsizetype, qint64> key(from * planets.size() + to, departureBucket);
+    const auto memoized = legTravelTimes.constFind(key);
+    if (memoized != legTravelTimes.constEnd()) return memoized.value();
+
+    ++computedLegs;
+    const OrbitalMath::TransferResults transfer = OrbitalMath::computeSimpleTransfer(
+        planets.at(from), planets.at(to), rocket, NAN, NAN, Days(departureBucket * bucketInDays));
+    const double travelTime = Days(transfer.totalTravelTime).value();
+
+    legTravelTimes.insert(key, travelTime);
+    return travelTime;
+}
+
+qsizetype RoutePlanner::memoizedLegCount() const {
+    return legTravelTimes.size();
+}
+
+RoutePlanner::Route RoutePlanner::planRoute(qsizetype from, qsizetype to, double earliestDepartureDay, double latestArrivalDay) {
+    Route route;
+    if (!planets.hasOrbitalData(from) || !planets.hasOrbitalData(to) || latestArrivalDay < earliestDepartureDay) return route;
+
+    // Already there
+    if (from == to) {
+        route.found = true;
+        route.arrivalDay = earliestDepartureDay;
+        return route;
+    }
+
+    const qsizetype planetCount = planets.size();
+
+    std::vector<double> remainingTimeBounds(planetCount, INFINITY);
+    for (qsizetype i = 0; i < planetCount; ++i) {
+        if (planets.hasOrbitalData(i)) remainingTimeBounds[i] = lowerBoundInDays(i, to);
+    }
+
+    // A state is a planet and the bucket the rocket departs it in. Where it goes
+    // next only depends on that, so each state is reached once (remembering how)
+    // and expanded once.
+    using State = std::pair<qsizetype, qint64>;
+    struct StateInfo {
+        State previous; // Same planet if the rocket waited there, none for the start
+        double arrivalDay; // Moment (in days) the leg from `previous` landed
+    };
+    QHash<State, StateInfo> reachedStates;
+
+    // Earliest known arrival at the destination, and the state its last leg leaves from
+    double bestArrivalDay = INFINITY;
+    State bestLastState(-1, 0);
+    const auto canBeatBest = [&](double earliestPossibleArrival) {
+        return earliestPossibleArrival <= latestArrivalDay && earliestPossibleArrival < bestArrivalDay;
+    };
+
+    // States to expand, by earliest possible arrival at the destination
+    using QueueEntry = std::pair<double, State>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<>> queue;
+    const auto reach = [&](State state, State previous, double arrivalDay) {
+        const double estimatedArrivalDay = state.second * bucketInDays + remainingTimeBounds[state.first];
+        if (!canBeatBest(estimatedArrivalDay) || reachedStates.contains(state)) return;
+
+        reachedStates.insert(state, { previous, arrivalDay });
+        queue.push({ estimatedArrivalDay, state });
+    };
+
+    const State start(from, qint64(std::ceil(earliestDepartureDay / bucketInDays)));
+    reach(start, State(-1, 0), earliestDepartureDay);
+
+    // Since estimates never exceed the arrivals they lead to, the search is over
+    // once the next estimate cannot beat the best arrival found
+    while (!queue.empty() && canBeatBest(queue.top().first)) {
+        const State state = queue.top().second;
+        queue.pop();
+        ++route.expandedStates;
+
+        const auto [planet, bucket] = state;
+        const double departureDay = bucket * bucketInDays;
+
+        // Wait for the next bucket
+        reach(State(planet, bucket + 1), state, NAN);
+
+        for (qsizetype next = 0; next < planetCount; ++next) {
+            if (next == planet || !planets.hasOrbitalData(next)) continue;
+
+            // Don't bother computing legs that can't lead anywhere better, even at their fastest
+            if (!canBeatBest(departureDay + minimumLegTimeInDays + remainingTimeBounds[next])) continue;
+
+            const double arrivalDay = departureDay + legTravelTime(planet, next, bucket, route.computedLegs);
+            if (!canBeatBest(arrivalDay)) continue;
+
+            if (next == to) {
+                bestArrivalDay = arrivalDay;
+                bestLastState = state;
+            }
+            else reach(State(next, qint64(std::ceil(arrivalDay / bucketInDays))), state, arrivalDay);
+        }
+    }
+
+    if (!std::isfinite(bestArrivalDay)) return route;
+
+    // Walk back from the destination, skipping the waits
+    route.found = true;
+    route.arrivalDay = bestArrivalDay;
+    State departure = bestLastState;
+    qsizetype legDestination = to;
+    double legArrivalDay = bestArrivalDay;
+    while (true) {
+        route.legs.prepend({ departure.first, legDestination, departure.second * bucketInDays, legArrivalDay });
+
+        // Back to the arrival at the planet the leg departs
+        State arrival = departure;
+        while (reachedStates[arrival].previous.first == arrival.first) arrival = reachedStates[arrival].previous;
+        const StateInfo& info = reachedStates[arrival];
+        if (-1 == info.previous.first) break; // The start
+
+        legDestination = arrival.first;
+        legArrivalDay = info.arrivalDay;
+        departure = info.previous;
+    }
+
+    return route;
+}
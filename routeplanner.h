@@ -0,0 +1,140 @@
+#ifndef ROUTEPLANNER_H
+#define ROUTEPLANNER_H
+
+#include "rocket.h"
+#include "solarsystem.h"
+
+#include <QHash>
+#include <QList>
+#include <QtGlobal>
+
+#include <cmath>
+#include <utility>
+
+/**
+ * Plans routes between two planets that may stop over at other planets
+ * (e.g. A→B→C), waiting at any of them for a better departure if that pays
+ * off, so as to arrive as early as possible within a time window.
+ *
+ * Each leg is a transfer as computed by `OrbitalMath::computeSimpleTransfer`
+ * between where the planets are at departure. Since those positions keep
+ * changing, so does the cost of every leg, and leaving later can arrive
+ * earlier. Departures are therefore rounded up to whole buckets of time
+ * (i.e. the rocket waits until the next bucket starts), and the search is
+ * an A* over (planet, departure bucket) states: from each state the rocket
+ * either waits for the next bucket at the same planet, or takes a leg to
+ * another planet with orbital data, landing in the bucket of its arrival.
+ * Routes found are thus the earliest-arriving ones among all routes
+ * departing at bucket starts; shorter buckets get closer to the
+ * continuous optimum, at the cost of more states.
+ *
+ * Departures are not limited to the alignments of the two planets (see
+ * `OrbitalMath::daysUntilAligned`): with the rocket's travel time and
+ * elliptical orbits, the fastest leg often leaves well before or after
+ * one, and legs to a stopover are not worth aligning for at all. Nor do
+ * alignments help the search along: the route waiting for the next
+ * alignment with the destination gives an early arrival to beat, but A*
+ * never expands states whose estimate exceeds the best arrival anyway,
+ * so it only adds legs to compute.
+ *
+ * Every leg cost is computed only when the search first needs it, then
+ * memoized per (planet pair, departure bucket) for the lifetime of the
+ * planner, so later searches reuse them. The planets and rocket must
+ * therefore not change while the planner is in use.
+ *
+ * The A* heuristic is a lower bound on the remaining travel time derived
+ * from `OrbitalMath::shortestDistance` (see `lowerBoundInDays`), whatever
+ * the departure time.
+ */
+class RoutePlanner
+{
+public:
+    /**
+     * Default departure bucket length, in days.
+     */
+    static constexpr double DEFAULT_BUCKET_IN_DAYS = 1;
+
+    /**
+     * One hop of a route.
+     */
+    struct Leg {
+        qsizetype from;
+        qsizetype to;
+
+        /**
+         * Moments (in days) the rocket leaves `from` and lands on `to`.
+         */
+        double departureDay;
+        double arrivalDay;
+    };
+
+    /**
+     * A route found by `planRoute`.
+     */
+    struct Route {
+        /**
+         * Whether any route arrives within the time window. If not,
+         * the other fields are empty/NaN.
+         */
+        bool found = false;
+
+        QList<Leg> legs;
+
+        /**
+         * Moment (in days) of arrival at the destination.
+         */
+        double arrivalDay = NAN;
+
+        /**
+         * Number of (planet, departure bucket) states the search expanded,
+         * and of legs it computed rather than read from the memo, for
+         * this route.
+         */
+        qsizetype expandedStates = 0;
+        qsizetype computedLegs = 0;
+    };
+
+    RoutePlanner(const SolarSystem& planets, const Rocket& rocket, double bucketInDays = DEFAULT_BUCKET_IN_DAYS);
+
+    /**
+     * Finds the earliest-arriving route from planet `from` to planet `to`
+     * (indices in the solar system) whose legs depart at bucket starts,
+     * leaving no earlier than `earliestDepartureDay` and arriving no later
+     * than `latestArrivalDay`. Planets lacking orbital data are never part
+     * of a route.
+     */
+    Route planRoute(qsizetype from, qsizetype to, double earliestDepartureDay, double latestArrivalDay);
+
+    /**
+     * Number of leg costs memoized so far.
+     */
+    qsizetype memoizedLegCount() const;
+
+private:
+    const SolarSystem& planets;
+    const Rocket& rocket;
+    double bucketInDays;
+
+    // Travel time (in days) of the leg between a planet pair (start planet
+    // index * planet count + destination planet index), departing at the
+    // start of a bucket (in whole buckets since time 0)
+    QHash<std::pair<qsizetype, qint64>, double> legTravelTimes;
+
+    // Planet-independent parts of the heuristic (see lowerBoundInDays)
+    double minimumLegTimeInDays = 0;
+    double minimumDaysPerMetre = 0;
+
+    /**
+     * Travel time (in days) of the leg, departing at the start of the
+     * given bucket; computed on first use, then memoized.
+     */
+    double legTravelTime(qsizetype from, qsizetype to, qint64 departureBucket, qsizetype& computedLegs);
+
+    /**
+     * A lower bound on the time (in days) any route from `from` to `to`
+     * takes, whatever its stopovers and departure times.
+     */
+    double lowerBoundInDays(qsizetype from, qsizetype to) const;
+};
+
+#endif // ROUTEPLANNER_H
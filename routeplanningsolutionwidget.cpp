@@ -0,0 +1,228 @@
+#include "routeplanningsolutionwidget.h"
+#include "ui_routeplanningsolutionwidget.h"
+
+#include "dialogutils.h"
+#include "measurementunits.h"
+
+#include <QElapsedTimer>
+
+RoutePlanningSolutionWidget::RoutePlanningSolutionWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::RoutePlanningSolutionWidget)
+{
+    ui->setupUi(this);
+    captionTemplate = ui->routeCaptionLabel->text(); // Store template so we can put it back if needed
+
+    // Set up table model
+    routeTableModel = new QStandardItemModel(this);
+    routeTableModel->setHorizontalHeaderLabels(
+        {"From", "To", "Departure day", "Arrival day", "Travel time"}
+        );
+    ui->routeTable->setModel(routeTableModel);
+    ui->routeTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+}
+
+RoutePlanningSolutionWidget::~RoutePlanningSolutionWidget()
+{
+    delete routeTableModel;
+    delete ui;
+}
+
+void RoutePlanningSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
+    planets = &newPlanets;
+
+    updateDisplayedPage();
+    updatePlanetSelectOptions();
+    updateRoutePlanner();
+    updateRoute();
+}
+
+void RoutePlanningSolutionWidget::setRocket(const Rocket* newRocket) {
+    rocket = newRocket;
+
+    updateDisplayedPage();
+    updateRoutePlanner();
+    updateRoute();
+}
+
+namespace {
+    const auto NO_PLANETS_SELECTED("No origin/destination planets selected.\nPlease select target planets to continue.");
+    const auto NO_ORBITAL_DATA("No orbital data loaded for %1.\nPlease load orbital data from the side panel to continue.");
+    const auto SAME_PLANET("Same planet selected as both origin and destination.\nPlease select two different planets to continue.");
+    const auto INVALID_PLANET("Invalid planet selected: %1.\nPlease select a valid planet from the options list to continue.");
+    const auto INVALID_TIMEFRAME("Latest arrival is before the earliest departure.\nPlease select a valid time window to continue.");
+    const auto TOO_MANY_BUCKETS("Too many departure buckets (%1) in the time window.\nPlease search at most %2 buckets (with longer buckets or a shorter window) to continue.");
+    const auto NO_ROUTE("No route arrives by day %1.\nPlease select a longer time window to continue.");
+
+    // The search can expand every (planet, bucket) state in the window, each computing a leg to every planet
+    constexpr qint64 MAXIMUM_BUCKETS = 100'000;
+}
+
+void RoutePlanningSolutionWidget::updateDisplayedPage() {
+    if (nullptr != rocket && nullptr != planets && !planets->empty()) {
+        // Show main processing section
+        ui->stackedWidget->setCurrentIndex(1);
+    }
+    else ui->stackedWidget->setCurrentIndex(0);
+}
+
+void RoutePlanningSolutionWidget::updatePlanetSelectOptions() {
+    // Try to keep current options if possible
+    const QString oldFromPlanet = ui->fromPlanetSelect->currentText();
+    const QString oldToPlanet = ui->toPlanetSelect->currentText();
+
+    // Clear options and load with new planets
+    ui->fromPlanetSelect->clear();
+    ui->toPlanetSelect->clear();
+
+    ui->fromPlanetSelect->addItems(planets->names());
+    ui->toPlanetSelect->addItems(planets->names());
+
+    // Try to reinstate old options
+    // If not found, Qt will just ignore us since the QComboBox is not editable
+    ui->fromPlanetSelect->setCurrentText(oldFromPlanet);
+    ui->toPlanetSelect->setCurrentText(oldToPlanet);
+}
+
+void RoutePlanningSolutionWidget::updateRoutePlanner() {
+    // Memoized leg costs are only valid for the planets, rocket and buckets they were computed with
+    routePlanner.reset();
+    if (nullptr != rocket && nullptr != planets && !planets->empty()) {
+        routePlanner.emplace(*planets, *rocket, ui->bucketSpinBox->value());
+    }
+}
+
+void RoutePlanningSolutionWidget::updateRoute() {
+    // Get selected planet names
+    const QString fromPlanetName = ui->fromPlanetSelect->currentText();
+    const QString toPlanetName = ui->toPlanetSelect->currentText();
+
+    // First, check whether we can compute at all and warn user if not.
+    ui->resultsStackedWidget->setCurrentIndex(0); // Assume error, put back once we're sure all is good
+
+    if (!routePlanner.has_value()) return; // "No data" page is showing
+    if (fromPlanetName.isEmpty() || toPlanetName.isEmpty()) {
+        ui->resultsIssueLabel->setText(NO_PLANETS_SELECTED);
+        return;
+    }
+    if (fromPlanetName == toPlanetName) {
+        ui->resultsIssueLabel->setText(SAME_PLANET);
+        return;
+    }
+
+    // Get selected planets
+    const std::optional<qsizetype> fromPlanetIndex = planets->indexOf(fromPlanetName);
+    const std::optional<qsizetype> toPlanetIndex = planets->indexOf(toPlanetName);
+
+    // Continue checks and warn user of issues
+    if (!fromPlanetIndex.has_value() || !toPlanetIndex.has_value()) {
+        // This should be impossible given how we populate the QComboBox
+        // But we'll check, just in case
+        QStringList invalidPlanets;
+        if (!fromPlanetIndex.has_value()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanetIndex.has_value()) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(INVALID_PLANET).arg(invalidPlanetNames));
+
+        return;
+    }
+    if (!planets->hasOrbitalData(fromPlanetIndex.value()) || !planets->hasOrbitalData(toPlanetIndex.value())) {
+        QStringList invalidPlanets;
+        if (!planets->hasOrbitalData(fromPlanetIndex.value())) invalidPlanets.append(fromPlanetName);
+        if (!planets->hasOrbitalData(toPlanetIndex.value())) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(NO_ORBITAL_DATA).arg(invalidPlanetNames));
+
+        return;
+    }
+
+    const double earliestDepartureDay = ui->earliestDepartureDaySpinBox->value();
+    const double latestArrivalDay = ui->latestArrivalDaySpinBox->value();
+    const double bucketInDays = ui->bucketSpinBox->value();
+    if (latestArrivalDay < earliestDepartureDay) {
+        ui->resultsIssueLabel->setText(INVALID_TIMEFRAME);
+        return;
+    }
+    const qint64 bucketCount = qint64((latestArrivalDay - earliestDepartureDay) / bucketInDays) + 1;
+    if (bucketCount > MAXIMUM_BUCKETS) {
+        ui->resultsIssueLabel->setText(QString(TOO_MANY_BUCKETS).arg(bucketCount).arg(MAXIMUM_BUCKETS));
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    const RoutePlanner::Route route = routePlanner->planRoute(
+        fromPlanetIndex.value(), toPlanetIndex.value(), earliestDepartureDay, latestArrivalDay
+        );
+    const qint64 computationTime = timer.nsecsElapsed();
+
+    if (!route.found) {
+        ui->resultsIssueLabel->setText(QString(NO_ROUTE).arg(latestArrivalDay));
+        return;
+    }
+
+    // If we got here, all is well and we can display the results page
+    ui->resultsStackedWidget->setCurrentIndex(1);
+
+    // Clear table, re-set-up header row, then list the legs
+    routeTableModel->clear();
+    routeTableModel->setHorizontalHeaderLabels(
+        {"From", "To", "Departure day", "Arrival day", "Travel time"}
+        );
+    routeTableModel->setRowCount(route.legs.size());
+    for (qsizetype row = 0; row < route.legs.size(); ++row) {
+        const RoutePlanner::Leg& leg = route.legs[row];
+        const double travelTime = TimeUnit::convert(leg.arrivalDay - leg.departureDay, TimeUnit::DAYS, TimeUnit::SECONDS);
+
+        routeTableModel->setData(routeTableModel->index(row, 0), planets->getName(leg.from));
+        routeTableModel->setData(routeTableModel->index(row, 1), planets->getName(leg.to));
+        routeTableModel->setData(routeTableModel->index(row, 2), leg.departureDay);
+        routeTableModel->setData(routeTableModel->index(row, 3), leg.arrivalDay);
+        routeTableModel->setData(routeTableModel->index(row, 4), DialogUtils::formatTime(travelTime));
+    }
+
+    const double totalTime = TimeUnit::convert(route.arrivalDay - earliestDepartureDay, TimeUnit::DAYS, TimeUnit::SECONDS);
+
+    QString newCaptionText = captionTemplate; // Make a copy
+    newCaptionText
+        .replace("{fromPlanet}", fromPlanetName)
+        .replace("{toPlanet}", toPlanetName)
+        .replace("{earliestDepartureDay}", QString::number(earliestDepartureDay))
+        .replace("{arrivalDay}", QString::number(route.arrivalDay))
+        .replace("{totalTime}", DialogUtils::formatTime(totalTime))
+        .replace("{legCount}", QString::number(route.legs.size()))
+        .replace("{computationTime}", QString::number(computationTime / 1e6)) // ns to ms
+        .replace("{expandedStates}", QString::number(route.expandedStates))
+        .replace("{computedLegs}", QString::number(route.computedLegs))
+        .replace("{memoizedLegs}", QString::number(routePlanner->memoizedLegCount()));
+    ui->routeCaptionLabel->setText(newCaptionText);
+}
+
+void RoutePlanningSolutionWidget::on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName)
+{
+    // No need to do anything with the values in these slots, since updateRoute() reads them anyway
+    updateRoute();
+}
+
+void RoutePlanningSolutionWidget::on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName)
+{
+    updateRoute();
+}
+
+void RoutePlanningSolutionWidget::on_earliestDepartureDaySpinBox_valueChanged(double newEarliestDepartureDay)
+{
+    updateRoute();
+}
+
+void RoutePlanningSolutionWidget::on_latestArrivalDaySpinBox_valueChanged(double newLatestArrivalDay)
+{
+    updateRoute();
+}
+
+void RoutePlanningSolutionWidget::on_bucketSpinBox_valueChanged(double newBucketInDays)
+{
+    updateRoutePlanner();
+    updateRoute();
+}
@@ -0,0 +1,54 @@
+#ifndef ROUTEPLANNINGSOLUTIONWIDGET_H
+#define ROUTEPLANNINGSOLUTIONWIDGET_H
+
+#include <QStandardItemModel>
+#include <QWidget>
+
+#include "rocket.h"
+#include "routeplanner.h"
+#include "solarsystem.h"
+
+#include <optional>
+
+namespace Ui {
+class RoutePlanningSolutionWidget;
+}
+
+class RoutePlanningSolutionWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit RoutePlanningSolutionWidget(QWidget *parent = nullptr);
+    ~RoutePlanningSolutionWidget();
+
+public slots:
+    void setPlanets(const SolarSystem& newPlanets);
+    void setRocket(const Rocket* newRocket);
+
+private slots:
+    void on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName);
+    void on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName);
+    void on_earliestDepartureDaySpinBox_valueChanged(double newEarliestDepartureDay);
+    void on_latestArrivalDaySpinBox_valueChanged(double newLatestArrivalDay);
+    void on_bucketSpinBox_valueChanged(double newBucketInDays);
+
+private:
+    Ui::RoutePlanningSolutionWidget *ui;
+    const SolarSystem* planets = nullptr;
+    const Rocket* rocket = nullptr;
+    QString captionTemplate;
+
+    QStandardItemModel* routeTableModel;
+
+    // Kept across searches so they reuse each other's leg costs; rebuilt
+    // whenever the planets, rocket or bucket length change
+    std::optional<RoutePlanner> routePlanner;
+
+    void updateDisplayedPage();
+    void updatePlanetSelectOptions();
+    void updateRoutePlanner();
+    void updateRoute();
+};
+
+#endif // ROUTEPLANNINGSOLUTIONWIDGET_H
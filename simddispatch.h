@@ -0,0 +1,48 @@
+#ifndef SIMDDISPATCH_H
+#define SIMDDISPATCH_H
+
+// Helpers for picking a vectorized code path at runtime.
+//
+// Vectorized kernels are compiled for specific instruction sets via
+// target attributes (so the rest of the program keeps running on any
+// x86-64 CPU), then selected at runtime based on what the CPU supports.
+// On compilers/architectures without target attributes (e.g. MSVC, ARM),
+// only the scalar paths are available.
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define SIMD_DISPATCH_X86 1
+#include <immintrin.h>
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#else
+#define SIMD_DISPATCH_X86 0
+#endif
+
+namespace SimdDispatch {
+
+    enum class Level {
+        Scalar,
+        Avx2,
+        Avx512
+    };
+
+    /**
+     * Returns the widest instruction set the current CPU supports
+     * (among the ones we have kernels for). Detected once, then cached.
+     */
+    inline Level detectedLevel() {
+#if SIMD_DISPATCH_X86
+        static const Level level = []() {
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx512f")) return Level::Avx512;
+            if (__builtin_cpu_supports("avx2")) return Level::Avx2;
+            return Level::Scalar;
+        }();
+        return level;
+#else
+        return Level::Scalar;
+#endif
+    }
+}
+
+#endif // SIMDDISPATCH_H
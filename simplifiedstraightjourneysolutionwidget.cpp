@@ -1,15 +1,24 @@
 #include "simplifiedstraightjourneysolutionwidget.h"
 #include "ui_simplifiedstraightjourneysolutionwidget.h"
 
+#include "dialogutils.h"
 #include "measurementunits.h"
+#include "montecarlo.h"
 #include "orbitalmath.h"
 
+#include <QApplication>
+#include <QElapsedTimer>
+
 SimplifiedStraightJourneySolutionWidget::SimplifiedStraightJourneySolutionWidget(QWidget *parent)
     : QWidget(parent)
     , ui(new Ui::SimplifiedStraightJourneySolutionWidget)
 {
     ui->setupUi(this);
     textDisplayTemplate = ui->resultsDisplayLabel->text(); // Store template so we can put it back if needed
+    gravityReportTemplate = ui->gravityReportLabel->text();
+    ui->gravityReportLabel->hide();
+    monteCarloReportTemplate = ui->monteCarloReportLabel->text();
+    ui->monteCarloReportLabel->hide();
 }
 
 SimplifiedStraightJourneySolutionWidget::~SimplifiedStraightJourneySolutionWidget()
@@ -17,7 +26,7 @@ SimplifiedStraightJourneySolutionWidget::~SimplifiedStraightJourneySolutionWidge
     delete ui;
 }
 
-void SimplifiedStraightJourneySolutionWidget::setPlanets(const QList<Planet>& newPlanets) {
+void SimplifiedStraightJourneySolutionWidget::setPlanets(const SolarSystem& newPlanets) {
     planets = &newPlanets;
 
     updateDisplayedPage();
@@ -43,31 +52,6 @@ namespace {
         // We have d = vt + at²/2
         return initialVelocity * time + acceleration * time * time / 2;
     }
-
-    QString formatTime(const double timeInSeconds) {
-        static const int SECONDS_PER_DAY = TimeUnit::convert(1, TimeUnit::DAYS, TimeUnit::SECONDS);
-        static const int SECONDS_PER_HOUR = TimeUnit::convert(1, TimeUnit::HOURS, TimeUnit::SECONDS);
-        static const int SECONDS_PER_MINUTE = TimeUnit::convert(1, TimeUnit::MINUTES, TimeUnit::SECONDS);
-
-        double remainingSeconds = timeInSeconds;
-
-        int days = (int)(remainingSeconds / SECONDS_PER_DAY);
-        remainingSeconds -= days * SECONDS_PER_DAY;
-
-        int hours = (int)(remainingSeconds / SECONDS_PER_HOUR);
-        remainingSeconds -= hours * SECONDS_PER_HOUR;
-
-        int minutes = (int)(remainingSeconds / SECONDS_PER_MINUTE);
-        remainingSeconds -= minutes * SECONDS_PER_MINUTE;
-
-        QStringList fragments;
-        if (days) fragments.append(QString("%1 d").arg(days));
-        if (hours) fragments.append(QString("%1 h").arg(hours));
-        if (minutes) fragments.append(QString("%1 m").arg(minutes));
-        if (remainingSeconds) fragments.append(QString("%1 s").arg(remainingSeconds));
-
-        return fragments.join(' ');
-    }
 }
 
 void SimplifiedStraightJourneySolutionWidget::updateDisplayedPage() {
@@ -87,12 +71,8 @@ void SimplifiedStraightJourneySolutionWidget::updatePlanetSelectOptions() {
     ui->fromPlanetSelect->clear();
     ui->toPlanetSelect->clear();
 
-    for (int i = 0; i < planets->length(); ++i) {
-        const Planet& planet = (*planets)[i];
-
-        ui->fromPlanetSelect->addItem(planet.getName());
-        ui->toPlanetSelect->addItem(planet.getName());
-    }
+    ui->fromPlanetSelect->addItems(planets->names());
+    ui->toPlanetSelect->addItems(planets->names());
 
     // Try to reinstate old options
     // If not found, Qt will just ignore us since the QComboBox is not editable
@@ -107,6 +87,7 @@ void SimplifiedStraightJourneySolutionWidget::updateResultsDisplay() {
 
     // First, check whether we can compute at all and warn user if not.
     ui->resultsStackedWidget->setCurrentIndex(0); // Assume error, put back once we're sure all is good
+    ui->monteCarloReportLabel->hide(); // Stale now, until run again
 
     if (fromPlanetName.isEmpty() || toPlanetName.isEmpty()) {
         ui->resultsIssueLabel->setText(NO_PLANETS_SELECTED);
@@ -122,33 +103,28 @@ void SimplifiedStraightJourneySolutionWidget::updateResultsDisplay() {
     }
 
     // Get selected planets
-    // Can't use const Planet& references unitialized, annoyingly
-    const Planet* fromPlanet = nullptr;
-    const Planet* toPlanet = nullptr;
-    for (int i = 0; i < planets->length(); ++i) {
-        const Planet& planet = (*planets)[i];
-
-        if (planet.getName() == fromPlanetName) fromPlanet = &planet;
-        if (planet.getName() == toPlanetName) toPlanet = &planet;
-    }
+    const std::optional<qsizetype> fromPlanetIndex = planets->indexOf(fromPlanetName);
+    const std::optional<qsizetype> toPlanetIndex = planets->indexOf(toPlanetName);
 
     // Continue checks and warn user of issues
-    if (nullptr == fromPlanet || nullptr == toPlanet) {
+    if (!fromPlanetIndex.has_value() || !toPlanetIndex.has_value()) {
         // This should be impossible given how we populate the QComboBox
         // But we'll check, just in case
         QStringList invalidPlanets;
-        if (nullptr == fromPlanet) invalidPlanets.append(fromPlanetName);
-        if (nullptr == toPlanet) invalidPlanets.append(toPlanetName);
+        if (!fromPlanetIndex.has_value()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanetIndex.has_value()) invalidPlanets.append(toPlanetName);
 
         QString invalidPlanetNames = invalidPlanets.join(", ");
         ui->resultsIssueLabel->setText(QString(INVALID_PLANET).arg(invalidPlanetNames));
 
         return;
     }
-    if (!fromPlanet->hasOrbitalData() || !toPlanet->hasOrbitalData()) {
+    const Planet fromPlanet = planets->at(fromPlanetIndex.value());
+    const Planet toPlanet = planets->at(toPlanetIndex.value());
+    if (!fromPlanet.hasOrbitalData() || !toPlanet.hasOrbitalData()) {
         QStringList invalidPlanets;
-        if (!fromPlanet->hasOrbitalData()) invalidPlanets.append(fromPlanetName);
-        if (!toPlanet->hasOrbitalData()) invalidPlanets.append(toPlanetName);
+        if (!fromPlanet.hasOrbitalData()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanet.hasOrbitalData()) invalidPlanets.append(toPlanetName);
 
         QString invalidPlanetNames = invalidPlanets.join(", ");
         ui->resultsIssueLabel->setText(QString(NO_ORBITAL_DATA).arg(invalidPlanetNames));
@@ -161,8 +137,39 @@ void SimplifiedStraightJourneySolutionWidget::updateResultsDisplay() {
 
     // Compute all the needed values
     // Work with all values in SI, convert to desired units at the end
-    OrbitalMath::TransferResults transferResults = OrbitalMath::computeSimpleTransfer(*fromPlanet, *toPlanet, *rocket);
-    double closestDistanceBetweenPlanetsInAU = OrbitalMath::shortestDistance(*fromPlanet, *toPlanet);
+    // With realistic gravity, also time the simplified model, to compare costs
+    // (integrating every time, as a phase reused from an earlier update costs nothing)
+    const bool realisticGravity = ui->realisticGravityCheckBox->isChecked();
+    OrbitalMath::GravityIntegrationSettings gravitySettings;
+    gravitySettings.reuseRecentPhases = false;
+    QElapsedTimer timer;
+    timer.start();
+    OrbitalMath::TransferResults transferResults = OrbitalMath::computeSimpleTransfer(
+        fromPlanet, toPlanet, *rocket, 0, 0, Days(0), realisticGravity, gravitySettings
+        );
+    const qint64 realisticTime = timer.nsecsElapsed();
+    double closestDistanceBetweenPlanetsInAU = OrbitalMath::shortestDistance(fromPlanet, toPlanet);
+
+    if (realisticGravity) {
+        timer.restart();
+        OrbitalMath::computeSimpleTransfer(fromPlanet, toPlanet, *rocket);
+        const qint64 simplifiedTime = std::max<qint64>(timer.nsecsElapsed(), 1);
+
+        const OrbitalMath::GravityIntegrationReport& report = transferResults.gravityIntegration;
+        QString newReportText = gravityReportTemplate; // Make a copy
+        newReportText
+            .replace("{launchSteps}", QString::number(report.launchSteps))
+            .replace("{launchFarField}", report.launchReachedFarField ? " (then far field)" : "")
+            .replace("{landingSteps}", QString::number(report.landingSteps))
+            .replace("{landingFarField}", report.landingReachedFarField ? " (then far field)" : "")
+            .replace("{rejectedSteps}", QString::number(report.rejectedSteps))
+            .replace("{integrationTime}", QString::number(report.integrationTime * 1e6)) // s to µs
+            .replace("{realisticTime}", QString::number(realisticTime / 1e3)) // ns to µs
+            .replace("{simplifiedTime}", QString::number(simplifiedTime / 1e3))
+            .replace("{costRatio}", QString::number(double(realisticTime) / simplifiedTime, 'f', 1));
+        ui->gravityReportLabel->setText(newReportText);
+    }
+    ui->gravityReportLabel->setVisible(realisticGravity);
 
     // Then insert into UI
     QString newResultsText = textDisplayTemplate; // Make a copy
@@ -170,22 +177,22 @@ void SimplifiedStraightJourneySolutionWidget::updateResultsDisplay() {
         .replace("{fromPlanet}", fromPlanetName)
         .replace("{toPlanet}", toPlanetName)
         .replace("{closestDistance}", QString::number(closestDistanceBetweenPlanetsInAU))
-        .replace("{cruisingVelocityM/S}", QString::number(transferResults.cruisingVelocity))
+        .replace("{cruisingVelocityM/S}", QString::number(transferResults.cruisingVelocity.value()))
         .replace("{cruisingVelocityKm/S}", QString::number(
-            SpeedUnit::convert(transferResults.cruisingVelocity, SpeedUnit::METRES_PER_SECOND, SpeedUnit::KILOMETRES_PER_SECOND)
+            SpeedUnit::convert(transferResults.cruisingVelocity.value(), SpeedUnit::METRES_PER_SECOND, SpeedUnit::KILOMETRES_PER_SECOND)
         ))
-        .replace("{accelerationTime}", QString::number(transferResults.accelerationTime))
+        .replace("{accelerationTime}", QString::number(transferResults.accelerationTime.value()))
         .replace("{accelerationDistance}", QString::number(
-            DistanceUnit::convert(transferResults.accelerationDistance, DistanceUnit::METRES, DistanceUnit::KILOMETRES)
+            DistanceUnit::convert(transferResults.accelerationDistance.value(), DistanceUnit::METRES, DistanceUnit::KILOMETRES)
         ))
-        .replace("{cruisingTime}", QString::number(transferResults.cruisingTime))
-        .replace("{cruisingTimeFormatted}", formatTime(transferResults.cruisingTime))
+        .replace("{cruisingTime}", QString::number(transferResults.cruisingTime.value()))
+        .replace("{cruisingTimeFormatted}", DialogUtils::formatTime(transferResults.cruisingTime.value()))
         .replace("{decelerationDistance}", QString::number(
-            DistanceUnit::convert(transferResults.decelerationDistance, DistanceUnit::METRES, DistanceUnit::KILOMETRES)
+            DistanceUnit::convert(transferResults.decelerationDistance.value(), DistanceUnit::METRES, DistanceUnit::KILOMETRES)
         ))
-        .replace("{decelerationTime}", QString::number(transferResults.decelerationTime))
-        .replace("{totalJourneyTime}", QString::number(transferResults.totalTravelTime))
-        .replace("{totalJourneyTimeFormatted}", formatTime(transferResults.totalTravelTime));
+        .replace("{decelerationTime}", QString::number(transferResults.decelerationTime.value()))
+        .replace("{totalJourneyTime}", QString::number(transferResults.totalTravelTime.value()))
+        .replace("{totalJourneyTimeFormatted}", DialogUtils::formatTime(transferResults.totalTravelTime.value()));
     // Note: the above is probably quite inefficient
     // We could make this more efficient by:
     // 1. assembling the string out of parts rather than replacing parts
@@ -207,3 +214,60 @@ void SimplifiedStraightJourneySolutionWidget::on_toPlanetSelect_currentTextChang
     updateResultsDisplay();
 }
 
+void SimplifiedStraightJourneySolutionWidget::on_realisticGravityCheckBox_toggled(bool checked)
+{
+    // The Monte Carlo samples go through the simplified model only
+    ui->monteCarloButton->setEnabled(!checked);
+
+    updateResultsDisplay();
+}
+
+void SimplifiedStraightJourneySolutionWidget::on_monteCarloButton_clicked()
+{
+    // Only run for transfers whose results are displayed, i.e. that passed all checks
+    if (1 != ui->resultsStackedWidget->currentIndex()) return;
+
+    const Planet fromPlanet = planets->at(planets->indexOf(ui->fromPlanetSelect->currentText()).value());
+    const Planet toPlanet = planets->at(planets->indexOf(ui->toPlanetSelect->currentText()).value());
+
+    MonteCarlo::Tolerances tolerances;
+    tolerances.rocketAcceleration = ui->accelerationToleranceSpinBox->value() / 100; // % to fraction
+    tolerances.fromMass = ui->massToleranceSpinBox->value() / 100;
+    tolerances.toMass = tolerances.fromMass;
+    const qint64 sampleCount = ui->sampleCountSpinBox->value();
+
+    // Same positions as the nominal results
+    QApplication::setOverrideCursor(Qt::WaitCursor);
+    QElapsedTimer timer;
+    timer.start();
+    const MonteCarlo::TransferDistribution distribution = MonteCarlo::simulateTransfer(
+        fromPlanet, toPlanet, *rocket, tolerances, sampleCount, 0, 0, Days(0)
+        );
+    const qint64 computationTime = timer.elapsed();
+    QApplication::restoreOverrideCursor();
+
+    const QuantileSketch& cruisingVelocities = distribution.cruisingVelocities;
+    const QuantileSketch& accelerationTimes = distribution.accelerationTimes;
+    const QuantileSketch& totalTravelTimes = distribution.totalTravelTimes;
+
+    QString newReportText = monteCarloReportTemplate; // Make a copy
+    newReportText
+        .replace("{sampleCount}", QString::number(distribution.sampleCount))
+        .replace("{accelerationTolerance}", QString::number(ui->accelerationToleranceSpinBox->value()))
+        .replace("{massTolerance}", QString::number(ui->massToleranceSpinBox->value()))
+        .replace("{computationTime}", QString::number(computationTime))
+        .replace("{cruisingVelocityP5}", QString::number(cruisingVelocities.quantile(0.05)))
+        .replace("{cruisingVelocityP50}", QString::number(cruisingVelocities.quantile(0.5)))
+        .replace("{cruisingVelocityP95}", QString::number(cruisingVelocities.quantile(0.95)))
+        .replace("{accelerationTimeP5}", QString::number(accelerationTimes.quantile(0.05)))
+        .replace("{accelerationTimeP50}", QString::number(accelerationTimes.quantile(0.5)))
+        .replace("{accelerationTimeP95}", QString::number(accelerationTimes.quantile(0.95)))
+        .replace("{totalJourneyTimeP5}", QString::number(totalTravelTimes.quantile(0.05)))
+        .replace("{totalJourneyTimeP50}", QString::number(totalTravelTimes.quantile(0.5)))
+        .replace("{totalJourneyTimeP95}", QString::number(totalTravelTimes.quantile(0.95)))
+        .replace("{totalJourneyTimeP5Formatted}", DialogUtils::formatTime(totalTravelTimes.quantile(0.05)))
+        .replace("{totalJourneyTimeP95Formatted}", DialogUtils::formatTime(totalTravelTimes.quantile(0.95)))
+        .replace("{totalJourneyTimeMeanFormatted}", DialogUtils::formatTime(totalTravelTimes.mean()));
+    ui->monteCarloReportLabel->setText(newReportText);
+    ui->monteCarloReportLabel->show();
+}
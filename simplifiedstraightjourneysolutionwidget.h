@@ -3,7 +3,7 @@
 
 #include <QWidget>
 
-#include "planet.h"
+#include "solarsystem.h"
 #include "rocket.h"
 
 namespace Ui {
@@ -19,18 +19,22 @@ public:
     ~SimplifiedStraightJourneySolutionWidget();
 
 public slots:
-    void setPlanets(const QList<Planet>& newPlanets);
+    void setPlanets(const SolarSystem& newPlanets);
     void setRocket(const Rocket* newRocket);
 
 private slots:
     void on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName);
     void on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName);
+    void on_realisticGravityCheckBox_toggled(bool checked);
+    void on_monteCarloButton_clicked();
 
 private:
     Ui::SimplifiedStraightJourneySolutionWidget *ui;
-    const QList<Planet>* planets;
+    const SolarSystem* planets;
     const Rocket* rocket;
     QString textDisplayTemplate;
+    QString gravityReportTemplate;
+    QString monteCarloReportTemplate;
 
     void updateDisplayedPage();
     void updatePlanetSelectOptions();
@@ -0,0 +1,421 @@
+#include "solarsystem.h"
+
+#include <QHash>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <vector>
+
+namespace {
+    constexpr qsizetype BITS_PER_MASK_WORD = 64;
+
+    void setMaskBit(std::vector<quint64>& mask, qsizetype index, bool value) {
+        const quint64 bit = quint64(1) << (index % BITS_PER_MASK_WORD);
+        if (value) mask[index / BITS_PER_MASK_WORD] |= bit;
+        else mask[index / BITS_PER_MASK_WORD] &= ~bit;
+    }
+}
+
+bool PlanetChangeSet::empty() const {
+    return removed.empty() && modified.empty() && added.empty();
+}
+
+qsizetype OrbitalDataColumns::size() const {
+    return names.size();
+}
+
+bool OrbitalDataColumns::empty() const {
+    return names.empty();
+}
+
+void OrbitalDataColumns::reserve(qsizetype capacity) {
+    names.reserve(capacity);
+    orbitalPeriodsInDays.reserve(capacity);
+    orbitalRadiiInAU.reserve(capacity);
+    eccentricities.reserve(capacity);
+    argumentsOfPeriapsisInDegrees.reserve(capacity);
+    epochsInDays.reserve(capacity);
+}
+
+void OrbitalDataColumns::append(
+    const QString& name, double orbitalPeriodInDays, double orbitalRadiusInAU,
+    double eccentricity, double argumentOfPeriapsisInDegrees, double epochInDays
+    ) {
+    names.append(name);
+    orbitalPeriodsInDays.push_back(orbitalPeriodInDays);
+    orbitalRadiiInAU.push_back(orbitalRadiusInAU);
+    eccentricities.push_back(eccentricity);
+    argumentsOfPeriapsisInDegrees.push_back(argumentOfPeriapsisInDegrees);
+    epochsInDays.push_back(epochInDays);
+}
+
+qsizetype SolarSystem::size() const {
+    return planetNames.size();
+}
+
+bool SolarSystem::empty() const {
+    return planetNames.empty();
+}
+
+void SolarSystem::clear() {
+    planetNames.clear();
+    planetMassesInKilograms.clear();
+    planetRadiiInMetres.clear();
+    planetOrbitalPeriodsInDays.clear();
+    planetOrbitalRadiiInAU.clear();
+    planetEccentricities.clear();
+    planetArgumentsOfPeriapsisInDegrees.clear();
+    planetEpochsInDays.clear();
+    orbitalDataMask.clear();
+    orbitalRadiusIndexUpToDate = false;
+    alignmentCacheUpToDate = false;
+    ephemerisCacheUpToDate = false;
+    positionSource.reset();
+}
+
+void SolarSystem::reserve(qsizetype capacity) {
+    planetNames.reserve(capacity);
+    planetMassesInKilograms.reserve(capacity);
+    planetRadiiInMetres.reserve(capacity);
+    planetOrbitalPeriodsInDays.reserve(capacity);
+    planetOrbitalRadiiInAU.reserve(capacity);
+    planetEccentricities.reserve(capacity);
+    planetArgumentsOfPeriapsisInDegrees.reserve(capacity);
+    planetEpochsInDays.reserve(capacity);
+    orbitalDataMask.reserve((capacity + BITS_PER_MASK_WORD - 1) / BITS_PER_MASK_WORD);
+}
+
+qsizetype SolarSystem::addPlanet(const QString& name, double massInKilograms, double radiusInMetres) {
+    const qsizetype index = size();
+
+    planetNames.append(name);
+    planetMassesInKilograms.push_back(massInKilograms);
+    planetRadiiInMetres.push_back(radiusInMetres);
+    planetOrbitalPeriodsInDays.push_back(NAN);
+    planetOrbitalRadiiInAU.push_back(NAN);
+    planetEccentricities.push_back(NAN);
+    planetArgumentsOfPeriapsisInDegrees.push_back(NAN);
+    planetEpochsInDays.push_back(NAN);
+
+    // Start a new mask word if needed (new bits start out cleared)
+    if (index % BITS_PER_MASK_WORD == 0) orbitalDataMask.push_back(0);
+
+    orbitalRadiusIndexUpToDate = false;
+    alignmentCacheUpToDate = false;
+    ephemerisCacheUpToDate = false;
+    positionSource.reset();
+
+    return index;
+}
+
+void SolarSystem::appendPlanets(QStringList names, std::span<const double> massesInKilograms, std::span<const double> radiiInMetres) {
+    const qsizetype newSize = size() + names.size();
+
+    planetNames.append(std::move(names));
+    planetMassesInKilograms.insert(planetMassesInKilograms.end(), massesInKilograms.begin(), massesInKilograms.end());
+    planetRadiiInMetres.insert(planetRadiiInMetres.end(), radiiInMetres.begin(), radiiInMetres.end());
+    planetOrbitalPeriodsInDays.resize(newSize, NAN);
+    planetOrbitalRadiiInAU.resize(newSize, NAN);
+    planetEccentricities.resize(newSize, NAN);
+    planetArgumentsOfPeriapsisInDegrees.resize(newSize, NAN);
+    planetEpochsInDays.resize(newSize, NAN);
+
+    // New bits start out cleared
+    orbitalDataMask.resize((newSize + BITS_PER_MASK_WORD - 1) / BITS_PER_MASK_WORD, 0);
+
+    orbitalRadiusIndexUpToDate = false;
+    alignmentCacheUpToDate = false;
+    ephemerisCacheUpToDate = false;
+    positionSource.reset();
+}
+
+void SolarSystem::setOrbitalCharacteristics(
+    qsizetype index, double orbitalPeriodInDays, double orbitalRadiusInAU,
+    double eccentricity, double argumentOfPeriapsisInDegrees, double epochInDays
+    ) {
+    planetOrbitalPeriodsInDays[index] = orbitalPeriodInDays;
+    planetOrbitalRadiiInAU[index] = orbitalRadiusInAU;
+    planetEccentricities[index] = eccentricity;
+    planetArgumentsOfPeriapsisInDegrees[index] = argumentOfPeriapsisInDegrees;
+    planetEpochsInDays[index] = epochInDays;
+    orbitalDataMask[index / BITS_PER_MASK_WORD] |= quint64(1) << (index % BITS_PER_MASK_WORD);
+    orbitalRadiusIndexUpToDate = false;
+    alignmentCacheUpToDate = false;
+    ephemerisCacheUpToDate = false;
+    positionSource.reset();
+}
+
+void SolarSystem::setOrbitalCharacteristics(const OrbitalDataColumns& orbits, std::span<const qsizetype> planetIndices) {
+    bool entriesArePlanets = !empty() && qsizetype(planetIndices.size()) == size();
+    for (qsizetype j = 0; entriesArePlanets && j < size(); ++j) entriesArePlanets = planetIndices[j] == j;
+
+    if (entriesArePlanets) {
+        const std::size_t columnSize = size() * sizeof(double);
+        std::memcpy(planetOrbitalPeriodsInDays.data(), orbits.orbitalPeriodsInDays.data(), columnSize);
+        std::memcpy(planetOrbitalRadiiInAU.data(), orbits.orbitalRadiiInAU.data(), columnSize);
+        std::memcpy(planetEccentricities.data(), orbits.eccentricities.data(), columnSize);
+        std::memcpy(planetArgumentsOfPeriapsisInDegrees.data(), orbits.argumentsOfPeriapsisInDegrees.data(), columnSize);
+        std::memcpy(planetEpochsInDays.data(), orbits.epochsInDays.data(), columnSize);
+
+        // Every planet has orbital data, and the bits past the end stay cleared
+        std::fill(orbitalDataMask.begin(), orbitalDataMask.end(), ~quint64(0));
+        if (size() % BITS_PER_MASK_WORD != 0) {
+            orbitalDataMask.back() = (quint64(1) << (size() % BITS_PER_MASK_WORD)) - 1;
+        }
+    }
+    else {
+        for (qsizetype j = 0; j < qsizetype(planetIndices.size()); ++j) {
+            const qsizetype index = planetIndices[j];
+            if (-1 == index) continue;
+
+            planetOrbitalPeriodsInDays[index] = orbits.orbitalPeriodsInDays[j];
+            planetOrbitalRadiiInAU[index] = orbits.orbitalRadiiInAU[j];
+            planetEccentricities[index] = orbits.eccentricities[j];
+            planetArgumentsOfPeriapsisInDegrees[index] = orbits.argumentsOfPeriapsisInDegrees[j];
+            planetEpochsInDays[index] = orbits.epochsInDays[j];
+            setMaskBit(orbitalDataMask, index, true);
+        }
+    }
+
+    orbitalRadiusIndexUpToDate = false;
+    alignmentCacheUpToDate = false;
+    ephemerisCacheUpToDate = false;
+    positionSource.reset();
+}
+
+PlanetChangeSet SolarSystem::merge(const SolarSystem& newPlanets) {
+    // Index new planets by name. Planets sharing a name are chained in order,
+    // so each planet here takes the first new planet with its name that an
+    // earlier planet of the same name has not already taken
+    QHash<QString, qsizetype> firstUnmatchedPlanet;
+    firstUnmatchedPlanet.reserve(newPlanets.size());
+    std::vector<qsizetype> nextPlanetWithSameName(newPlanets.size(), -1);
+    for (qsizetype j = newPlanets.size() - 1; j >= 0; --j) {
+        const auto existingPlanet = firstUnmatchedPlanet.constFind(newPlanets.getName(j));
+        if (existingPlanet != firstUnmatchedPlanet.constEnd()) nextPlanetWithSameName[j] = existingPlanet.value();
+        firstUnmatchedPlanet.insert(newPlanets.getName(j), j);
+    }
+
+    // Update matched planets in place, noting those that went away
+    PlanetChangeSet changes;
+    std::vector<bool> planetMatched(newPlanets.size(), false);
+    for (qsizetype i = 0; i < size(); ++i) {
+        const auto matchingPlanet = firstUnmatchedPlanet.find(planetNames[i]);
+        if (matchingPlanet == firstUnmatchedPlanet.end() || -1 == matchingPlanet.value()) {
+            changes.removed.append(i);
+            continue;
+        }
+
+        const qsizetype indexFound = matchingPlanet.value();
+        if (!samePlanet(i, newPlanets, indexFound)) {
+            copyPlanet(i, newPlanets, indexFound);
+            // Where the planet ends up once the removed ones before it are gone
+            changes.modified.append(i - changes.removed.size());
+        }
+
+        planetMatched[indexFound] = true;
+        matchingPlanet.value() = nextPlanetWithSameName[indexFound];
+    }
+
+    if (!changes.removed.empty()) removePlanets(changes.removed);
+
+    // Add the planets that are new, in order
+    for (qsizetype j = 0; j < newPlanets.size(); ++j) {
+        if (planetMatched[j]) continue;
+
+        const qsizetype index = addPlanet(newPlanets.getName(j), newPlanets.getMassInKilograms(j), newPlanets.getRadiusInMetres(j));
+        if (newPlanets.hasOrbitalData(j)) copyPlanet(index, newPlanets, j);
+        changes.added.append(index);
+    }
+
+    if (!changes.empty()) {
+        orbitalRadiusIndexUpToDate = false;
+        alignmentCacheUpToDate = false;
+        ephemerisCacheUpToDate = false;
+        positionSource.reset();
+    }
+    return changes;
+}
+
+bool SolarSystem::samePlanet(qsizetype index, const SolarSystem& other, qsizetype otherIndex) const {
+    if (planetMassesInKilograms[index] != other.planetMassesInKilograms[otherIndex]
+        || planetRadiiInMetres[index] != other.planetRadiiInMetres[otherIndex]
+        || hasOrbitalData(index) != other.hasOrbitalData(otherIndex)) {
+        return false;
+    }
+    if (!hasOrbitalData(index)) return true;
+
+    return planetOrbitalPeriodsInDays[index] == other.planetOrbitalPeriodsInDays[otherIndex]
+           && planetOrbitalRadiiInAU[index] == other.planetOrbitalRadiiInAU[otherIndex]
+           && planetEccentricities[index] == other.planetEccentricities[otherIndex]
+           && planetArgumentsOfPeriapsisInDegrees[index] == other.planetArgumentsOfPeriapsisInDegrees[otherIndex]
+           && planetEpochsInDays[index] == other.planetEpochsInDays[otherIndex];
+}
+
+void SolarSystem::copyPlanet(qsizetype index, const SolarSystem& source, qsizetype sourceIndex) {
+    // Names are left alone, as planets are only ever copied onto planets of the same name
+    planetMassesInKilograms[index] = source.planetMassesInKilograms[sourceIndex];
+    planetRadiiInMetres[index] = source.planetRadiiInMetres[sourceIndex];
+    planetOrbitalPeriodsInDays[index] = source.planetOrbitalPeriodsInDays[sourceIndex];
+    planetOrbitalRadiiInAU[index] = source.planetOrbitalRadiiInAU[sourceIndex];
+    planetEccentricities[index] = source.planetEccentricities[sourceIndex];
+    planetArgumentsOfPeriapsisInDegrees[index] = source.planetArgumentsOfPeriapsisInDegrees[sourceIndex];
+    planetEpochsInDays[index] = source.planetEpochsInDays[sourceIndex];
+    setMaskBit(orbitalDataMask, index, source.hasOrbitalData(sourceIndex));
+}
+
+void SolarSystem::removePlanets(const QList<qsizetype>& indices) {
+    // Slide the remaining planets down over the removed ones, in a single pass
+    qsizetype keptCount = 0;
+    qsizetype nextRemoved = 0;
+    for (qsizetype i = 0; i < size(); ++i) {
+        if (nextRemoved < indices.size() && indices[nextRemoved] == i) {
+            ++nextRemoved;
+            continue;
+        }
+
+        if (keptCount != i) {
+            planetNames[keptCount] = std::move(planetNames[i]);
+            copyPlanet(keptCount, *this, i);
+        }
+        ++keptCount;
+    }
+
+    planetNames.resize(keptCount);
+    planetMassesInKilograms.resize(keptCount);
+    planetRadiiInMetres.resize(keptCount);
+    planetOrbitalPeriodsInDays.resize(keptCount);
+    planetOrbitalRadiiInAU.resize(keptCount);
+    planetEccentricities.resize(keptCount);
+    planetArgumentsOfPeriapsisInDegrees.resize(keptCount);
+    planetEpochsInDays.resize(keptCount);
+
+    // Drop the mask words no longer needed, and clear the bits past the end (new bits must start out cleared)
+    orbitalDataMask.resize((keptCount + BITS_PER_MASK_WORD - 1) / BITS_PER_MASK_WORD);
+    if (keptCount % BITS_PER_MASK_WORD != 0) {
+        orbitalDataMask.back() &= (quint64(1) << (keptCount % BITS_PER_MASK_WORD)) - 1;
+    }
+}
+
+Planet SolarSystem::at(qsizetype index) const {
+    return Planet(*this, index);
+}
+
+Planet SolarSystem::operator[](qsizetype index) const {
+    return Planet(*this, index);
+}
+
+std::optional<qsizetype> SolarSystem::indexOf(const QString& name) const {
+    const qsizetype index = planetNames.indexOf(name);
+    if (-1 == index) return std::nullopt;
+    return index;
+}
+
+const QString& SolarSystem::getName(qsizetype index) const {
+    return planetNames[index];
+}
+
+double SolarSystem::getMassInKilograms(qsizetype index) const {
+    return planetMassesInKilograms[index];
+}
+
+double SolarSystem::getRadiusInMetres(qsizetype index) const {
+    return planetRadiiInMetres[index];
+}
+
+std::optional<double> SolarSystem::getOrbitalPeriodInDays(qsizetype index) const {
+    if (!hasOrbitalData(index)) return std::nullopt;
+    return planetOrbitalPeriodsInDays[index];
+}
+
+std::optional<double> SolarSystem::getOrbitalRadiusInAU(qsizetype index) const {
+    if (!hasOrbitalData(index)) return std::nullopt;
+    return planetOrbitalRadiiInAU[index];
+}
+
+std::optional<double> SolarSystem::getEccentricity(qsizetype index) const {
+    if (!hasOrbitalData(index)) return std::nullopt;
+    return planetEccentricities[index];
+}
+
+std::optional<double> SolarSystem::getArgumentOfPeriapsisInDegrees(qsizetype index) const {
+    if (!hasOrbitalData(index)) return std::nullopt;
+    return planetArgumentsOfPeriapsisInDegrees[index];
+}
+
+std::optional<double> SolarSystem::getEpochInDays(qsizetype index) const {
+    if (!hasOrbitalData(index)) return std::nullopt;
+    return planetEpochsInDays[index];
+}
+
+bool SolarSystem::hasOrbitalData(qsizetype index) const {
+    return orbitalDataMask[index / BITS_PER_MASK_WORD] & (quint64(1) << (index % BITS_PER_MASK_WORD));
+}
+
+const QStringList& SolarSystem::names() const {
+    return planetNames;
+}
+
+std::span<const double> SolarSystem::massesInKilograms() const {
+    return planetMassesInKilograms;
+}
+
+std::span<const double> SolarSystem::radiiInMetres() const {
+    return planetRadiiInMetres;
+}
+
+std::span<const double> SolarSystem::orbitalPeriodsInDays() const {
+    return planetOrbitalPeriodsInDays;
+}
+
+std::span<const double> SolarSystem::orbitalRadiiInAU() const {
+    return planetOrbitalRadiiInAU;
+}
+
+std::span<const double> SolarSystem::eccentricities() const {
+    return planetEccentricities;
+}
+
+std::span<const double> SolarSystem::argumentsOfPeriapsisInDegrees() const {
+    return planetArgumentsOfPeriapsisInDegrees;
+}
+
+std::span<const double> SolarSystem::epochsInDays() const {
+    return planetEpochsInDays;
+}
+
+void SolarSystem::buildOrbitalRadiusIndex() {
+    orbitalRadiusIndex = OrbitalRadiusIndex(*this);
+    orbitalRadiusIndexUpToDate = true;
+}
+
+const OrbitalRadiusIndex* SolarSystem::getOrbitalRadiusIndex() const {
+    return orbitalRadiusIndexUpToDate ? &orbitalRadiusIndex : nullptr;
+}
+
+void SolarSystem::updateAlignmentCache() {
+    alignmentCacheUpToDate = alignmentCache.update(*this);
+}
+
+const AlignmentCache* SolarSystem::getAlignmentCache() const {
+    return alignmentCacheUpToDate ? &alignmentCache : nullptr;
+}
+
+void SolarSystem::buildEphemerisCache(double startDay, double endDay, double toleranceInAU) {
+    ephemerisCache.reset(size(), startDay, endDay, toleranceInAU);
+    ephemerisCacheUpToDate = true;
+}
+
+const EphemerisCache* SolarSystem::getEphemerisCache() const {
+    return ephemerisCacheUpToDate ? &ephemerisCache : nullptr;
+}
+
+void SolarSystem::setPositionSource(std::shared_ptr<const PositionSource> source) {
+    positionSource = std::move(source);
+}
+
+const PositionSource* SolarSystem::getPositionSource() const {
+    return positionSource.get();
+}
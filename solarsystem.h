@@ -0,0 +1,247 @@
+#ifndef SOLARSYSTEM_H
+#define SOLARSYSTEM_H
+
+#include "alignedvector.h"
+#include "alignmentcache.h"
+#include "ephemeriscache.h"
+#include "orbitalradiusindex.h"
+#include "planet.h"
+#include "positionsource.h"
+
+#include <QStringList>
+
+#include <memory>
+#include <optional>
+#include <span>
+
+/**
+ * What changed when a solar system was brought up to date with a new
+ * version of its catalog (see `SolarSystem::merge`). All lists are in
+ * ascending order.
+ */
+struct PlanetChangeSet {
+    QList<qsizetype> removed;  // Indices from before the change
+    QList<qsizetype> modified; // Indices from after the change
+    QList<qsizetype> added;    // Indices from after the change (all at the end)
+
+    bool empty() const;
+};
+
+/**
+ * Orbits of a number of planets, not yet given to any, column-wise and in
+ * the units `SolarSystem` holds them in (days, AU and degrees). Each entry
+ * names the planet it is meant for.
+ */
+struct OrbitalDataColumns {
+    QStringList names;
+    AlignedVector<double> orbitalPeriodsInDays;
+    AlignedVector<double> orbitalRadiiInAU;
+    AlignedVector<double> eccentricities;
+    AlignedVector<double> argumentsOfPeriapsisInDegrees;
+    AlignedVector<double> epochsInDays;
+
+    qsizetype size() const;
+    bool empty() const;
+    void reserve(qsizetype capacity);
+
+    void append(
+        const QString& name,
+        double orbitalPeriodInDays,
+        double orbitalRadiusInAU,
+        double eccentricity,
+        double argumentOfPeriapsisInDegrees,
+        double epochInDays
+        );
+};
+
+/**
+ * Container for all the planets of a loaded catalog.
+ *
+ * Planet characteristics are stored column-wise (one contiguous,
+ * cache-line-aligned array per characteristic) rather than as a list
+ * of `Planet` objects, so that the math in `OrbitalMath` can sweep
+ * over a single characteristic of many planets without dragging the
+ * others (or the names) through the cache. Names live in a separate
+ * table, and a bitmask records which planets have orbital data.
+ *
+ * Individual planets can still be accessed as `Planet` objects, which
+ * are lightweight views into the solar system.
+ */
+class SolarSystem
+{
+public:
+    SolarSystem() = default;
+
+    qsizetype size() const;
+    bool empty() const;
+    void clear();
+    void reserve(qsizetype capacity);
+
+    /**
+     * Adds a planet (without orbital data) at the end of the
+     * solar system and returns its index.
+     */
+    qsizetype addPlanet(const QString& name, double massInKilograms, double radiusInMetres);
+
+    /**
+     * Adds planets (without orbital data) at the end of the solar system,
+     * one per name, with the masses and radii at the same positions in the
+     * given columns. The columns are copied over whole rather than planet
+     * by planet.
+     */
+    void appendPlanets(QStringList names, std::span<const double> massesInKilograms, std::span<const double> radiiInMetres);
+
+    /**
+     * Sets a planet's orbit. The orbital radius is the semi-major axis of
+     * the orbit; the other elements describe its shape and timing:
+     * - eccentricity, in [0, 1) (0 for a circle)
+     * - argument of periapsis: angular position (in degrees) of the point
+     * of the orbit closest to the sun
+     * - epoch: moment (in days from time 0) at which the planet passes its
+     * periapsis
+     *
+     * With the defaults, the orbit is a circle and the planet is at
+     * angular position 0° at time 0.
+     */
+    void setOrbitalCharacteristics(
+        qsizetype index,
+        double orbitalPeriodInDays,
+        double orbitalRadiusInAU,
+        double eccentricity = 0,
+        double argumentOfPeriapsisInDegrees = 0,
+        double epochInDays = 0
+        );
+
+    /**
+     * Sets the orbits of many planets at once: entry `j` of `orbits` becomes
+     * the orbit of planet `planetIndices[j]`, unless that is -1. If the
+     * entries are exactly the planets, in order, the columns are copied over
+     * whole.
+     */
+    void setOrbitalCharacteristics(const OrbitalDataColumns& orbits, std::span<const qsizetype> planetIndices);
+
+    /**
+     * Brings the planets up to date with a new version of the catalog, and
+     * returns what changed. Planets are matched by name (the n-th planet of
+     * a name here with the n-th planet of that name in `newPlanets`):
+     * matched planets keep their place and take on their new
+     * characteristics, unmatched planets are removed, and planets new to
+     * `newPlanets` are added at the end, in order.
+     *
+     * Nothing goes stale if nothing changed; otherwise the orbital radius
+     * index and ephemeris cache go stale and the position source is dropped
+     * as with any other change, and updating the alignment cache only
+     * recomputes the modified planets if none were added or removed.
+     */
+    PlanetChangeSet merge(const SolarSystem& newPlanets);
+
+    Planet at(qsizetype index) const;
+    Planet operator[](qsizetype index) const;
+
+    /**
+     * Returns the index of the first planet with the given name,
+     * if there is any.
+     */
+    std::optional<qsizetype> indexOf(const QString& name) const;
+
+    const QString& getName(qsizetype index) const;
+    double getMassInKilograms(qsizetype index) const;
+    double getRadiusInMetres(qsizetype index) const;
+    std::optional<double> getOrbitalPeriodInDays(qsizetype index) const;
+    std::optional<double> getOrbitalRadiusInAU(qsizetype index) const;
+    std::optional<double> getEccentricity(qsizetype index) const;
+    std::optional<double> getArgumentOfPeriapsisInDegrees(qsizetype index) const;
+    std::optional<double> getEpochInDays(qsizetype index) const;
+    bool hasOrbitalData(qsizetype index) const;
+
+    // Whole-column access, for batched computations.
+    // Orbital columns hold NaN for planets lacking orbital data.
+    const QStringList& names() const;
+    std::span<const double> massesInKilograms() const;
+    std::span<const double> radiiInMetres() const;
+    std::span<const double> orbitalPeriodsInDays() const;
+    std::span<const double> orbitalRadiiInAU() const;
+    std::span<const double> eccentricities() const;
+    std::span<const double> argumentsOfPeriapsisInDegrees() const;
+    std::span<const double> epochsInDays() const;
+
+    /**
+     * Builds the orbital radius index (see `OrbitalRadiusIndex`) for the
+     * current planets. Meant to be called once per catalog load, after
+     * orbital data is loaded; any later change to the planets makes the
+     * index stale until it is built again.
+     */
+    void buildOrbitalRadiusIndex();
+
+    /**
+     * The orbital radius index, or nullptr if it is stale or was never built.
+     */
+    const OrbitalRadiusIndex* getOrbitalRadiusIndex() const;
+
+    /**
+     * Brings the pairwise alignment cache (see `AlignmentCache`) up to date
+     * with the current planets. Only pairs involving planets whose orbital
+     * data changed since the last update are recomputed.
+     */
+    void updateAlignmentCache();
+
+    /**
+     * The alignment cache, or nullptr if it is stale, was never built,
+     * or the solar system is too large to cache.
+     */
+    const AlignmentCache* getAlignmentCache() const;
+
+    /**
+     * Sets up the ephemeris cache (see `EphemerisCache`) for the current
+     * planets, over the days from `startDay` to `endDay`. Planets are only
+     * fitted once their positions are first asked for. Like the orbital
+     * radius index, any later change to the planets makes the cache stale.
+     */
+    void buildEphemerisCache(double startDay, double endDay, double toleranceInAU = EphemerisCache::DEFAULT_TOLERANCE_IN_AU);
+
+    /**
+     * The ephemeris cache, or nullptr if it is stale or was never built.
+     */
+    const EphemerisCache* getEphemerisCache() const;
+
+    /**
+     * Has planet positions taken from the given source (see `PositionSource`)
+     * rather than from the orbital elements, or from the orbital elements
+     * again if nullptr. Like the ephemeris cache, any later change to the
+     * planets drops the source, as it describes the planets from before.
+     */
+    void setPositionSource(std::shared_ptr<const PositionSource> source);
+
+    /**
+     * The position source, or nullptr if positions come from the orbital elements.
+     */
+    const PositionSource* getPositionSource() const;
+
+private:
+    QStringList planetNames;
+    AlignedVector<double> planetMassesInKilograms;
+    AlignedVector<double> planetRadiiInMetres;
+    AlignedVector<double> planetOrbitalPeriodsInDays;
+    AlignedVector<double> planetOrbitalRadiiInAU;
+    AlignedVector<double> planetEccentricities;
+    AlignedVector<double> planetArgumentsOfPeriapsisInDegrees;
+    AlignedVector<double> planetEpochsInDays;
+    std::vector<quint64> orbitalDataMask; // One bit per planet
+
+    OrbitalRadiusIndex orbitalRadiusIndex;
+    bool orbitalRadiusIndexUpToDate = false;
+
+    AlignmentCache alignmentCache;
+    bool alignmentCacheUpToDate = false;
+
+    EphemerisCache ephemerisCache;
+    bool ephemerisCacheUpToDate = false;
+
+    std::shared_ptr<const PositionSource> positionSource; // Shared by copies, as it never changes
+
+    bool samePlanet(qsizetype index, const SolarSystem& other, qsizetype otherIndex) const;
+    void copyPlanet(qsizetype index, const SolarSystem& source, qsizetype sourceIndex);
+    void removePlanets(const QList<qsizetype>& indices);
+};
+
+#endif // SOLARSYSTEM_H
@@ -7,21 +7,72 @@ SolutionWidget::SolutionWidget(QWidget *parent)
 {
     ui->setupUi(this);
 
+    // Tabs with a row per planet only recompute the rows of changed planets when
+    // the planets are updated; the others depend on all planets together, and start over
     connect(this, &SolutionWidget::planetsChanged,
             ui->stageOneTab, &EscapeVelocitiesSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->stageOneTab, &EscapeVelocitiesSolutionWidget::updatePlanets);
 
     connect(this, &SolutionWidget::planetsChanged,
             ui->stageTwoTab, &RocketAccelerationTimeSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->stageTwoTab, &RocketAccelerationTimeSolutionWidget::updatePlanets);
     connect(this, &SolutionWidget::rocketChanged,
             ui->stageTwoTab, &RocketAccelerationTimeSolutionWidget::setRocket);
 
     connect(this, &SolutionWidget::planetsChanged,
             ui->stageThreeTab, &SimplifiedStraightJourneySolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->stageThreeTab, &SimplifiedStraightJourneySolutionWidget::setPlanets);
     connect(this, &SolutionWidget::rocketChanged,
             ui->stageThreeTab, &SimplifiedStraightJourneySolutionWidget::setRocket);
 
     connect(this, &SolutionWidget::planetsChanged,
             ui->stageFourTab, &PlanetRotationSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->stageFourTab, &PlanetRotationSolutionWidget::setPlanets);
+
+    connect(this, &SolutionWidget::planetsChanged,
+            ui->stageFiveTab, &TransferPlanningSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->stageFiveTab, &TransferPlanningSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::rocketChanged,
+            ui->stageFiveTab, &TransferPlanningSolutionWidget::setRocket);
+
+    ui->stageSixTab->setSystemStatic(false);
+    connect(this, &SolutionWidget::planetsChanged,
+            ui->stageSixTab, &TransferPlanningSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->stageSixTab, &TransferPlanningSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::rocketChanged,
+            ui->stageSixTab, &TransferPlanningSolutionWidget::setRocket);
+
+    connect(this, &SolutionWidget::planetsChanged,
+            ui->porkchopTab, &PorkchopSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->porkchopTab, &PorkchopSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::rocketChanged,
+            ui->porkchopTab, &PorkchopSolutionWidget::setRocket);
+
+    connect(this, &SolutionWidget::planetsChanged,
+            ui->transferMatrixTab, &TransferMatrixSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->transferMatrixTab, &TransferMatrixSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::rocketChanged,
+            ui->transferMatrixTab, &TransferMatrixSolutionWidget::setRocket);
+
+    connect(this, &SolutionWidget::planetsChanged,
+            ui->rocketSweepTab, &RocketSweepSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->rocketSweepTab, &RocketSweepSolutionWidget::setPlanets);
+
+    connect(this, &SolutionWidget::planetsChanged,
+            ui->routePlanningTab, &RoutePlanningSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::planetsUpdated,
+            ui->routePlanningTab, &RoutePlanningSolutionWidget::setPlanets);
+    connect(this, &SolutionWidget::rocketChanged,
+            ui->routePlanningTab, &RoutePlanningSolutionWidget::setRocket);
 }
 
 SolutionWidget::~SolutionWidget()
@@ -29,11 +80,16 @@ SolutionWidget::~SolutionWidget()
     delete ui;
 }
 
-void SolutionWidget::setPlanets(const QList<Planet>& newPlanets) {
+void SolutionWidget::setPlanets(const SolarSystem& newPlanets) {
     // Forward signal
     emit planetsChanged(newPlanets);
 }
 
+void SolutionWidget::updatePlanets(const SolarSystem& newPlanets, const PlanetChangeSet& changes) {
+    // Forward signal
+    emit planetsUpdated(newPlanets, changes);
+}
+
 void SolutionWidget::setRocket(const Rocket* newRocket) {
     // Forward signal
     emit rocketChanged(newRocket);
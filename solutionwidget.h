@@ -1,7 +1,7 @@
 #ifndef SOLUTIONWIDGET_H
 #define SOLUTIONWIDGET_H
 
-#include "planet.h"
+#include "solarsystem.h"
 #include "rocket.h"
 
 #include <QWidget>
@@ -19,11 +19,13 @@ public:
     ~SolutionWidget();
 
 signals:
-    void planetsChanged(const QList<Planet>& newPlanets);
+    void planetsChanged(const SolarSystem& newPlanets);
+    void planetsUpdated(const SolarSystem& newPlanets, const PlanetChangeSet& changes);
     void rocketChanged(const Rocket* newRocket);
 
 public slots:
-    void setPlanets(const QList<Planet>& newPlanets);
+    void setPlanets(const SolarSystem& newPlanets);
+    void updatePlanets(const SolarSystem& newPlanets, const PlanetChangeSet& changes);
     void setRocket(const Rocket* newRocket);
 
 private:
@@ -0,0 +1,111 @@
+#include "transfermatrixmodel.h"
+
+#include "dialogutils.h"
+#include "measurementunits.h"
+
+#include <cmath>
+
+TransferMatrixModel::TransferMatrixModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+void TransferMatrixModel::setMatrix(const QStringList& planetNames, OrbitalMath::TransferMatrix newMatrix) {
+    beginResetModel();
+
+    names = planetNames;
+    matrix = std::move(newMatrix);
+
+    // List the pairs that have a transfer (NaN on the diagonal and without orbital data)
+    cells.clear();
+    for (qsizetype cell = 0; cell < qsizetype(matrix.totalTravelTimes.size()); ++cell) {
+        if (!std::isnan(matrix.totalTravelTimes[cell])) cells.push_back(cell);
+    }
+
+    endResetModel();
+}
+
+void TransferMatrixModel::clear() {
+    beginResetModel();
+    names.clear();
+    matrix = OrbitalMath::TransferMatrix();
+    cells.clear();
+    endResetModel();
+}
+
+int TransferMatrixModel::rowCount(const QModelIndex& parent) const {
+    // Flat table: only the root has rows
+    return parent.isValid() ? 0 : int(cells.size());
+}
+
+int TransferMatrixModel::columnCount(const QModelIndex& parent) const {
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant TransferMatrixModel::data(const QModelIndex& index, int role) const {
+    if (!index.isValid() || (Qt::DisplayRole != role && SORT_ROLE != role)) return QVariant();
+
+    const qsizetype cell = cells[index.row()];
+    const qsizetype from = cell / matrix.planetCount;
+    const qsizetype to = cell % matrix.planetCount;
+
+    // Raw value of the column (in the units of the matrix)
+    double value = 0;
+    switch (index.column()) {
+    case FROM:
+        return names[from];
+    case TO:
+        return names[to];
+    case DISTANCE:
+        value = matrix.distances[cell];
+        break;
+    case CRUISING_VELOCITY:
+        value = matrix.cruisingVelocities[cell];
+        break;
+    case ACCELERATION_TIME:
+        value = matrix.accelerationTimes[cell];
+        break;
+    case CRUISING_TIME:
+        value = matrix.cruisingTimes[cell];
+        break;
+    case DECELERATION_TIME:
+        value = matrix.decelerationTimes[cell];
+        break;
+    case TOTAL_TRAVEL_TIME:
+        value = matrix.totalTravelTimes[cell];
+        break;
+    default:
+        return QVariant();
+    }
+
+    if (SORT_ROLE == role) return value;
+
+    switch (index.column()) {
+    case DISTANCE:
+        return QString("%1 km").arg(DistanceUnit::convert(value, DistanceUnit::METRES, DistanceUnit::KILOMETRES));
+    case CRUISING_VELOCITY:
+        return QString("%1 km/s").arg(SpeedUnit::convert(value, SpeedUnit::METRES_PER_SECOND, SpeedUnit::KILOMETRES_PER_SECOND));
+    case ACCELERATION_TIME:
+    case DECELERATION_TIME:
+        return QString("%1 s").arg(value);
+    default:
+        return DialogUtils::formatTime(value);
+    }
+}
+
+QVariant TransferMatrixModel::headerData(int section, Qt::Orientation orientation, int role) const {
+    if (Qt::DisplayRole != role) return QVariant();
+    if (Qt::Vertical == orientation) return section + 1;
+
+    switch (section) {
+    case FROM: return "From";
+    case TO: return "To";
+    case DISTANCE: return "Distance";
+    case CRUISING_VELOCITY: return "Cruising velocity";
+    case ACCELERATION_TIME: return "Acceleration time";
+    case CRUISING_TIME: return "Cruising time";
+    case DECELERATION_TIME: return "Deceleration time";
+    case TOTAL_TRAVEL_TIME: return "Total travel time";
+    default: return QVariant();
+    }
+}
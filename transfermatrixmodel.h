@@ -0,0 +1,60 @@
+#ifndef TRANSFERMATRIXMODEL_H
+#define TRANSFERMATRIXMODEL_H
+
+#include <QAbstractTableModel>
+#include <QStringList>
+
+#include "orbitalmath.h"
+
+#include <vector>
+
+/**
+ * Table model listing the transfers of a `OrbitalMath::TransferMatrix`,
+ * one row per (start planet, destination planet) pair that has one.
+ *
+ * Cells are formatted for display on the fly, straight from the matrix,
+ * so that even large matrices don't need a table of strings. Raw values
+ * (names for the planet columns) are available under `SORT_ROLE`, so
+ * that a `QSortFilterProxyModel` can sort by any column without going
+ * back to the matrix maths.
+ */
+class TransferMatrixModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        FROM = 0,
+        TO,
+        DISTANCE,
+        CRUISING_VELOCITY,
+        ACCELERATION_TIME,
+        CRUISING_TIME,
+        DECELERATION_TIME,
+        TOTAL_TRAVEL_TIME,
+        COLUMN_COUNT
+    };
+
+    static constexpr int SORT_ROLE = Qt::UserRole;
+
+    explicit TransferMatrixModel(QObject *parent = nullptr);
+
+    /**
+     * Replaces the displayed transfers. `planetNames` must list the names
+     * of the planets the matrix was computed for, in the same order.
+     */
+    void setMatrix(const QStringList& planetNames, OrbitalMath::TransferMatrix newMatrix);
+    void clear();
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+private:
+    QStringList names;
+    OrbitalMath::TransferMatrix matrix;
+    std::vector<qsizetype> cells; // Matrix cell of each row
+};
+
+#endif // TRANSFERMATRIXMODEL_H
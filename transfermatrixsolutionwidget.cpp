@@ -0,0 +1,112 @@
+#include "transfermatrixsolutionwidget.h"
+#include "ui_transfermatrixsolutionwidget.h"
+
+#include "orbitalmath.h"
+
+#include <QElapsedTimer>
+
+TransferMatrixSolutionWidget::TransferMatrixSolutionWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::TransferMatrixSolutionWidget)
+{
+    ui->setupUi(this);
+    captionTemplate = ui->transferMatrixCaptionLabel->text(); // Store template so we can put it back if needed
+
+    // Set up table model in preparation for data, sorted by a proxy
+    transferMatrixModel = new TransferMatrixModel(this);
+    sortedTransferMatrixModel = new QSortFilterProxyModel(this);
+    sortedTransferMatrixModel->setSourceModel(transferMatrixModel);
+    sortedTransferMatrixModel->setSortRole(TransferMatrixModel::SORT_ROLE);
+    ui->transferMatrixTable->setModel(sortedTransferMatrixModel);
+    ui->transferMatrixTable->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    ui->transferMatrixTable->sortByColumn(TransferMatrixModel::TOTAL_TRAVEL_TIME, Qt::AscendingOrder);
+}
+
+TransferMatrixSolutionWidget::~TransferMatrixSolutionWidget()
+{
+    delete sortedTransferMatrixModel;
+    delete transferMatrixModel;
+    delete ui;
+}
+
+void TransferMatrixSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
+    planets = &newPlanets;
+
+    updateDisplayedPage();
+    updateTransferMatrix();
+}
+
+void TransferMatrixSolutionWidget::setRocket(const Rocket* newRocket) {
+    rocket = newRocket;
+
+    updateDisplayedPage();
+    updateTransferMatrix();
+}
+
+namespace {
+    const auto NO_ORBITAL_DATA("Fewer than two planets have orbital data.\nPlease load orbital data from the side panel to continue.");
+    const auto NO_ROCKET_DATA("No rocket data loaded.\nPlease load rocket data from the side panel to continue.");
+    const auto TOO_MANY_PLANETS("Too many planets (%1) to list every transfer between them.\nPlease load at most %2 planets to continue.");
+
+    // Beyond that, the table (and sorting it) would take too much memory and time
+    constexpr qsizetype MAXIMUM_PLANETS = 1000;
+}
+
+void TransferMatrixSolutionWidget::updateDisplayedPage() {
+    if (nullptr != rocket && nullptr != planets && !planets->empty()) {
+        // Show main processing section
+        ui->stackedWidget->setCurrentIndex(1);
+    }
+    else ui->stackedWidget->setCurrentIndex(0);
+}
+
+void TransferMatrixSolutionWidget::updateTransferMatrix() {
+    // First, check whether we can compute at all and warn user if not.
+    ui->resultsStackedWidget->setCurrentIndex(0); // Assume error, put back once we're sure all is good
+    transferMatrixModel->clear();
+
+    if (nullptr == planets || planets->empty()) return; // "No data" page is showing
+    if (nullptr == rocket) {
+        ui->resultsIssueLabel->setText(NO_ROCKET_DATA); // Should never be visible, but just in case
+        return;
+    }
+    if (planets->size() > MAXIMUM_PLANETS) {
+        ui->resultsIssueLabel->setText(QString(TOO_MANY_PLANETS).arg(planets->size()).arg(MAXIMUM_PLANETS));
+        return;
+    }
+
+    qsizetype planetsWithOrbitalData = 0;
+    for (qsizetype i = 0; i < planets->size(); ++i) {
+        if (planets->hasOrbitalData(i)) ++planetsWithOrbitalData;
+    }
+    if (planetsWithOrbitalData < 2) {
+        ui->resultsIssueLabel->setText(NO_ORBITAL_DATA);
+        return;
+    }
+
+    // If we got here, all is well and we can display the results page
+    ui->resultsStackedWidget->setCurrentIndex(1);
+
+    const double departureDay = ui->departureDaySpinBox->value();
+
+    QElapsedTimer timer;
+    timer.start();
+    OrbitalMath::TransferMatrix matrix = OrbitalMath::transferMatrix(*planets, *rocket, Days(departureDay));
+    const qint64 computationTime = timer.nsecsElapsed();
+
+    // The proxy re-sorts by the current column as the model resets
+    transferMatrixModel->setMatrix(planets->names(), std::move(matrix));
+
+    QString newCaptionText = captionTemplate; // Make a copy
+    newCaptionText
+        .replace("{transfers}", QString::number(transferMatrixModel->rowCount()))
+        .replace("{departureDay}", QString::number(departureDay))
+        .replace("{computationTime}", QString::number(computationTime / 1e6)); // ns to ms
+    ui->transferMatrixCaptionLabel->setText(newCaptionText);
+}
+
+void TransferMatrixSolutionWidget::on_departureDaySpinBox_valueChanged(double newDepartureDay)
+{
+    // No need to do anything with the day, since updateTransferMatrix() reads it anyway
+    updateTransferMatrix();
+}
@@ -0,0 +1,43 @@
+#ifndef TRANSFERMATRIXSOLUTIONWIDGET_H
+#define TRANSFERMATRIXSOLUTIONWIDGET_H
+
+#include <QSortFilterProxyModel>
+#include <QWidget>
+
+#include "solarsystem.h"
+#include "rocket.h"
+#include "transfermatrixmodel.h"
+
+namespace Ui {
+class TransferMatrixSolutionWidget;
+}
+
+class TransferMatrixSolutionWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TransferMatrixSolutionWidget(QWidget *parent = nullptr);
+    ~TransferMatrixSolutionWidget();
+
+public slots:
+    void setPlanets(const SolarSystem& newPlanets);
+    void setRocket(const Rocket* newRocket);
+
+private slots:
+    void on_departureDaySpinBox_valueChanged(double newDepartureDay);
+
+private:
+    Ui::TransferMatrixSolutionWidget *ui;
+    const SolarSystem* planets = nullptr;
+    const Rocket* rocket = nullptr;
+    QString captionTemplate;
+
+    TransferMatrixModel* transferMatrixModel;
+    QSortFilterProxyModel* sortedTransferMatrixModel; // Sorts in the view, without recomputing the matrix
+
+    void updateDisplayedPage();
+    void updateTransferMatrix();
+};
+
+#endif // TRANSFERMATRIXSOLUTIONWIDGET_H
@@ -0,0 +1,185 @@
+#include "transferplanningsolutionwidget.h"
+#include "ui_transferplanningsolutionwidget.h"
+
+#include "dialogutils.h"
+#include "orbitalmath.h"
+
+TransferPlanningSolutionWidget::TransferPlanningSolutionWidget(QWidget *parent)
+    : QWidget(parent)
+    , ui(new Ui::TransferPlanningSolutionWidget)
+{
+    ui->setupUi(this);
+    textDisplayTemplate = ui->resultsDisplayLabel->text(); // Store template so we can put it back if needed
+}
+
+TransferPlanningSolutionWidget::~TransferPlanningSolutionWidget()
+{
+    delete ui;
+}
+
+namespace {
+    const auto STATIC_SYSTEM_HEADER("Stage Five - Launch windows");
+    const auto MOVING_SYSTEM_HEADER("Stage Six - Launch windows in a moving system");
+
+    const auto NO_PLANETS_SELECTED("No origin/destination planets selected.\nPlease select target planets to continue.");
+    const auto NO_ORBITAL_DATA("No orbital data loaded for %1.\nPlease load orbital data from the side panel to continue.");
+    const auto NO_ROCKET_DATA("No rocket data loaded.\nPlease load rocket data from the side panel to continue.");
+    const auto SAME_PLANET("Same planet selected as both origin and destination.\nPlease select two different planets to continue.");
+    const auto INVALID_PLANET("Invalid planet selected: %1.\nPlease select a valid planet from the options list to continue.");
+    const auto INVALID_TIMEFRAME("Timeframe ends before it starts.\nPlease select a valid timeframe to continue.");
+}
+
+void TransferPlanningSolutionWidget::setSystemStatic(bool newSystemStatic) {
+    systemStatic = newSystemStatic;
+    ui->transferPlanningHeader->setText(systemStatic ? STATIC_SYSTEM_HEADER : MOVING_SYSTEM_HEADER);
+
+    updateResultsDisplay();
+}
+
+void TransferPlanningSolutionWidget::setPlanets(const SolarSystem& newPlanets) {
+    planets = &newPlanets;
+
+    updateDisplayedPage();
+    updatePlanetSelectOptions();
+    updateResultsDisplay();
+}
+
+void TransferPlanningSolutionWidget::setRocket(const Rocket* newRocket) {
+    rocket = newRocket;
+
+    updateDisplayedPage();
+    updateResultsDisplay();
+}
+
+void TransferPlanningSolutionWidget::updateDisplayedPage() {
+    if (nullptr != rocket && nullptr != planets && !planets->empty()) {
+        // Show main processing section
+        ui->stackedWidget->setCurrentIndex(1);
+    }
+    else ui->stackedWidget->setCurrentIndex(0);
+}
+
+void TransferPlanningSolutionWidget::updatePlanetSelectOptions() {
+    // Try to keep current options if possible
+    const QString oldFromPlanet = ui->fromPlanetSelect->currentText();
+    const QString oldToPlanet = ui->toPlanetSelect->currentText();
+
+    // Clear options and load with new planets
+    ui->fromPlanetSelect->clear();
+    ui->toPlanetSelect->clear();
+    ui->fromPlanetSelect->addItems(planets->names());
+    ui->toPlanetSelect->addItems(planets->names());
+
+    // Try to reinstate old options
+    // If not found, Qt will just ignore us since the QComboBox is not editable
+    ui->fromPlanetSelect->setCurrentText(oldFromPlanet);
+    ui->toPlanetSelect->setCurrentText(oldToPlanet);
+}
+
+void TransferPlanningSolutionWidget::updateResultsDisplay() {
+    // Get selected planet names and timeframe
+    const QString fromPlanetName = ui->fromPlanetSelect->currentText();
+    const QString toPlanetName = ui->toPlanetSelect->currentText();
+    const double timeframeStart = ui->timeframeStartSpinBox->value();
+    const double timeframeEnd = ui->timeframeEndSpinBox->value();
+
+    // First, check whether we can compute at all and warn user if not.
+    ui->resultsStackedWidget->setCurrentIndex(0); // Assume error, put back once we're sure all is good
+
+    if (nullptr == planets || fromPlanetName.isEmpty() || toPlanetName.isEmpty()) {
+        ui->resultsIssueLabel->setText(NO_PLANETS_SELECTED);
+        return;
+    }
+    if (fromPlanetName == toPlanetName) {
+        ui->resultsIssueLabel->setText(SAME_PLANET);
+        return;
+    }
+    if (nullptr == rocket) {
+        ui->resultsIssueLabel->setText(NO_ROCKET_DATA); // Should never be visible, but just in case
+        return;
+    }
+    if (timeframeEnd < timeframeStart) {
+        ui->resultsIssueLabel->setText(INVALID_TIMEFRAME);
+        return;
+    }
+
+    // Get selected planets
+    const std::optional<qsizetype> fromPlanetIndex = planets->indexOf(fromPlanetName);
+    const std::optional<qsizetype> toPlanetIndex = planets->indexOf(toPlanetName);
+
+    // Continue checks and warn user of issues
+    if (!fromPlanetIndex.has_value() || !toPlanetIndex.has_value()) {
+        // This should be impossible given how we populate the QComboBox
+        // But we'll check, just in case
+        QStringList invalidPlanets;
+        if (!fromPlanetIndex.has_value()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanetIndex.has_value()) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(INVALID_PLANET).arg(invalidPlanetNames));
+
+        return;
+    }
+    const Planet fromPlanet = planets->at(fromPlanetIndex.value());
+    const Planet toPlanet = planets->at(toPlanetIndex.value());
+    if (!fromPlanet.hasOrbitalData() || !toPlanet.hasOrbitalData()) {
+        QStringList invalidPlanets;
+        if (!fromPlanet.hasOrbitalData()) invalidPlanets.append(fromPlanetName);
+        if (!toPlanet.hasOrbitalData()) invalidPlanets.append(toPlanetName);
+
+        QString invalidPlanetNames = invalidPlanets.join(", ");
+        ui->resultsIssueLabel->setText(QString(NO_ORBITAL_DATA).arg(invalidPlanetNames));
+
+        return;
+    }
+
+    // If we got here, all is well and we can display the results page
+    ui->resultsStackedWidget->setCurrentIndex(1);
+
+    const OrbitalMath::TransferPlanning planning = OrbitalMath::planTransfer(
+        fromPlanet, toPlanet, *rocket, *planets, Years(timeframeStart), Years(timeframeEnd), systemStatic
+        );
+    // In a moving system, the rocket heads for where the destination will be on arrival
+    const Days practicalBestDay = planning.practicalBestStartTime;
+    const OrbitalMath::TransferResults practicalTransfer = systemStatic
+        ? OrbitalMath::computeSimpleTransfer(fromPlanet, toPlanet, *rocket, NAN, NAN, practicalBestDay)
+        : OrbitalMath::solveIntercept(fromPlanet, toPlanet, *rocket, practicalBestDay).transfer;
+
+    // Then insert into UI
+    QString newResultsText = textDisplayTemplate; // Make a copy
+    newResultsText
+        .replace("{fromPlanet}", fromPlanetName)
+        .replace("{toPlanet}", toPlanetName)
+        .replace("{timeframeStart}", QString::number(timeframeStart))
+        .replace("{timeframeEnd}", QString::number(timeframeEnd))
+        .replace("{theoreticalBest}", QString::number(planning.theoreticalBestStartTime.value()))
+        .replace("{theoreticalBestStatus}", planning.isTheoreticalBestValid ? "valid" : planning.reasonTheoreticalBestInvalid)
+        .replace("{practicalBest}", QString::number(planning.practicalBestStartTime.value()))
+        .replace("{practicalBestStatus}", planning.isPracticalBestCollisionFree
+                                              ? "no collisions"
+                                              : "no collision-free launch window in the timeframe")
+        .replace("{practicalTravelTime}", QString::number(practicalTransfer.totalTravelTime.value()))
+        .replace("{practicalTravelTimeFormatted}", DialogUtils::formatTime(practicalTransfer.totalTravelTime.value()));
+    ui->resultsDisplayLabel->setText(newResultsText);
+}
+
+void TransferPlanningSolutionWidget::on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName)
+{
+    // No need to do anything with the name, since updateResultsDisplay() reads it anyway
+    updateResultsDisplay();
+}
+
+void TransferPlanningSolutionWidget::on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName)
+{
+    updateResultsDisplay();
+}
+
+void TransferPlanningSolutionWidget::on_timeframeStartSpinBox_valueChanged(double newTimeframeStart)
+{
+    updateResultsDisplay();
+}
+
+void TransferPlanningSolutionWidget::on_timeframeEndSpinBox_valueChanged(double newTimeframeEnd)
+{
+    updateResultsDisplay();
+}
@@ -0,0 +1,49 @@
+#ifndef TRANSFERPLANNINGSOLUTIONWIDGET_H
+#define TRANSFERPLANNINGSOLUTIONWIDGET_H
+
+#include <QWidget>
+
+#include "solarsystem.h"
+#include "rocket.h"
+
+namespace Ui {
+class TransferPlanningSolutionWidget;
+}
+
+class TransferPlanningSolutionWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit TransferPlanningSolutionWidget(QWidget *parent = nullptr);
+    ~TransferPlanningSolutionWidget();
+
+    /**
+     * Chooses whether planets are considered static during the
+     * rocket's travel (see `OrbitalMath::planTransfer`).
+     */
+    void setSystemStatic(bool newSystemStatic);
+
+public slots:
+    void setPlanets(const SolarSystem& newPlanets);
+    void setRocket(const Rocket* newRocket);
+
+private slots:
+    void on_fromPlanetSelect_currentTextChanged(const QString& newFromPlanetName);
+    void on_toPlanetSelect_currentTextChanged(const QString& newToPlanetName);
+    void on_timeframeStartSpinBox_valueChanged(double newTimeframeStart);
+    void on_timeframeEndSpinBox_valueChanged(double newTimeframeEnd);
+
+private:
+    Ui::TransferPlanningSolutionWidget *ui;
+    const SolarSystem* planets = nullptr;
+    const Rocket* rocket = nullptr;
+    bool systemStatic = true;
+    QString textDisplayTemplate;
+
+    void updateDisplayedPage();
+    void updatePlanetSelectOptions();
+    void updateResultsDisplay();
+};
+
+#endif // TRANSFERPLANNINGSOLUTIONWIDGET_H